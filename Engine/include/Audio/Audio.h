@@ -26,6 +26,10 @@ public:
     bool Create(std::filesystem::path fileName);
     bool Create(uint8_t *buffer, size_t size);
 
+    /* Streaming loaders for the sample cache, failures are logged instead of shown so the caller can fall back */
+    bool CreateFromFile(std::filesystem::path fileName);
+    bool CreateFromMemory(uint8_t *buffer, size_t size);
+
     bool Play(uint32_t dwStartPosition = 0, bool bLoop = false);
     bool Pause();
     bool Resume();
@@ -45,19 +49,23 @@ public:
 
     int GetDuration() const;
 
+    bool   SetPosition(double ms);
+    double GetPosition() const;
+
     std::string GetName() const;
 
     bool Release();
 
 protected:
-    bool CreateStream();
+    bool CreateStream(bool interactive = true);
     void FadeStream(int volume, bool state);
 
     AudioType   m_type;
     std::string m_id;
 
-    std::vector<uint8_t> m_vBuffer;
-    size_t               m_dwSize;
+    std::vector<uint8_t>  m_vBuffer;
+    size_t                m_dwSize;
+    std::filesystem::path m_path;
 
     int   volume = 0;
     int   pan = 0;
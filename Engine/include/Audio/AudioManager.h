@@ -18,6 +18,8 @@ public:
 
     bool Create(std::string id, uint8_t *, size_t size, Audio **out);
     bool Create(std::string id, std::filesystem::path path, Audio **out);
+    bool CreateStream(std::string id, uint8_t *buffer, size_t size, Audio **out);
+    bool CreateStream(std::string id, std::filesystem::path path, Audio **out);
     bool CreateSample(std::string id, uint8_t *, size_t size, AudioSample **out);
     bool CreateSample(std::string id, std::filesystem::path path, AudioSample **out);
     bool CreateSampleFromData(std::string id, int sampleFlags, int sampleRate, int sampleChannels, int sampleLength, void *sampleData, AudioSample **out);
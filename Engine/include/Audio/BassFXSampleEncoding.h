@@ -17,4 +17,7 @@ namespace BASS_FX_SampleEncoding {
     // sampleFalgs, sampleRate, sampleChannels, sampleLength, void*
     FXEncoding Encode(void *audioData, size_t size, float rate);
     FXEncoding Encode(std::string filePath, float rate);
+
+    // Decode the audio data to plain 16-bit PCM without any tempo processing
+    FXEncoding Decode(void *audioData, size_t size);
 } // namespace BASS_FX_SampleEncoding
\ No newline at end of file
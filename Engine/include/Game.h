@@ -1,5 +1,6 @@
 #pragma once
 #include "Inputs/InputManager.h"
+#include "Misc/FramePacer.h"
 #include "Overlay.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/Threading/GameThread.h"
@@ -35,10 +36,16 @@ public:
     void SetFrameLimitMode(FrameLimitMode mode);
     void SetFramelimit(double frameRate);
 
+    /* Steps every frame by exactly delta seconds instead of the measured time, 0 turns it off */
+    void SetFixedDelta(double delta);
+
     void SetBufferSize(int width, int height);
     void SetWindowSize(int width, int height);
     void SetFullscreen(bool fullscreen);
 
+    /* Linux: read keyboards through evdev instead of SDL when the devices are readable, SDL otherwise */
+    void SetRawInput(bool rawInput);
+
     GameThread *GetRenderThread();
     GameThread *GetMainThread();
 
@@ -74,8 +81,10 @@ private:
     bool m_notify;
     bool m_minimized;
     bool m_fullscreen;
+    bool m_rawInput;
 
     double m_frameLimit;
+    double m_fixedDelta;
 
     int m_bufferWidth, m_bufferHeight;
     int m_windowWidth, m_windowHeight;
@@ -87,4 +96,8 @@ private:
     GameThread mRenderThread;
     GameThread mAudioThread;
     GameThread mLocalThread;
+
+    FramePacer m_renderPacer;
+    FramePacer m_audioPacer;
+    FramePacer m_localPacer;
 };
\ No newline at end of file
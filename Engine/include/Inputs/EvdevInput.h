@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Keys.h"
+
+/* Key, pressed and CLOCK_MONOTONIC nanoseconds of the kernel event */
+typedef std::function<void(Keys, bool, uint64_t)> raw_key_callback;
+
+/*
+ * Reads keyboards straight from /dev/input/event* on a dedicated thread,
+ * skipping the SDL event queue and its frame-rate polling. Events carry the
+ * kernel timestamp taken on CLOCK_MONOTONIC, the same clock steady_clock
+ * uses on Linux. Needs read access to the devices (usually the "input"
+ * group); Start returns false when no keyboard can be opened, and on other
+ * platforms it always does.
+ */
+class EvdevInput
+{
+public:
+    EvdevInput();
+    ~EvdevInput();
+
+    bool Start(raw_key_callback callback);
+    void Stop();
+
+    bool IsRunning() const;
+
+private:
+    struct Device
+    {
+        int         Fd;
+        std::string Name;
+        uint64_t    Down[4]; // Key codes below 256 seen pressed, for resyncing after SYN_DROPPED
+        bool        Dropped;
+    };
+
+    void Run();
+    void ReadDevice(Device &device);
+    void Resync(Device &device);
+    void Emit(Device &device, int code, bool isDown, uint64_t time);
+
+    std::vector<Device> m_devices;
+    raw_key_callback    m_callback;
+    std::thread         m_thread;
+    std::atomic<bool>   m_running;
+    int                 m_wakeFd;
+};
@@ -1,10 +1,13 @@
 #pragma once
 #include <SDL2/SDL.h>
+#include <atomic>
 #include <functional>
-#include <unordered_map>
+#include <memory>
+#include <stdint.h>
 #include <vector>
 
 #include "../Rendering/WindowsTypes.h"
+#include "EvdevInput.h"
 #include "InputEvent.h"
 #include "Keys.h"
 
@@ -16,8 +19,29 @@ class InputManager
 public:
     void Update(SDL_Event &event);
 
-    bool IsKeyDown(Keys key);
-    bool IsMouseButton(MouseButton button);
+    /* Lock-free, safe to poll from any thread */
+    bool IsKeyDown(Keys key) const;
+    bool IsMouseButton(MouseButton button) const;
+
+    /*
+     * Every key transition is also pushed to a fixed ring, so a thread other
+     * than the window thread can consume them in order without going through
+     * the callbacks. Single consumer only; when nobody drains it new events
+     * are dropped once it is full, so call FlushKeyEvents before starting.
+     */
+    bool PollKeyEvent(KeyState &state);
+    void FlushKeyEvents();
+
+    /* Whether events were dropped since the last call (or flush), the consumer should resync from IsKeyDown */
+    bool TakeKeyEventOverflow();
+
+    /*
+     * Takes key state and the event ring from EvdevInput instead of SDL, the
+     * SDL events still drive the key callbacks. Returns false and keeps SDL
+     * when no keyboard device can be read.
+     */
+    bool EnableRawKeyboard();
+    bool IsRawKeyboard() const;
 
     void ListenKeyEvent(key_event_callback callback);
     void ListenMouseEvent(mouse_event_callback callback);
@@ -37,10 +61,24 @@ private:
     void OnMouseEvent(SDL_MouseButtonEvent &event, bool isDown);
     void OnMousePositionEvent(SDL_MouseMotionEvent &event);
 
-    Rect                                  m_mousePosition;
-    std::unordered_map<Keys, bool>        m_keyStates;
-    std::unordered_map<MouseButton, bool> m_mouseButton;
+    void PushKeyEvent(const KeyState &state);
+    bool SetKeyState(Keys key, bool isDown);
+    void OnRawKeyEvent(Keys key, bool isDown, uint64_t time);
+
+    static constexpr uint32_t kKeyEventCapacity = 256;
+
+    Rect                  m_mousePosition;
+    std::atomic<uint64_t> m_keyStates[4]; // One bit per Keys value
+    std::atomic<uint8_t>  m_mouseButtons; // One bit per MouseButton value
+
+    KeyState              m_keyEvents[kKeyEventCapacity];
+    std::atomic<uint32_t> m_keyEventWrite;
+    std::atomic<uint32_t> m_keyEventRead;
+    std::atomic<bool>     m_keyEventOverflow;
 
     std::vector<key_event_callback>   m_keyEventCallbacks;
     std::vector<mouse_event_callback> m_mouseEventCallbacks;
+
+    std::atomic<bool>           m_focused;
+    std::unique_ptr<EvdevInput> m_rawKeyboard; // Declared last, its thread stops before the ring goes away
 };
\ No newline at end of file
@@ -116,6 +116,7 @@ enum class MouseButton { LEFT, RIGHT, MIDDLE, INVALID_BUTTON };
 struct KeyState {
 	Keys key;
 	KeyEventType type;
+	uint64_t time = 0; // steady_clock nanoseconds when the key changed, taken from the kernel event with raw input
 };
 
 struct MouseState {
@@ -1,5 +1,44 @@
 #pragma once
+#include <filesystem>
+#include <stddef.h>
 
+enum class LogLevel {
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+/*
+ * Producers format into a lock-free ring and return, a background thread
+ * writes the ring to stdout, the console window and the optional file
+ * sink. When the ring is full the message is dropped and counted instead
+ * of blocking the caller.
+ */
 namespace Logs {
-    void Puts(const char* fmt, ...);
-}
\ No newline at end of file
+    /* Info level, the category is taken from a leading "[Name]" tag */
+    void Puts(const char *fmt, ...);
+
+    void Write(LogLevel level, const char *category, const char *fmt, ...);
+
+    /* Messages below the level are discarded before formatting */
+    void     SetLevel(LogLevel level);
+    LogLevel GetLevel();
+
+    /* Raises the level for one category on top of SetLevel, e.g. ("Audio", LogLevel::Warning); Puts matches its "[Name]" tag */
+    void SetCategoryLevel(const char *category, LogLevel level);
+
+    /* Also writes the log to path, rotated to path.1 ... path.maxFiles past maxBytes; an empty path closes it */
+    bool SetFileSink(const std::filesystem::path &path, size_t maxBytes = 4 * 1024 * 1024, int maxFiles = 3);
+
+    /* Blocks until everything logged before the call has been written */
+    void Flush();
+
+    /* Drains the ring and stops the writer, later messages are written synchronously */
+    void Shutdown();
+
+    /* For crash handlers: writes to stdout and the file sink on the calling thread without waiting on the writer, queued messages may be lost */
+    void WriteFatal(const char *message);
+
+    const char *LevelName(LogLevel level);
+} // namespace Logs
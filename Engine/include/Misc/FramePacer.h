@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+
+/*
+ * Paces a loop to a target rate against absolute deadlines taken from
+ * SDL_GetPerformanceCounter, so rounding in one frame is not carried
+ * into the next. The wait sleeps until shortly before the deadline and
+ * spins the rest, OS sleeps overshoot by up to a scheduler tick.
+ *
+ * Every measured frame time also goes into a histogram the console
+ * overlay can draw. A pacer belongs to one thread, reading the
+ * histogram from another thread is only safe for display purposes.
+ */
+class FramePacer
+{
+public:
+    static constexpr int   kBucketCount = 80;
+    static constexpr float kBucketWidth = 0.5f; // In milliseconds, last bucket collects everything above
+
+    FramePacer();
+
+    /* Blocks until the next frame deadline for rate frames per second, returns seconds since the last call */
+    double Wait(double rate);
+
+    /* How long before the deadline the wait stops sleeping and spins, 0 sleeps the whole way */
+    void SetSpinThreshold(double milliseconds);
+
+    void ResetStats();
+
+    const float *GetHistogram() const;
+    uint64_t     GetFrameCount() const;
+    double       GetAverage() const; // In milliseconds
+    double       GetMinimum() const;
+    double       GetMaximum() const;
+    double       GetPercentile(double percent) const;
+
+private:
+    void SleepUntil(uint64_t deadline);
+    void Record(double milliseconds);
+
+    uint64_t m_frequency;
+    uint64_t m_deadline;
+    uint64_t m_lastFrame;
+    uint64_t m_spinTicks;
+    double   m_rate;
+
+    float    m_histogram[kBucketCount];
+    uint64_t m_frames;
+    double   m_total;
+    double   m_minimum;
+    double   m_maximum;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <filesystem>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Read-only memory mapping of a whole file, used for on-disk caches that
+ * are consumed in place (no read into an intermediate buffer).
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool Open(std::filesystem::path path);
+    void Close();
+
+    bool IsOpen() const;
+
+    const uint8_t *Data() const;
+    size_t         Size() const;
+
+private:
+    const uint8_t *m_data;
+    size_t         m_size;
+
+#if _WIN32
+    void *m_file;
+    void *m_mapping;
+#else
+    int m_fd;
+#endif
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+/*
+ * Scoped CPU timing markers with an ImGui overlay (F9) and Chrome trace
+ * export (chrome://tracing, Perfetto). Markers only exist when
+ * O2GAME_PROFILER is defined, which Debug builds and the O2GAME_PROFILER
+ * CMake option do; otherwise PROFILE_SCOPE and friends expand to nothing.
+ *
+ * Builds that also define TRACY_ENABLE and provide tracy/Tracy.hpp get
+ * every marker forwarded to Tracy as a zone.
+ */
+#if O2GAME_PROFILER
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#if TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+class Profiler
+{
+public:
+    static constexpr int    kHistoryLength = 240;
+    static constexpr size_t kEventCapacity = 1 << 16;
+
+    struct Event
+    {
+        const char *Name;
+        uint64_t    Start;
+        uint64_t    End;
+    };
+
+    /* Rolling duration history of one marker name on one thread */
+    struct Track
+    {
+        const char *Name;
+        float       History[kHistoryLength];
+        int         Head;
+        int         Count;
+    };
+
+    struct ThreadData
+    {
+        std::string Name;
+        uint32_t    Id;
+
+        std::mutex         Mutex;
+        std::vector<Event> Events; // Ring buffer, oldest entry at EventHead once full
+        size_t             EventHead;
+        std::vector<Track> Tracks;
+    };
+
+    class Scope
+    {
+    public:
+        Scope(const char *name);
+        ~Scope();
+
+    private:
+        const char *m_name;
+        uint64_t    m_start;
+    };
+
+    static Profiler *GetInstance();
+    static void      Release();
+
+    /* Names the calling thread in the overlay and the trace */
+    void SetThreadName(const char *name);
+
+    void Submit(const char *name, uint64_t start, uint64_t end);
+    void SubmitGpuTime(double milliseconds);
+
+    void DrawOverlay();
+    bool ExportChromeTrace(std::filesystem::path path);
+
+private:
+    Profiler();
+    ~Profiler();
+
+    ThreadData *GetThreadData();
+
+    static void Push(Track &track, float value);
+
+    static Profiler *m_instance;
+
+    uint64_t m_origin;
+    uint64_t m_frequency;
+    bool     m_visible;
+
+    std::mutex                               m_mutex;
+    std::vector<std::unique_ptr<ThreadData>> m_threads;
+    Track                                    m_gpu;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if TRACY_ENABLE
+#define PROFILE_SCOPE(name)                                                    \
+    ZoneScopedN(name);                                                         \
+    Profiler::Scope PROFILE_CONCAT(__profileScope, __LINE__)(name)
+#define PROFILE_SET_THREAD_NAME(name)                                          \
+    tracy::SetThreadName(name);                                                \
+    Profiler::GetInstance()->SetThreadName(name)
+#else
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(__profileScope, __LINE__)(name)
+#define PROFILE_SET_THREAD_NAME(name) Profiler::GetInstance()->SetThreadName(name)
+#endif
+
+// Safe to place inside a loop body, the name is only registered on the first pass per thread
+#define PROFILE_THREAD(name)                                                   \
+    do {                                                                       \
+        static thread_local bool __profileNamed = false;                       \
+        if (!__profileNamed) {                                                 \
+            __profileNamed = true;                                             \
+            PROFILE_SET_THREAD_NAME(name);                                     \
+        }                                                                      \
+    } while (0)
+
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD(name)
+#endif
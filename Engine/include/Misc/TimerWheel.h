@@ -0,0 +1,73 @@
+#pragma once
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+/* Identifies one scheduled callback, stays unique after the callback ran or was cancelled; 0 is never issued and bit 63 is always clear */
+using TimerHandle = uint64_t;
+
+/*
+ * Hierarchical timer wheel with 1 ms ticks on steady_clock: four levels of
+ * 64 slots cover ~4.6 hours, later deadlines wait on an overflow list.
+ * Scheduling and cancelling are O(1), advancing costs one slot per elapsed
+ * tick plus a cascade every 64^n ticks, no matter how many callbacks are
+ * pending. Any thread may schedule or cancel; callbacks run on the thread
+ * calling Advance, outside the lock, so they may schedule again.
+ */
+class TimerWheel
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+
+    TimerWheel();
+
+    TimerHandle Schedule(Clock::duration delay, std::function<void()> callback);
+
+    /* False when the callback already ran, was cancelled or the handle belongs to another wheel */
+    bool Cancel(TimerHandle handle);
+
+    /* Runs every callback whose deadline is at or before now */
+    void Advance(Clock::time_point now = Clock::now());
+
+    void   Clear();
+    size_t GetPendingCount() const;
+
+private:
+    static constexpr int32_t  kNone = -1;
+    static constexpr uint32_t kMaxGeneration = 0x7FFFFFFF;
+    static constexpr int      kOverflowSlot = kLevels * kSlots;
+
+    struct Node
+    {
+        std::function<void()> Callback;
+        uint64_t              Expiry;
+        uint32_t              Generation;
+        int32_t               Prev;
+        int32_t               Next;
+        int32_t               Slot; // kNone while free
+    };
+
+    uint64_t ToTick(Clock::time_point time, bool roundUp) const;
+
+    void Link(int32_t index);
+    void Unlink(int32_t index);
+    void Relink(int slot);
+    void Release(int32_t index);
+
+    mutable std::mutex m_lock;
+
+    Clock::time_point    m_origin;
+    uint64_t             m_currentTick;
+    std::vector<Node>    m_nodes;
+    std::vector<int32_t> m_free;
+    int32_t              m_heads[kOverflowSlot + 1];
+    size_t               m_pending;
+
+    std::vector<std::function<void()>> m_due; // Reused between Advance calls
+};
@@ -3,9 +3,14 @@
 #include <SDL2/SDL.h>
 #undef main
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <unordered_map>
+#include <vector>
 
 class VulkanEngine;
+class SDLBatch;
 
 enum class RendererMode {
     OPENGL,    // 0
@@ -14,6 +19,7 @@ enum class RendererMode {
     DIRECTX11, // 3
     DIRECTX12, // 4
     METAL,     // 5
+    HEADLESS,  // 6, SDL software renderer into an offscreen surface
 };
 
 class Renderer
@@ -34,10 +40,19 @@ public:
 
     SDL_Renderer *GetSDLRenderer();
     SDL_BlendMode GetSDLBlendMode();
+    SDLBatch     *GetSDLBatch();
 
     VulkanEngine *GetVulkanEngine();
     bool          ReInitVulkan();
     bool          IsVulkan();
+    bool          IsHeadless();
+
+    /* Headless only, appends "<frame> <hash>" for every captured frame */
+    void SetFrameDump(std::filesystem::path path);
+
+    /* Starts recording frame times (and hashes when dumping), ReportCapture prints the percentiles */
+    void BeginCapture();
+    void ReportCapture();
 
     static Renderer *GetInstance();
     static void      Release();
@@ -52,6 +67,17 @@ private:
 
     SDL_Renderer *m_renderer = nullptr; /* May be used with DirectX11, DirectX12 or OpenGL */
     SDL_BlendMode m_blendMode;
+    SDLBatch     *m_batch = nullptr;
     VulkanEngine *m_vulkan = nullptr;
     GameWindow   *m_window = nullptr;
+
+    SDL_Surface *m_headlessSurface = nullptr;
+
+    bool                                  m_capturing = false;
+    int                                   m_capturedFrames = 0;
+    std::chrono::steady_clock::time_point m_lastFrame;
+    std::vector<double>                   m_frameTimes;
+    std::ofstream                         m_frameDump;
+
+    void CaptureFrame();
 };
\ No newline at end of file
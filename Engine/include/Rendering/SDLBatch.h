@@ -0,0 +1,53 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Collects textured quads for the SDL renderer and submits every run that
+ * shares texture, blend mode and clip rect with one SDL_RenderGeometry call.
+ * Tint and transparency travel as vertex colors, so they no longer need a
+ * texture state change per sprite.
+ *
+ * Anything that draws to the SDL renderer directly has to call Flush()
+ * first and InvalidateState() after it touched the clip rect.
+ */
+class SDLBatch
+{
+public:
+    SDLBatch(SDL_Renderer *renderer);
+
+    /* Vertices are top-left, top-right, bottom-right, bottom-left, clip may be null */
+    void QueueQuad(SDL_Texture *texture, const SDL_Vertex *vertices, SDL_BlendMode blendMode, const SDL_Rect *clip);
+    void Flush();
+
+    void InvalidateState();
+
+    /* Flushes what is left and starts counting draw calls for the next frame */
+    void EndFrame();
+
+    /* Disabled batching submits every quad on its own, kept for comparing both paths */
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const;
+
+    uint32_t GetLastDrawCalls() const;
+
+private:
+    SDL_Renderer *m_renderer;
+
+    SDL_Texture  *m_texture;
+    SDL_BlendMode m_blendMode;
+    SDL_Rect      m_clip;
+    bool          m_hasClip;
+
+    SDL_Rect m_appliedClip;
+    bool     m_hasAppliedClip;
+    bool     m_clipKnown;
+
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int>        m_indices;
+
+    bool     m_enabled;
+    uint32_t m_drawCalls;
+    uint32_t m_lastDrawCalls;
+};
@@ -1,26 +1,39 @@
 #pragma once
+#include <atomic>
 #include <functional>
 #include <thread>
 #include <vector>
 
+#include "InplaceFunction.h"
+#include "MPSCQueue.h"
+
 class GameThread
 {
 public:
+    using Action = InplaceFunction<void()>;
+
     GameThread();
     ~GameThread();
 
     void Run(std::function<void()> callback, bool background);
-    void QueueAction(std::function<void()> callback);
+    void QueueAction(Action callback);
+
+    /* Max time spent on queued actions per tick, at least one action always runs */
+    void SetQueueBudget(double ms);
 
     void Update();
     void Stop();
 
 private:
-    bool m_run;
-    bool m_background;
+    void DrainQueue();
+
+    bool   m_run;
+    bool   m_background;
+    double m_queue_budget;
 
-    std::thread m_thread;
+    std::thread                  m_thread;
+    std::atomic<std::thread::id> m_thread_id;
 
-    std::function<void()>              m_main_cb;
-    std::vector<std::function<void()>> m_queue_cb;
-};
\ No newline at end of file
+    std::function<void()>   m_main_cb;
+    MPSCQueue<Action, 1024> m_queue_cb;
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, size_t Capacity = 96>
+class InplaceFunction;
+
+/*
+ * std::function replacement that stores the callable inside the object itself,
+ * callables larger than Capacity are rejected at compile time instead of
+ * being moved to the heap.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+public:
+    InplaceFunction() = default;
+
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, InplaceFunction>>>
+    InplaceFunction(F &&callable)
+    {
+        using Callable = std::decay_t<F>;
+
+        static_assert(sizeof(Callable) <= Capacity, "Callable is too large for InplaceFunction");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable is over-aligned for InplaceFunction");
+        static_assert(std::is_nothrow_move_constructible_v<Callable>, "Callable must be nothrow move constructible");
+
+        new (m_storage) Callable(std::forward<F>(callable));
+
+        m_invoke = [](void *storage, Args... args) -> R {
+            return (*static_cast<Callable *>(storage))(std::forward<Args>(args)...);
+        };
+
+        m_manage = [](void *dst, void *src) {
+            if (src) {
+                new (dst) Callable(std::move(*static_cast<Callable *>(src)));
+            }
+
+            static_cast<Callable *>(src ? src : dst)->~Callable();
+        };
+    }
+
+    InplaceFunction(InplaceFunction &&other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    InplaceFunction &operator=(InplaceFunction &&other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+
+        return *this;
+    }
+
+    InplaceFunction(const InplaceFunction &) = delete;
+    InplaceFunction &operator=(const InplaceFunction &) = delete;
+
+    ~InplaceFunction()
+    {
+        Reset();
+    }
+
+    R operator()(Args... args)
+    {
+        return m_invoke(m_storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const
+    {
+        return m_invoke != nullptr;
+    }
+
+    void Reset()
+    {
+        if (m_manage) {
+            m_manage(m_storage, nullptr);
+        }
+
+        m_invoke = nullptr;
+        m_manage = nullptr;
+    }
+
+private:
+    void MoveFrom(InplaceFunction &other)
+    {
+        if (other.m_manage) {
+            // Moves into our storage and destroys the source
+            other.m_manage(m_storage, other.m_storage);
+        }
+
+        m_invoke = other.m_invoke;
+        m_manage = other.m_manage;
+
+        other.m_invoke = nullptr;
+        other.m_manage = nullptr;
+    }
+
+    alignas(std::max_align_t) unsigned char m_storage[Capacity];
+
+    R (*m_invoke)(void *, Args...) = nullptr;
+    void (*m_manage)(void *, void *) = nullptr;
+};
@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "InplaceFunction.h"
+
+enum class JobAffinity {
+    ANY,
+    MAIN_THREAD,
+    LONG_RUNNING // Loaders that block or hold locks for a long time, run one at a time on their own thread
+};
+
+class JobSystem;
+
+/*
+ * Counts jobs that are still in flight, jobs scheduled with ScheduleAfter
+ * are held until the counter they depend on reaches zero.
+ */
+class JobCounter
+{
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    int  Get() const;
+    bool IsDone() const;
+
+private:
+    friend class JobSystem;
+
+    struct Continuation
+    {
+        InplaceFunction<void()> Fn;
+        JobCounter             *Counter;
+        JobAffinity             Affinity;
+    };
+
+    std::atomic<int>          m_value = 0;
+    std::mutex                m_lock;
+    std::condition_variable   m_done;
+    std::vector<Continuation> m_continuations;
+};
+
+/*
+ * Work-stealing job scheduler, every worker owns a deque and pops its own
+ * work LIFO while idle workers steal FIFO from the others. Jobs with
+ * MAIN_THREAD affinity are run by PumpMainThread from the update thread,
+ * LONG_RUNNING ones by a dedicated loader thread so they never end up
+ * inside a Wait on a thread that holds unrelated locks. The loader thread
+ * is started on first use, so it also works before Init.
+ */
+class JobSystem
+{
+public:
+    using Job = InplaceFunction<void()>;
+
+    void Init(int workerCount = 0);
+
+    /* Jobs still queued are run before it returns, so nothing waiting on a counter is left hanging */
+    void Shutdown();
+
+    void Schedule(Job job, JobCounter *counter = nullptr, JobAffinity affinity = JobAffinity::ANY);
+    void ScheduleAfter(JobCounter *dependency, Job job, JobCounter *counter = nullptr, JobAffinity affinity = JobAffinity::ANY);
+
+    /* Runs fn(i) for every i in [0, count) split across the workers, returns once all of them are done */
+    void ParallelFor(size_t count, std::function<void(size_t)> fn);
+
+    /* Blocks until the counter reaches zero, the calling thread meanwhile only runs jobs that belong to that counter and parks when there are none */
+    void Wait(JobCounter *counter);
+
+    /* Runs MAIN_THREAD jobs for at most budget milliseconds, the calling thread becomes the main thread */
+    void PumpMainThread(double budget);
+
+    int  GetWorkerCount() const;
+    bool IsWorkerThread() const;
+
+    static JobSystem *GetInstance();
+    static void       Release();
+
+private:
+    JobSystem() = default;
+    ~JobSystem();
+
+    struct Entry
+    {
+        Job         Fn;
+        JobCounter *Counter = nullptr;
+    };
+
+    struct Worker
+    {
+        std::mutex        Lock;
+        std::deque<Entry> Jobs;
+        std::thread       Thread;
+    };
+
+    void WorkerLoop(int index);
+    void LoaderLoop();
+    void StopLoader();
+    void Push(Entry entry, JobAffinity affinity);
+    bool TryRunOne(int index, bool mainThread, JobCounter *counter = nullptr);
+    void Execute(Entry &entry);
+    void Finish(JobCounter *counter);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<bool>                    m_running = false;
+    std::atomic<unsigned>                m_next = 0;
+    std::atomic<int>                     m_pending = 0;
+
+    std::mutex              m_sleepLock;
+    std::condition_variable m_wake;
+
+    std::mutex                   m_mainLock;
+    std::deque<Entry>            m_mainJobs;
+    std::atomic<std::thread::id> m_mainId; // Update thread, which one that is depends on the thread mode
+
+    std::mutex              m_loaderLock;
+    std::condition_variable m_loaderWake;
+    std::deque<Entry>       m_loaderJobs;
+    std::thread             m_loaderThread;
+    bool                    m_loaderStop = false;
+
+    static JobSystem *s_instance;
+};
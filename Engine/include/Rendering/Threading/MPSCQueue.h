@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/*
+ * Bounded multi-producer single-consumer queue, based on Dmitry Vyukov's
+ * bounded MPMC queue. Each cell carries a sequence number that tells
+ * producers and the consumer whether it is free or filled, so no locks are
+ * needed and items are popped in the order their slots were claimed.
+ */
+template <typename T, size_t Capacity>
+class MPSCQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    MPSCQueue()
+    {
+        m_cells = std::make_unique<Cell[]>(Capacity);
+        for (size_t i = 0; i < Capacity; i++) {
+            m_cells[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+    /* Safe to call from any thread, returns false when the queue is full */
+    bool TryPush(T &&value)
+    {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        Cell  *cell;
+
+        for (;;) {
+            cell = &m_cells[pos & (Capacity - 1)];
+
+            size_t    seq = cell->Sequence.load(std::memory_order_acquire);
+            ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)pos;
+
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->Value = std::move(value);
+        cell->Sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Consumer thread only */
+    bool TryPop(T &out)
+    {
+        Cell  *cell = &m_cells[m_tail & (Capacity - 1)];
+        size_t seq = cell->Sequence.load(std::memory_order_acquire);
+
+        if ((ptrdiff_t)seq - (ptrdiff_t)(m_tail + 1) < 0) {
+            return false;
+        }
+
+        out = std::move(cell->Value);
+        cell->Sequence.store(m_tail + Capacity, std::memory_order_release);
+        m_tail++;
+        return true;
+    }
+
+    bool Empty() const
+    {
+        const Cell *cell = &m_cells[m_tail & (Capacity - 1)];
+        return (ptrdiff_t)cell->Sequence.load(std::memory_order_acquire) - (ptrdiff_t)(m_tail + 1) < 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> Sequence;
+        T                   Value;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) size_t m_tail = 0;
+};
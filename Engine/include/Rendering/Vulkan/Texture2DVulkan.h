@@ -22,9 +22,24 @@ namespace vkTexture {
 
     Texture2D_Vulkan *TexLoadImage(std::filesystem::path imagePath);
     Texture2D_Vulkan *TexLoadImage(void *buffer, size_t size);
+    Texture2D_Vulkan *TexLoadRaw(const void *pixels, int width, int height); // RGBA8, tightly packed
     Texture2D_Vulkan *GetDummyImage();
     VkDescriptorSet   GetVkDescriptorSet(Texture2D_Vulkan *image);
 
+    /*
+     * Textures created between BeginBatch and EndBatch share one staging buffer
+     * and one command buffer, EndBatch submits without waiting on the GPU.
+     * Calls may nest, only the outermost EndBatch submits.
+     */
+    void BeginBatch();
+    void EndBatch();
+
+    struct BatchScope
+    {
+        BatchScope() { BeginBatch(); }
+        ~BatchScope() { EndBatch(); }
+    };
+
     void QueryTexture(Texture2D_Vulkan *handle, int &outWidth, int &outHeight);
     void ReleaseTexture(Texture2D_Vulkan *handle);
 
@@ -10,6 +10,7 @@
 #include <SDL2/SDL.h>
 #include <deque>
 #include <functional>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -66,8 +67,17 @@ struct FrameData
     VkCommandPool   _commandPool;
     VkCommandBuffer _mainCommandBuffer;
 
-    VkDeviceMemory _verticesBuffer;
-    VkDeviceMemory _indiciesBuffer;
+    // Sprite geometry, persistently mapped and rewritten from the start every frame
+    VkBuffer       _vertexBuffer;
+    VkBuffer       _indexBuffer;
+    VkDeviceMemory _vertexBufferMemory;
+    VkDeviceMemory _indexBufferMemory;
+    void          *_vertexMapped = nullptr;
+    void          *_indexMapped = nullptr;
+
+    // Start and end of the frame's command buffer, only created in profiler builds
+    VkQueryPool _timestampPool = VK_NULL_HANDLE;
+    bool        _timestampsWritten = false;
 
     bool IsValid;
 };
@@ -83,6 +93,14 @@ struct UploadContext
     VkCommandBuffer _commandBuffer;
 };
 
+/* Transfer submitted without waiting, retired by poll_uploads once its fence is signalled */
+struct PendingUpload
+{
+    VkCommandBuffer       cmd;
+    VkFence               fence;
+    std::function<void()> onComplete;
+};
+
 struct ImDrawVert;
 
 struct SubmitQueueInfo
@@ -99,6 +117,19 @@ struct SubmitQueueInfo
     VkDescriptorSet descriptor;
 };
 
+/* Run of geometry that shares the same pipeline, texture and scissor */
+struct SpriteBatch
+{
+    VkDescriptorSet descriptor;
+    VkRect2D        scissor;
+    bool            AlphaBlend;
+
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t  vertexOffset;
+    uint32_t vertexCount;
+};
+
 constexpr unsigned int FRAME_OVERLAP = 2;
 
 class VulkanEngine
@@ -185,17 +216,20 @@ public:
     static void          Release();
 
     void immediate_submit(std::function<void(VkCommandBuffer cmd)> &&function);
-    void queue_submit(SubmitQueueInfo info);
+    void async_submit(std::function<void(VkCommandBuffer cmd)> &&function, std::function<void()> &&onComplete);
+    void poll_uploads(bool wait);
+    void queue_submit(const SubmitQueueInfo &info);
+    void queue_quad(const ImDrawVert *vertices, VkDescriptorSet descriptor, bool alphaBlend, const VkRect2D &scissor);
     void flush_queue();
 
-    std::vector<SubmitQueueInfo> _queueInfos;
+    std::vector<SpriteBatch> _batches;
+
+    uint32_t _maxVertices = 0;
+    uint32_t _maxIndices = 0;
+    uint32_t _vertexCount = 0;
+    uint32_t _indexCount = 0;
+    uint32_t _lastDrawCalls = 0;
 
-    uint64_t               _maxVertexBufferSize = 0;
-    uint64_t               _maxIndexBufferSize = 0;
-    VkBuffer               _vertexBuffer = VK_NULL_HANDLE;
-    VkBuffer               _indexBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory         _vertexBufferMemory = VK_NULL_HANDLE;
-    VkDeviceMemory         _indexBufferMemory = VK_NULL_HANDLE;
     VkAllocationCallbacks *_allocCallback = VK_NULL_HANDLE;
 
     void re_init_swapchains(int width, int height);
@@ -209,6 +243,10 @@ private:
     bool                 m_vsync = false;
     static VulkanEngine *m_instance;
 
+    VkCommandPool              _asyncUploadPool = VK_NULL_HANDLE;
+    std::vector<PendingUpload> _pendingUploads;
+    std::mutex                 _uploadMutex;
+
     void init_vulkan();
 
     bool init_swapchain();
@@ -226,4 +264,6 @@ private:
     void init_shaders();
 
     void init_pipeline();
+
+    SpriteBatch *reserve_batch(uint32_t vertexCount, uint32_t indexCount, VkDescriptorSet descriptor, bool alphaBlend, const VkRect2D &scissor);
 };
\ No newline at end of file
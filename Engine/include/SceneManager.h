@@ -1,4 +1,5 @@
 #pragma once
+#include <Misc/TimerWheel.h>
 #include <chrono>
 #include <functional>
 #include <memory>
@@ -19,12 +20,6 @@ enum class ExecuteThread {
     UPDATE
 };
 
-struct QueueInfo
-{
-    std::function<void()>                 callback;
-    std::chrono::system_clock::time_point time;
-};
-
 class SceneManager
 {
 #if _DEBUG
@@ -53,8 +48,11 @@ public:
     int GetLastSceneIndex() const;
 
     static void DisplayFade(int transparency, std::function<void()> callback);
-    static void ExecuteAfter(int ms_time, std::function<void()> callback);
-    static void GameExecuteAfter(ExecuteThread thread, int ms_time, std::function<void()> callback);
+    static TimerHandle ExecuteAfter(int ms_time, std::function<void()> callback);
+    static TimerHandle GameExecuteAfter(ExecuteThread thread, int ms_time, std::function<void()> callback);
+
+    /* Drops a callback queued by ExecuteAfter/GameExecuteAfter that has not run yet */
+    static bool CancelExecute(TimerHandle handle);
 
     static void AddScene(int idx, Scene *scene);
     static void ChangeScene(int idx);
@@ -90,8 +88,9 @@ private:
 
     std::function<void()> m_onSceneChange;
 
-    std::vector<QueueInfo> m_queue_render;
-    std::vector<QueueInfo> m_queue_input;
+    /* Advanced from Update and Input respectively, named after the ExecuteThread they serve */
+    TimerWheel m_queue_update;
+    TimerWheel m_queue_window;
 
     Game *m_parent = nullptr;
 
@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 
+class TextureAtlas;
+
 enum class NumericPosition {
     LEFT,
     MID,
@@ -38,6 +40,9 @@ public:
     void SetValue(int value);
 
 protected:
+    void LoadAtlas(std::vector<std::filesystem::path> &paths);
+
     std::vector<Texture2D *> m_numericsTexture;
     std::map<int, Rect>      m_numbericsWidth;
+    TextureAtlas            *m_atlas = nullptr;
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <SDL2/SDL.h>
 #include <filesystem>
+#include <memory>
 #include <string>
 
 #include "../Rendering/WindowsTypes.h"
@@ -23,6 +24,7 @@ public:
     Texture2D(std::string fileName);
     Texture2D(std::filesystem::path path);
     Texture2D(uint8_t *fileData, size_t size);
+    Texture2D(const uint8_t *pixels, int width, int height); // Raw RGBA8 pixels, skips image decoding
     Texture2D(SDL_Texture *texture);
     Texture2D(Texture2D_Vulkan *texture);
     ~Texture2D();
@@ -53,6 +55,15 @@ public:
 
     static Texture2D *FromTexture2D(Texture2D *tex);
 
+    /* Shares the page's GPU texture and draws only region (x, y, width, height) of it, see TextureAtlas */
+    static Texture2D *FromRegion(Texture2D *page, Rect region);
+
+    /* Same as above, but keeps the page alive for as long as the returned texture exists, see TexturePack */
+    static Texture2D *FromRegion(std::shared_ptr<Texture2D> page, Rect region);
+
+    /* Draws the shared texture and keeps it alive for as long as the returned one exists, see TextureCache */
+    static Texture2D *FromShared(std::shared_ptr<Texture2D> tex);
+
     static Texture2D *FromBMP(uint8_t *fileData, size_t size);
     static Texture2D *FromBMP(std::string fileName);
     static Texture2D *FromJPEG(uint8_t *fileData, size_t size);
@@ -62,6 +73,7 @@ public:
 
 protected:
     void LoadImageResources(uint8_t *buffer, size_t size);
+    void LoadRawResources(const uint8_t *pixels, int width, int height);
     bool m_bDisposeTexture;
 
     Rect  m_calculatedSize;
@@ -74,4 +86,8 @@ protected:
     SDL_Surface *m_sdl_surface;
 
     Texture2D_Vulkan *m_vk_tex;
+
+    RectF m_uvRect;
+
+    std::shared_ptr<Texture2D> m_shared;
 };
\ No newline at end of file
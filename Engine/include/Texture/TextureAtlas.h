@@ -0,0 +1,61 @@
+#pragma once
+#include <filesystem>
+#include <stdint.h>
+#include <vector>
+
+#include "Rendering/WindowsTypes.h"
+
+class Texture2D;
+
+/*
+ * Packs many small images into a few large page textures at load time, so
+ * sprites drawn one after another share a descriptor and can be batched.
+ *
+ * Usage: Add() every image, Build() once, then CreateTexture() per image.
+ * Files added by path are decoded in parallel during Build().
+ */
+class TextureAtlas
+{
+public:
+    TextureAtlas(int pageSize = 2048, int padding = 1);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas &) = delete;
+    TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+    int Add(std::filesystem::path path);
+    int Add(const uint8_t *pixels, int width, int height);
+
+    void Build();
+
+    /* Returned texture is owned by the caller, the page itself stays owned by the atlas */
+    Texture2D *CreateTexture(int id) const;
+    Rect       GetRect(int id) const;
+
+    int GetPageCount() const;
+
+private:
+    void Decode();
+    void BuildPages(std::vector<int> &pending);
+
+    struct Image
+    {
+        std::filesystem::path Path;
+        std::vector<uint8_t>  Pixels;
+        int                   Width;
+        int                   Height;
+    };
+
+    struct Region
+    {
+        int  Page;
+        Rect Area;
+    };
+
+    int m_pageSize;
+    int m_padding;
+
+    std::vector<Image>       m_images;
+    std::vector<Region>      m_regions;
+    std::vector<Texture2D *> m_pages;
+};
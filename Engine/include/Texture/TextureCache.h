@@ -0,0 +1,72 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Texture2D;
+class TexturePack;
+
+/*
+ * Shares decoded and uploaded images between scenes, keyed by canonical
+ * path. An entry is reloaded when the file's modification time changes.
+ *
+ * Load() hands out a new Texture2D per call (position, size and tint stay
+ * per-instance) that keeps the shared GPU texture alive. Entries nobody
+ * holds anymore are evicted least recently used first once the cache
+ * goes over its budget.
+ *
+ * Paths found in the mounted TexturePack are served from its pre-decoded
+ * pages instead and never enter the cache.
+ */
+class TextureCache
+{
+public:
+    /* Returned texture is owned by the caller, throws like Texture2D(path) when the file is missing */
+    Texture2D *Load(std::filesystem::path path);
+
+    /* Decodes every file not cached yet on the job system and uploads them as one batch */
+    void Preload(const std::vector<std::filesystem::path> &paths);
+
+    /* Pack consulted before the file system by Load() and TextureAtlas, nullptr unmounts */
+    void                         SetPack(std::shared_ptr<TexturePack> pack);
+    std::shared_ptr<TexturePack> GetPack();
+
+    void   SetBudget(size_t bytes);
+    size_t GetUsage();
+
+    /* Evicts unused entries until the cache fits its budget */
+    void Trim();
+    void Clear();
+
+    static TextureCache *GetInstance();
+    static void          Release();
+
+private:
+    TextureCache();
+    ~TextureCache();
+
+    struct Entry
+    {
+        std::shared_ptr<Texture2D>      Texture;
+        std::filesystem::file_time_type ModifiedTime;
+        size_t                          Bytes;
+        uint64_t                        LastUse;
+    };
+
+    std::string Key(const std::filesystem::path &path);
+    void        Insert(const std::string &key, std::shared_ptr<Texture2D> texture, std::filesystem::file_time_type modifiedTime);
+    void        TrimLocked();
+
+    std::mutex                             m_lock;
+    std::unordered_map<std::string, Entry> m_entries;
+    size_t                                 m_budget;
+    size_t                                 m_usage;
+    uint64_t                               m_clock;
+    std::shared_ptr<TexturePack>           m_pack;
+
+    static TextureCache *s_instance;
+};
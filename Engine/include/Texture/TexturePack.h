@@ -0,0 +1,112 @@
+#pragma once
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Misc/MappedFile.h"
+#include "Misc/mINI.h"
+#include "Rendering/WindowsTypes.h"
+
+class Texture2D;
+
+/*
+ * Pre-baked resource pack: decoded RGBA8 images packed into atlas pages
+ * plus parsed INI files, consumed straight from a memory mapping so a
+ * skin loads without touching stb_image or the INI parser.
+ *
+ * Layout: [Header][Page * count][Image * count][Ini * count][names]
+ * [ini data][page pixels...], page pixels are aligned to 16 bytes.
+ *
+ * Entries are looked up by path relative to the root given to Open().
+ * The loose files stay the source of truth, an entry whose source file
+ * changed size or modification time since packing is ignored.
+ */
+class TexturePack
+{
+public:
+    TexturePack();
+    ~TexturePack();
+
+    TexturePack(const TexturePack &) = delete;
+    TexturePack &operator=(const TexturePack &) = delete;
+
+    bool Open(std::filesystem::path file, std::filesystem::path root);
+    void Close();
+    bool IsOpen() const;
+
+    bool Contains(const std::filesystem::path &path) const;
+
+    /* Region of the packed page, the page is uploaded on first use. Returns nullptr when the path is not packed */
+    Texture2D *CreateTexture(const std::filesystem::path &path);
+
+    /* Copies the image out of its page as tightly packed RGBA8 rows */
+    bool CopyPixels(const std::filesystem::path &path, std::vector<uint8_t> &pixels, int &width, int &height) const;
+
+    bool ReadIni(const std::filesystem::path &path, mINI::INIStructure &ini) const;
+
+    /* Decodes images on the job system and writes the pack, names are stored relative to root */
+    static bool Write(std::filesystem::path file, std::filesystem::path root, const std::vector<std::filesystem::path> &images, const std::vector<std::filesystem::path> &inis, int pageSize = 2048);
+
+#pragma pack(push, 1)
+    struct Header
+    {
+        char     Signature[4];
+        uint32_t Version;
+        uint32_t PageCount;
+        uint32_t ImageCount;
+        uint32_t IniCount;
+        uint32_t Reserved;
+    };
+
+    struct Page
+    {
+        uint32_t Width;
+        uint32_t Height;
+        uint64_t Offset;
+    };
+
+    struct Source
+    {
+        uint32_t NameOffset; // Into the names block, not null terminated
+        uint32_t NameLength;
+        int64_t  ModifiedTime;
+        uint64_t Size;
+    };
+
+    struct Image
+    {
+        Source   File;
+        uint32_t Page;
+        int32_t  X, Y, Width, Height;
+    };
+
+    struct Ini
+    {
+        Source   File;
+        uint64_t DataOffset;
+        uint64_t DataLength;
+    };
+#pragma pack(pop)
+
+private:
+    std::string Key(const std::filesystem::path &path) const;
+    bool        IsFresh(const Source &source) const;
+
+    MappedFile            m_file;
+    std::filesystem::path m_root;
+
+    const Page  *m_pages;
+    const Image *m_images;
+    const Ini   *m_inis;
+    const char  *m_names;
+
+    std::unordered_map<std::string, uint32_t> m_imageLookup;
+    std::unordered_map<std::string, uint32_t> m_iniLookup;
+
+    std::mutex                              m_uploadLock;
+    std::vector<std::shared_ptr<Texture2D>> m_uploaded;
+};
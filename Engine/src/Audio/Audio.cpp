@@ -1,5 +1,7 @@
 #include "Audio/Audio.h"
 #include "MsgBox.h"
+#include <Logs.h>
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -10,6 +12,23 @@
 #include <bass_fx.h>
 #include <string.h>
 
+namespace {
+    /* Stream loaders run on worker threads and must not block on a message box, they log and let the caller fall back */
+    bool StreamError(const std::string &id, const char *message, bool interactive)
+    {
+        int code = BASS_ErrorGetCode();
+
+        if (interactive) {
+            std::cout << "BASS_ERROR: " << code << std::endl;
+            MsgBox::ShowOut("EstEngine Error", message, MsgBoxType::OK, MsgBoxFlags::BTN_ERROR);
+        } else {
+            Logs::Write(LogLevel::Error, "Audio", "%s %s: %d", message, id.c_str(), code);
+        }
+
+        return false;
+    }
+} // namespace
+
 Audio::Audio(std::string id)
 {
     m_vBuffer = {};
@@ -69,6 +88,18 @@ bool Audio::Create(std::filesystem::path fileName)
     return CreateStream();
 }
 
+bool Audio::CreateFromFile(std::filesystem::path fileName)
+{
+    if (!std::filesystem::exists(fileName)) {
+        return false;
+    }
+
+    m_path = fileName;
+    m_dwSize = 0;
+
+    return CreateStream(false);
+}
+
 bool Audio::Create(uint8_t *buffer, size_t size)
 {
     m_vBuffer.resize(size);
@@ -78,6 +109,15 @@ bool Audio::Create(uint8_t *buffer, size_t size)
     return CreateStream();
 }
 
+bool Audio::CreateFromMemory(uint8_t *buffer, size_t size)
+{
+    m_vBuffer.resize(size);
+    memcpy(m_vBuffer.data(), buffer, size);
+    m_dwSize = size;
+
+    return CreateStream(false);
+}
+
 bool Audio::Play(uint32_t dwStartPosition, bool bLoop)
 {
     if (!m_hStream) {
@@ -94,7 +134,13 @@ bool Audio::Play(uint32_t dwStartPosition, bool bLoop)
         BASS_ChannelFlags(m_hStream, 0, BASS_SAMPLE_LOOP);
     }
 
-    if (!BASS_ChannelPlay(m_hStream, TRUE)) {
+    // Start position is in milliseconds, used when a long sample is started late
+    BOOL restart = TRUE;
+    if (dwStartPosition > 0 && SetPosition(static_cast<double>(dwStartPosition))) {
+        restart = FALSE;
+    }
+
+    if (!BASS_ChannelPlay(m_hStream, restart)) {
         int lastErr = BASS_ErrorGetCode();
 
         return false;
@@ -103,32 +149,41 @@ bool Audio::Play(uint32_t dwStartPosition, bool bLoop)
     return true;
 }
 
-bool Audio::CreateStream()
+bool Audio::CreateStream(bool interactive)
 {
     if (m_hStream) {
         return false;
     }
 
-    m_hStream = BASS_StreamCreateFile(TRUE, m_vBuffer.data(), 0, m_dwSize, BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT);
+    if (m_vBuffer.empty() && !m_path.empty()) {
+        // Decode straight from disk, BASS reads ahead on its own thread
+#if _WIN32
+        m_hStream = BASS_StreamCreateFile(FALSE, m_path.wstring().c_str(), 0, 0, BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT | BASS_ASYNCFILE | BASS_UNICODE);
+#else
+        m_hStream = BASS_StreamCreateFile(FALSE, m_path.string().c_str(), 0, 0, BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT | BASS_ASYNCFILE);
+#endif
+    } else {
+        m_hStream = BASS_StreamCreateFile(TRUE, m_vBuffer.data(), 0, m_dwSize, BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT);
+    }
+
     if (!m_hStream) {
-        std::cout << "BASS_ERROR: " << BASS_ErrorGetCode() << std::endl;
-        MsgBox::ShowOut("EstEngine Error", "Failed to create Stream", MsgBoxType::OK, MsgBoxFlags::BTN_ERROR);
-        return false;
+        return StreamError(m_id, "Failed to create Stream", interactive);
     }
 
-    m_hStream = BASS_FX_TempoCreate(m_hStream, BASS_FX_FREESOURCE);
+    HSTREAM source = m_hStream;
+
+    m_hStream = BASS_FX_TempoCreate(source, BASS_FX_FREESOURCE);
     if (!m_hStream) {
-        std::cout << "BASS_ERROR: " << BASS_ErrorGetCode() << std::endl;
-        MsgBox::ShowOut("EstEngine Error", "Failed to create Tempo Stream", MsgBoxType::OK, MsgBoxFlags::BTN_ERROR);
-        return false;
+        bool result = StreamError(m_id, "Failed to create Tempo Stream", interactive);
+        BASS_StreamFree(source);
+        return result;
     }
 
     volume = 50;
     SetVolume(volume);
 
     if (!BASS_ChannelUpdate(m_hStream, 1000)) {
-        MsgBox::ShowOut("Failed to update stream", "EstEngine Error", MsgBoxType::OK, MsgBoxFlags::BTN_ERROR);
-        return false;
+        return StreamError(m_id, "Failed to update stream", interactive);
     }
 
     return true;
@@ -207,15 +262,11 @@ bool Audio::Resume()
         return false;
     }
 
-    if (BASS_ChannelPause(m_hStream) == FALSE) {
+    if (BASS_ChannelIsActive(m_hStream) != BASS_ACTIVE_PAUSED) {
         return false;
     }
 
-    if (BASS_ChannelSetPosition(m_hStream, 0, 0) == FALSE) {
-        return false;
-    }
-
-    return true;
+    return BASS_ChannelPlay(m_hStream, FALSE);
 }
 
 bool Audio::Stop()
@@ -272,6 +323,25 @@ int Audio::GetDuration() const
     return static_cast<int>(::round(length));
 }
 
+bool Audio::SetPosition(double ms)
+{
+    if (!m_hStream) {
+        return false;
+    }
+
+    QWORD position = BASS_ChannelSeconds2Bytes(m_hStream, std::max(ms, 0.0) / 1000.0);
+    return BASS_ChannelSetPosition(m_hStream, position, BASS_POS_BYTE);
+}
+
+double Audio::GetPosition() const
+{
+    if (!m_hStream) {
+        return 0;
+    }
+
+    return BASS_ChannelBytes2Seconds(m_hStream, BASS_ChannelGetPosition(m_hStream, BASS_POS_BYTE)) * 1000.0;
+}
+
 std::string Audio::GetName() const
 {
     return m_id;
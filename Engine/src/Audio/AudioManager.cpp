@@ -2,6 +2,7 @@
 #include "Audio/AudioSample.h"
 #include "Misc/bass_ogg_silent.hpp"
 #include "MsgBox.h"
+#include "Rendering/Renderer.h"
 #include "Rendering/Window.h"
 #include <bass.h>
 #include <bass_fx.h>
@@ -46,7 +47,10 @@ bool AudioManager::Init(GameWindow *window)
         return false;
     }
 
-    if (!BASS_Init(-1, DEFAULT_SAMPLE_RATE, BASS_DEVICE_STEREO, NULL, NULL)) {
+    // Headless runs use BASS's "no sound" device, CI machines usually have no output
+    int device = Renderer::GetInstance()->IsHeadless() ? 0 : -1;
+
+    if (!BASS_Init(device, DEFAULT_SAMPLE_RATE, BASS_DEVICE_STEREO, NULL, NULL)) {
         MsgBox::ShowOut("Failed to init BASS", "Incorrect BASS", MsgBoxType::OK, MsgBoxFlags::BTN_ERROR);
         return false;
     }
@@ -56,6 +60,9 @@ bool AudioManager::Init(GameWindow *window)
     BASS_SetConfig(BASS_CONFIG_DEV_NONSTOP, TRUE);
     BASS_SetConfig(BASS_CONFIG_FLOATDSP, TRUE);
 
+    // Read-ahead size for streams that decode directly from disk
+    BASS_SetConfig(BASS_CONFIG_ASYNCFILE_BUFFER, 512 * 1024);
+
     ::printf("BASS and BASS_FX initialized\n");
 
     // Prepare the BASS thread to play without delay.
@@ -116,6 +123,43 @@ bool AudioManager::Create(std::string id, std::filesystem::path path, Audio **ou
     return true;
 }
 
+bool AudioManager::CreateStream(std::string id, uint8_t *buffer, size_t size, Audio **out)
+{
+    if (size == 0)
+        return false;
+
+    if (m_audios.find(id) != m_audios.end()) {
+        return false;
+    }
+
+    std::unique_ptr<Audio> audio = std::make_unique<Audio>(id);
+    if (!audio->CreateFromMemory(buffer, size)) {
+        return false;
+    }
+
+    m_audios[id] = std::move(audio);
+    *out = m_audios[id].get();
+
+    return true;
+}
+
+bool AudioManager::CreateStream(std::string id, std::filesystem::path path, Audio **out)
+{
+    if (m_audios.find(id) != m_audios.end()) {
+        return false;
+    }
+
+    std::unique_ptr<Audio> audio = std::make_unique<Audio>(id);
+    if (!audio->CreateFromFile(path)) {
+        return false;
+    }
+
+    m_audios[id] = std::move(audio);
+    *out = m_audios[id].get();
+
+    return true;
+}
+
 bool AudioManager::CreateSample(std::string id, uint8_t *buffer, size_t size, AudioSample **out)
 {
     if (size == 0)
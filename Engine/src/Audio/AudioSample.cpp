@@ -35,7 +35,7 @@ bool AudioSample::Create(uint8_t *buffer, size_t size)
 
     m_handle = BASS_SampleLoad(TRUE, data.data(), 0, (DWORD)size, 10, BASS_SAMPLE_OVER_POS);
     if (!m_handle) {
-        Logs::Puts("[AudioSample] Failed to initialize Memory Sample: %d", BASS_ErrorGetCode());
+        Logs::Write(LogLevel::Error, "AudioSample", "Failed to initialize Memory Sample: %d", BASS_ErrorGetCode());
         return false;
     }
 
@@ -47,7 +47,7 @@ bool AudioSample::Create(std::filesystem::path path)
 {
     std::fstream fs(path, std::ios::binary | std::ios::in);
     if (!fs.is_open()) {
-        Logs::Puts("[AudioSample] Failed to open file: %s", path.string().c_str());
+        Logs::Write(LogLevel::Error, "AudioSample", "Failed to open file: %s", path.string().c_str());
         return false;
     }
 
@@ -60,7 +60,7 @@ bool AudioSample::Create(std::filesystem::path path)
 
     m_handle = BASS_SampleLoad(TRUE, buffer.data(), 0, (DWORD)size, 10, BASS_SAMPLE_OVER_POS | BASS_MUSIC_PRESCAN);
     if (!m_handle) {
-        Logs::Puts("[AudioSample] Failed to initialize FILE Sample: %d", BASS_ErrorGetCode());
+        Logs::Write(LogLevel::Error, "AudioSample", "Failed to initialize FILE Sample: %d", BASS_ErrorGetCode());
         return false;
     }
 
@@ -72,16 +72,14 @@ bool AudioSample::CreateFromData(int sampleFlags, int sampleRate, int sampleChan
 {
     m_handle = BASS_SampleCreate(sampleLength, sampleRate, sampleChannels, 10, BASS_MUSIC_PRESCAN | BASS_SAMPLE_OVER_POS | sampleFlags);
     if (!m_handle) {
-        Logs::Puts("[AudioSample] Failed to create placeholder sample");
+        Logs::Write(LogLevel::Error, "AudioSample", "Failed to create placeholder sample");
         return false;
     }
 
-    std::vector<uint8_t> data(sampleLength);
-    memcpy(data.data(), sampleData, sampleLength);
-
-    bool success = BASS_SampleSetData(m_handle, reinterpret_cast<void *>(data.data()));
+    // BASS copies the data into the sample, so the caller buffer (which may be a mapped file) is used as is
+    bool success = BASS_SampleSetData(m_handle, sampleData);
     if (!success) {
-        Logs::Puts("[AudioSample] Failed to set sample data on placeholder sample: %d", BASS_ErrorGetCode());
+        Logs::Write(LogLevel::Error, "AudioSample", "Failed to set sample data on placeholder sample: %d", BASS_ErrorGetCode());
         return false;
     }
 
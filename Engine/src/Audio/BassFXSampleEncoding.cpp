@@ -59,3 +59,47 @@ BASS_FX_SampleEncoding::FXEncoding BASS_FX_SampleEncoding::Encode(void *audioDat
         std::move(dataVec)
     };
 }
+
+BASS_FX_SampleEncoding::FXEncoding BASS_FX_SampleEncoding::Decode(void *audioData, size_t size)
+{
+    HSTREAM channel = BASS_StreamCreateFile(TRUE, audioData, 0, size, BASS_STREAM_DECODE | BASS_STREAM_PRESCAN);
+    if (!channel) {
+        return { 0, 0, 0, 0, {} };
+    }
+
+    BASS_CHANNELINFO info;
+    BASS_ChannelGetInfo(channel, &info);
+
+    std::vector<char> dataVec;
+
+    QWORD length = BASS_ChannelGetLength(channel, BASS_POS_BYTE);
+    if (length != (QWORD)-1) {
+        dataVec.reserve((size_t)length);
+    }
+
+    std::vector<char> data(16384);
+    while (true) {
+        DWORD read = BASS_ChannelGetData(channel, data.data(), (DWORD)data.size());
+        if (read == (DWORD)-1 || read == 0) {
+            break;
+        }
+
+        dataVec.insert(dataVec.end(), data.data(), data.data() + read);
+    }
+
+    BASS_ChannelFree(channel);
+
+    if (dataVec.empty()) {
+        return { 0, 0, 0, 0, {} };
+    }
+
+    size_t data_size = dataVec.size();
+
+    return {
+        (int)info.flags,
+        (int)info.freq,
+        (int)info.chans,
+        (int)data_size,
+        std::move(dataVec)
+    };
+}
@@ -80,7 +80,7 @@ void Configuration::Set(std::string key, std::string prop, std::string value)
 
     mINI::INIFile file(path);
     if (!file.write(Config, true)) {
-        Logs::Puts("[Configuration] Failed to write configuration to file");
+        Logs::Write(LogLevel::Error, "Configuration", "Failed to write configuration to file");
     }
 }
 
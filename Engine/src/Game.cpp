@@ -7,20 +7,29 @@
 #include "Game.h"
 #include "Imgui/ImguiUtil.h"
 #include "Logs/Console.h"
+#include "Misc/Profiler.h"
 #include "MsgBox.h"
+#include "Rendering/Threading/JobSystem.h"
 #include "Rendering/Vulkan/VulkanEngine.h"
 #include "Rendering/Window.h"
 #include "Texture/MathUtils.h"
+#include "Texture/TextureCache.h"
 #include <Logs.h>
 #include <SDL2/SDL_image.h>
 
 constexpr auto kInputDefaultRate = 1000.0;
 constexpr auto kMenuDefaultRate = 60.0;
 constexpr auto kAudioDefaultRate = 24.0;
+constexpr auto kMainThreadJobBudget = 2.0;
 
 namespace {
-    bool InitSDL()
+    bool InitSDL(bool headless)
     {
+        // CI machines have no display, SDL's dummy driver still hands out windows and events
+        if (headless && getenv("SDL_VIDEODRIVER") == nullptr) {
+            SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+        }
+
         if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) {
             return false;
         }
@@ -33,35 +42,13 @@ namespace {
         SDL_Quit();
         IMG_Quit();
     }
-
-    thread_local double curTick = 0.0;
-    thread_local double lastTick = 0.0;
-
-    double FrameLimit(double MaxFrameRate)
-    {
-        double newTick = SDL_GetTicks();
-        double targetTick = lastTick + 1000.0 / MaxFrameRate;
-
-        // If the frame rate is too high, wait to avoid shaky animations
-        if (newTick < targetTick) {
-            double delayTicks = targetTick - newTick;
-            SDL_Delay(static_cast<Uint32>(delayTicks));
-            newTick += delayTicks;
-        }
-
-        double delta = (newTick - curTick) / 1000.0;
-        curTick = newTick;
-
-        // Update lastTick for the next frame
-        lastTick = curTick;
-
-        return delta;
-    }
 } // namespace
 
 Game::Game()
 {
     m_frameLimit = 60.0;
+    m_fixedDelta = 0;
+    m_rawInput = false;
     m_running = false;
     m_notify = false;
 
@@ -87,17 +74,23 @@ Game::~Game()
     }
 
     SceneManager::Release();
+    TextureCache::Release();
+    JobSystem::Release();
     AudioManager::Release();
     InputManager::Release();
     Renderer::Release();
     GameWindow::Release();
 
+#if O2GAME_PROFILER
+    Profiler::Release();
+#endif
+
     DeInitSDL();
 }
 
 bool Game::Init()
 {
-    if (!InitSDL()) {
+    if (!InitSDL(m_renderMode == RendererMode::HEADLESS)) {
         MsgBox::ShowOut("SDL Failed to Initialize", "EstEngine Error");
 
         return false;
@@ -123,11 +116,14 @@ bool Game::Init()
         return false;
     }
 
-    if (m_renderMode == RendererMode::OPENGL) {
-        m_threadMode = ThreadMode::SINGLE_THREAD; // OpenGL doesnt support multithreading
+    if (m_renderMode == RendererMode::OPENGL || m_renderMode == RendererMode::HEADLESS) {
+        m_threadMode = ThreadMode::SINGLE_THREAD; // OpenGL doesnt support multithreading, headless wants a fixed update/render order
     }
 
     m_inputManager = InputManager::GetInstance();
+    if (m_rawInput && !m_inputManager->EnableRawKeyboard()) {
+        Logs::Puts("[Game] Raw keyboard input unavailable, using SDL input");
+    }
 
     m_sceneManager = SceneManager::GetInstance();
     m_sceneManager->SetParent(this);
@@ -136,6 +132,8 @@ bool Game::Init()
         return false;
     }
 
+    JobSystem::GetInstance()->Init();
+
     FontResources::PreloadFontCaches();
     m_currentFade = 0;
     m_targetFade = 0;
@@ -150,8 +148,20 @@ void Game::Run()
     m_frameLimit = m_frameLimit == 0 ? kMenuDefaultRate : m_frameLimit;
     m_frameLimitMode = FrameLimitMode::MENU;
 
+    // Input runs at 1000 Hz in multi thread mode, spinning there would keep a core busy for nothing
+    m_audioPacer.SetSpinThreshold(0);
+    if (m_threadMode == ThreadMode::MULTI_THREAD) {
+        m_localPacer.SetSpinThreshold(0);
+    }
+
+    Console::SetFramePacer(m_threadMode == ThreadMode::MULTI_THREAD ? &m_renderPacer : &m_localPacer);
+
     mAudioThread.Run([&] {
-        double delta = FrameLimit(kAudioDefaultRate);
+        PROFILE_THREAD("Audio");
+
+        double delta = m_audioPacer.Wait(kAudioDefaultRate);
+
+        PROFILE_SCOPE("AudioManager::Update");
         AudioManager::GetInstance()->Update(delta);
     },
                      true);
@@ -163,26 +173,38 @@ void Game::Run()
     double time = 0;
 
     mRenderThread.Run([&] {
+        PROFILE_THREAD("Render");
+
         if (m_threadMode == ThreadMode::MULTI_THREAD) {
             double delta = 0;
 
-            switch (m_frameLimitMode) {
-                case FrameLimitMode::GAME:
-                {
-                    delta = FrameLimit(m_frameLimit);
-                    break;
-                }
-
-                case FrameLimitMode::MENU:
-                {
-                    delta = FrameLimit(kMenuDefaultRate);
-                    break;
+            if (m_fixedDelta > 0) {
+                delta = m_fixedDelta;
+            } else {
+                switch (m_frameLimitMode) {
+                    case FrameLimitMode::GAME:
+                    {
+                        delta = m_renderPacer.Wait(m_frameLimit);
+                        break;
+                    }
+
+                    case FrameLimitMode::MENU:
+                    {
+                        delta = m_renderPacer.Wait(kMenuDefaultRate);
+                        break;
+                    }
                 }
             }
 
+            PROFILE_SCOPE("Frame");
+
             CheckFont();
 
-            Update(delta);
+            JobSystem::GetInstance()->PumpMainThread(kMainThreadJobBudget);
+            {
+                PROFILE_SCOPE("Game::Update");
+                Update(delta);
+            }
 
             UpdateFade(delta);
 
@@ -194,7 +216,10 @@ void Game::Run()
 
                 std::lock_guard<std::mutex> lock(m1);
 
-                Render(delta);
+                {
+                    PROFILE_SCOPE("Game::Render");
+                    Render(delta);
+                }
                 MsgBox::Draw();
                 DrawFade(delta);
 
@@ -206,7 +231,7 @@ void Game::Run()
                 frameWithoutSwapchain++;
             }
         } else {
-            FrameLimit(15.0f);
+            m_renderPacer.Wait(15.0f);
         }
     },
                       true);
@@ -229,18 +254,25 @@ void Game::Run()
 
     m_minimized = false;
     mLocalThread.Run([&] {
+        PROFILE_THREAD("Main");
+
         double delta = 0;
-        switch (m_frameLimitMode) {
-            case FrameLimitMode::GAME:
-            {
-                delta = FrameLimit(m_threadMode == ThreadMode::MULTI_THREAD ? kInputDefaultRate : m_frameLimit);
-                break;
-            }
+        if (m_fixedDelta > 0 && m_threadMode == ThreadMode::SINGLE_THREAD) {
+            // Same step every frame and no sleeping, frames come out as fast as they are produced
+            delta = m_fixedDelta;
+        } else {
+            switch (m_frameLimitMode) {
+                case FrameLimitMode::GAME:
+                {
+                    delta = m_localPacer.Wait(m_threadMode == ThreadMode::MULTI_THREAD ? kInputDefaultRate : m_frameLimit);
+                    break;
+                }
 
-            case FrameLimitMode::MENU:
-            {
-                delta = FrameLimit(kMenuDefaultRate);
-                break;
+                case FrameLimitMode::MENU:
+                {
+                    delta = m_localPacer.Wait(kMenuDefaultRate);
+                    break;
+                }
             }
         }
 
@@ -269,13 +301,23 @@ void Game::Run()
         }
 
         if (m_threadMode == ThreadMode::MULTI_THREAD) {
+            PROFILE_SCOPE("Game::Input");
             Input(delta);
         } else {
+            PROFILE_SCOPE("Frame");
+
             CheckFont();
 
-            Input(delta);
+            {
+                PROFILE_SCOPE("Game::Input");
+                Input(delta);
+            }
 
-            Update(delta);
+            JobSystem::GetInstance()->PumpMainThread(kMainThreadJobBudget);
+            {
+                PROFILE_SCOPE("Game::Update");
+                Update(delta);
+            }
 
             UpdateFade(delta);
 
@@ -285,7 +327,10 @@ void Game::Run()
                     frameWithoutSwapchain = 0;
                 }
 
-                Render(delta);
+                {
+                    PROFILE_SCOPE("Game::Render");
+                    Render(delta);
+                }
                 MsgBox::Draw();
                 DrawFade(delta);
 
@@ -315,6 +360,9 @@ void Game::Run()
     mAudioThread.Stop();
     mRenderThread.Stop();
 
+    m_renderer->ReportCapture();
+    Console::SetFramePacer(nullptr);
+
     m_notify = false;
 }
 
@@ -331,6 +379,10 @@ void Game::DrawFade(double delta)
 void Game::DrawConsole()
 {
     Console::Draw();
+
+#if O2GAME_PROFILER
+    Profiler::GetInstance()->DrawOverlay();
+#endif
 }
 
 void Game::UpdateFade(double delta)
@@ -390,6 +442,11 @@ void Game::SetFramelimit(double frameRate)
     m_frameLimit = frameRate;
 }
 
+void Game::SetFixedDelta(double delta)
+{
+    m_fixedDelta = delta;
+}
+
 void Game::SetBufferSize(int width, int height)
 {
     m_bufferWidth = width;
@@ -407,6 +464,11 @@ void Game::SetFullscreen(bool fullscreen)
     m_fullscreen = fullscreen;
 }
 
+void Game::SetRawInput(bool rawInput)
+{
+    m_rawInput = rawInput;
+}
+
 GameThread *Game::GetRenderThread()
 {
     return &mRenderThread;
@@ -0,0 +1,384 @@
+#include "Inputs/EvdevInput.h"
+
+#if defined(__linux__)
+#include <Logs.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+	struct KeyPair {
+		int code;
+		SDL_Scancode scancode;
+	};
+
+	/* Same correspondence as SDL's own Linux keyboard table, limited to what fits in Keys */
+	const KeyPair kKeyPairs[] = {
+		{ KEY_A, SDL_SCANCODE_A }, { KEY_B, SDL_SCANCODE_B }, { KEY_C, SDL_SCANCODE_C }, { KEY_D, SDL_SCANCODE_D },
+		{ KEY_E, SDL_SCANCODE_E }, { KEY_F, SDL_SCANCODE_F }, { KEY_G, SDL_SCANCODE_G }, { KEY_H, SDL_SCANCODE_H },
+		{ KEY_I, SDL_SCANCODE_I }, { KEY_J, SDL_SCANCODE_J }, { KEY_K, SDL_SCANCODE_K }, { KEY_L, SDL_SCANCODE_L },
+		{ KEY_M, SDL_SCANCODE_M }, { KEY_N, SDL_SCANCODE_N }, { KEY_O, SDL_SCANCODE_O }, { KEY_P, SDL_SCANCODE_P },
+		{ KEY_Q, SDL_SCANCODE_Q }, { KEY_R, SDL_SCANCODE_R }, { KEY_S, SDL_SCANCODE_S }, { KEY_T, SDL_SCANCODE_T },
+		{ KEY_U, SDL_SCANCODE_U }, { KEY_V, SDL_SCANCODE_V }, { KEY_W, SDL_SCANCODE_W }, { KEY_X, SDL_SCANCODE_X },
+		{ KEY_Y, SDL_SCANCODE_Y }, { KEY_Z, SDL_SCANCODE_Z },
+
+		{ KEY_1, SDL_SCANCODE_1 }, { KEY_2, SDL_SCANCODE_2 }, { KEY_3, SDL_SCANCODE_3 }, { KEY_4, SDL_SCANCODE_4 },
+		{ KEY_5, SDL_SCANCODE_5 }, { KEY_6, SDL_SCANCODE_6 }, { KEY_7, SDL_SCANCODE_7 }, { KEY_8, SDL_SCANCODE_8 },
+		{ KEY_9, SDL_SCANCODE_9 }, { KEY_0, SDL_SCANCODE_0 },
+
+		{ KEY_ENTER, SDL_SCANCODE_RETURN }, { KEY_ESC, SDL_SCANCODE_ESCAPE }, { KEY_BACKSPACE, SDL_SCANCODE_BACKSPACE },
+		{ KEY_TAB, SDL_SCANCODE_TAB }, { KEY_SPACE, SDL_SCANCODE_SPACE }, { KEY_MINUS, SDL_SCANCODE_MINUS },
+		{ KEY_EQUAL, SDL_SCANCODE_EQUALS }, { KEY_LEFTBRACE, SDL_SCANCODE_LEFTBRACKET }, { KEY_RIGHTBRACE, SDL_SCANCODE_RIGHTBRACKET },
+		{ KEY_BACKSLASH, SDL_SCANCODE_BACKSLASH }, { KEY_SEMICOLON, SDL_SCANCODE_SEMICOLON }, { KEY_APOSTROPHE, SDL_SCANCODE_APOSTROPHE },
+		{ KEY_GRAVE, SDL_SCANCODE_GRAVE }, { KEY_COMMA, SDL_SCANCODE_COMMA }, { KEY_DOT, SDL_SCANCODE_PERIOD },
+		{ KEY_SLASH, SDL_SCANCODE_SLASH }, { KEY_CAPSLOCK, SDL_SCANCODE_CAPSLOCK }, { KEY_102ND, SDL_SCANCODE_NONUSBACKSLASH },
+
+		{ KEY_F1, SDL_SCANCODE_F1 }, { KEY_F2, SDL_SCANCODE_F2 }, { KEY_F3, SDL_SCANCODE_F3 }, { KEY_F4, SDL_SCANCODE_F4 },
+		{ KEY_F5, SDL_SCANCODE_F5 }, { KEY_F6, SDL_SCANCODE_F6 }, { KEY_F7, SDL_SCANCODE_F7 }, { KEY_F8, SDL_SCANCODE_F8 },
+		{ KEY_F9, SDL_SCANCODE_F9 }, { KEY_F10, SDL_SCANCODE_F10 }, { KEY_F11, SDL_SCANCODE_F11 }, { KEY_F12, SDL_SCANCODE_F12 },
+
+		{ KEY_SYSRQ, SDL_SCANCODE_PRINTSCREEN }, { KEY_SCROLLLOCK, SDL_SCANCODE_SCROLLLOCK }, { KEY_PAUSE, SDL_SCANCODE_PAUSE },
+		{ KEY_INSERT, SDL_SCANCODE_INSERT }, { KEY_HOME, SDL_SCANCODE_HOME }, { KEY_PAGEUP, SDL_SCANCODE_PAGEUP },
+		{ KEY_DELETE, SDL_SCANCODE_DELETE }, { KEY_END, SDL_SCANCODE_END }, { KEY_PAGEDOWN, SDL_SCANCODE_PAGEDOWN },
+		{ KEY_RIGHT, SDL_SCANCODE_RIGHT }, { KEY_LEFT, SDL_SCANCODE_LEFT }, { KEY_DOWN, SDL_SCANCODE_DOWN }, { KEY_UP, SDL_SCANCODE_UP },
+
+		{ KEY_NUMLOCK, SDL_SCANCODE_NUMLOCKCLEAR }, { KEY_KPSLASH, SDL_SCANCODE_KP_DIVIDE }, { KEY_KPASTERISK, SDL_SCANCODE_KP_MULTIPLY },
+		{ KEY_KPMINUS, SDL_SCANCODE_KP_MINUS }, { KEY_KPPLUS, SDL_SCANCODE_KP_PLUS }, { KEY_KPENTER, SDL_SCANCODE_KP_ENTER },
+		{ KEY_KP1, SDL_SCANCODE_KP_1 }, { KEY_KP2, SDL_SCANCODE_KP_2 }, { KEY_KP3, SDL_SCANCODE_KP_3 }, { KEY_KP4, SDL_SCANCODE_KP_4 },
+		{ KEY_KP5, SDL_SCANCODE_KP_5 }, { KEY_KP6, SDL_SCANCODE_KP_6 }, { KEY_KP7, SDL_SCANCODE_KP_7 }, { KEY_KP8, SDL_SCANCODE_KP_8 },
+		{ KEY_KP9, SDL_SCANCODE_KP_9 }, { KEY_KP0, SDL_SCANCODE_KP_0 }, { KEY_KPDOT, SDL_SCANCODE_KP_PERIOD },
+
+		{ KEY_LEFTCTRL, SDL_SCANCODE_LCTRL }, { KEY_LEFTSHIFT, SDL_SCANCODE_LSHIFT }, { KEY_LEFTALT, SDL_SCANCODE_LALT },
+		{ KEY_LEFTMETA, SDL_SCANCODE_LGUI }, { KEY_RIGHTCTRL, SDL_SCANCODE_RCTRL }, { KEY_RIGHTSHIFT, SDL_SCANCODE_RSHIFT },
+		{ KEY_RIGHTALT, SDL_SCANCODE_RALT }, { KEY_RIGHTMETA, SDL_SCANCODE_RGUI },
+	};
+
+	/* Indexed by evdev key code, every code used above is below 256 */
+	struct KeyTable {
+		Keys keys[256] = {};
+
+		KeyTable() {
+			for (auto& pair : kKeyPairs) {
+				keys[pair.code] = static_cast<Keys>(pair.scancode);
+			}
+		}
+	};
+
+	const KeyTable kKeyTable;
+
+	bool TestBit(const uint64_t* bits, int bit) {
+		return (bits[bit / 64] >> (bit % 64)) & 1;
+	}
+
+	uint64_t GetMonotonicTime() {
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+	}
+
+	/* Anything with letters and a space bar counts, that skips power buttons, lid switches and mice */
+	bool IsKeyboard(int fd) {
+		uint64_t types[(EV_MAX + 64) / 64] = {};
+		uint64_t keys[(KEY_MAX + 64) / 64] = {};
+
+		if (ioctl(fd, EVIOCGBIT(0, sizeof(types)), types) < 0 || !TestBit(types, EV_KEY)) {
+			return false;
+		}
+
+		if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) < 0) {
+			return false;
+		}
+
+		return TestBit(keys, KEY_A) && TestBit(keys, KEY_Z) && TestBit(keys, KEY_SPACE);
+	}
+
+	void RaiseThreadPriority() {
+		sched_param param = {};
+		param.sched_priority = std::min(10, sched_get_priority_max(SCHED_FIFO));
+
+		int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+		if (result != 0) {
+			Logs::Write(LogLevel::Warning, "Input", "Raw keyboard thread runs at normal priority: %s", strerror(result));
+		}
+	}
+}
+
+EvdevInput::EvdevInput() {
+	m_running = false;
+	m_wakeFd = -1;
+}
+
+EvdevInput::~EvdevInput() {
+	Stop();
+}
+
+bool EvdevInput::Start(raw_key_callback callback) {
+	if (m_running) {
+		return true;
+	}
+
+	DIR* dir = opendir("/dev/input");
+	if (!dir) {
+		Logs::Write(LogLevel::Warning, "Input", "/dev/input is not available: %s", strerror(errno));
+		return false;
+	}
+
+	int denied = 0;
+	while (dirent* entry = readdir(dir)) {
+		if (strncmp(entry->d_name, "event", 5) != 0) {
+			continue;
+		}
+
+		std::string path = std::string("/dev/input/") + entry->d_name;
+
+		int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+		if (fd < 0) {
+			denied += errno == EACCES || errno == EPERM;
+			continue;
+		}
+
+		if (!IsKeyboard(fd)) {
+			close(fd);
+			continue;
+		}
+
+		// Kernel timestamps default to CLOCK_REALTIME, which jumps with NTP
+		int clock = CLOCK_MONOTONIC;
+		ioctl(fd, EVIOCSCLOCKID, &clock);
+
+		char name[128] = "Unknown";
+		ioctl(fd, EVIOCGNAME(sizeof(name)), name);
+
+		Device device = {};
+		device.Fd = fd;
+		device.Name = name;
+		m_devices.push_back(device);
+
+		Logs::Puts("[Input] Raw keyboard: %s (%s)", name, path.c_str());
+	}
+
+	closedir(dir);
+
+	if (m_devices.empty()) {
+		if (denied) {
+			Logs::Puts("[Input] No permission to read %d input devices, add the user to the \"input\" group to use raw keyboard input", denied);
+		} else {
+			Logs::Puts("[Input] No keyboard found under /dev/input");
+		}
+
+		return false;
+	}
+
+	m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_wakeFd < 0) {
+		Logs::Write(LogLevel::Error, "Input", "Failed to create eventfd: %s", strerror(errno));
+		Stop();
+		return false;
+	}
+
+	// Keys already held would otherwise produce a release without a press
+	for (auto& device : m_devices) {
+		uint64_t state[(KEY_MAX + 64) / 64] = {};
+		if (ioctl(device.Fd, EVIOCGKEY(sizeof(state)), state) >= 0) {
+			memcpy(device.Down, state, sizeof(device.Down));
+		}
+	}
+
+	m_callback = callback;
+	m_running = true;
+	m_thread = std::thread([this] { Run(); });
+
+	return true;
+}
+
+void EvdevInput::Stop() {
+	if (m_thread.joinable()) {
+		m_running = false;
+
+		// The thread sleeps in poll without a timeout, the eventfd is the only thing that wakes it up
+		uint64_t value = 1;
+		ssize_t  written;
+		do {
+			written = write(m_wakeFd, &value, sizeof(value));
+		} while (written < 0 && errno == EINTR);
+
+		if (written != sizeof(value)) {
+			Logs::Write(LogLevel::Error, "Input", "Failed to wake the raw keyboard thread: %s", strerror(errno));
+		}
+
+		m_thread.join();
+	}
+
+	m_running = false;
+
+	for (auto& device : m_devices) {
+		close(device.Fd);
+	}
+
+	m_devices.clear();
+
+	if (m_wakeFd >= 0) {
+		close(m_wakeFd);
+		m_wakeFd = -1;
+	}
+}
+
+bool EvdevInput::IsRunning() const {
+	return m_running;
+}
+
+void EvdevInput::Run() {
+	pthread_setname_np(pthread_self(), "evdev");
+	RaiseThreadPriority();
+
+	std::vector<pollfd> fds;
+
+	while (m_running) {
+		fds.clear();
+		fds.push_back({ m_wakeFd, POLLIN, 0 });
+		for (auto& device : m_devices) {
+			fds.push_back({ device.Fd, POLLIN, 0 });
+		}
+
+		if (poll(fds.data(), fds.size(), -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			Logs::Write(LogLevel::Error, "Input", "Raw keyboard poll failed: %s", strerror(errno));
+			break;
+		}
+
+		if (fds[0].revents) {
+			break;
+		}
+
+		for (size_t i = m_devices.size(); i-- > 0;) {
+			auto& device = m_devices[i];
+			auto revents = fds[i + 1].revents;
+
+			if (revents & POLLIN) {
+				ReadDevice(device);
+			}
+
+			if (device.Fd < 0 || (revents & (POLLERR | POLLHUP | POLLNVAL))) {
+				Logs::Puts("[Input] Raw keyboard removed: %s", device.Name.c_str());
+
+				if (device.Fd >= 0) {
+					close(device.Fd);
+				}
+
+				m_devices.erase(m_devices.begin() + i);
+			}
+		}
+	}
+}
+
+void EvdevInput::ReadDevice(Device& device) {
+	input_event events[64];
+
+	for (;;) {
+		ssize_t size = read(device.Fd, events, sizeof(events));
+		if (size < 0) {
+			if (errno == ENODEV) {
+				close(device.Fd);
+				device.Fd = -1;
+			}
+
+			return;
+		}
+
+		size_t count = static_cast<size_t>(size) / sizeof(input_event);
+		for (size_t i = 0; i < count; i++) {
+			auto& event = events[i];
+
+			if (event.type == EV_SYN) {
+				if (event.code == SYN_DROPPED) {
+					device.Dropped = true;
+				} else if (event.code == SYN_REPORT && device.Dropped) {
+					// The kernel queue overflowed, everything up to this report is unreliable
+					device.Dropped = false;
+					Resync(device);
+				}
+
+				continue;
+			}
+
+			// Value 2 is autorepeat
+			if (event.type != EV_KEY || event.value == 2 || device.Dropped) {
+				continue;
+			}
+
+			uint64_t time = static_cast<uint64_t>(event.input_event_sec) * 1000000000ull + static_cast<uint64_t>(event.input_event_usec) * 1000ull;
+			Emit(device, event.code, event.value != 0, time);
+		}
+
+		if (count < sizeof(events) / sizeof(input_event)) {
+			return;
+		}
+	}
+}
+
+void EvdevInput::Resync(Device& device) {
+	uint64_t state[(KEY_MAX + 64) / 64] = {};
+	if (ioctl(device.Fd, EVIOCGKEY(sizeof(state)), state) < 0) {
+		return;
+	}
+
+	uint64_t time = GetMonotonicTime();
+	for (int code = 0; code < 256; code++) {
+		if (TestBit(state, code) != TestBit(device.Down, code)) {
+			Emit(device, code, TestBit(state, code), time);
+		}
+	}
+}
+
+void EvdevInput::Emit(Device& device, int code, bool isDown, uint64_t time) {
+	if (code >= 256) {
+		return;
+	}
+
+	uint64_t bit = 1ull << (code % 64);
+	if (isDown) {
+		device.Down[code / 64] |= bit;
+	} else {
+		device.Down[code / 64] &= ~bit;
+	}
+
+	Keys key = kKeyTable.keys[code];
+	if (key != Keys::INVALID_KEY) {
+		m_callback(key, isDown, time);
+	}
+}
+
+#else
+
+EvdevInput::EvdevInput() {
+	m_running = false;
+	m_wakeFd = -1;
+}
+
+EvdevInput::~EvdevInput() {
+}
+
+bool EvdevInput::Start(raw_key_callback callback) {
+	return false;
+}
+
+void EvdevInput::Stop() {
+}
+
+bool EvdevInput::IsRunning() const {
+	return false;
+}
+
+#endif
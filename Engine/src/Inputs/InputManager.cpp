@@ -1,14 +1,17 @@
 #include "Inputs/InputManager.h"
 #include "Rendering/Window.h"
+#include <chrono>
 
 InputManager::InputManager() {
-	for (Keys i = Keys::A; i != Keys::INVALID_KEY; i = static_cast<Keys>(static_cast<int>(i) + 1)) {
-		m_keyStates[i] = false;
+	for (auto& word : m_keyStates) {
+		word.store(0, std::memory_order_relaxed);
 	}
 
-	for (MouseButton i = MouseButton::LEFT; i != MouseButton::INVALID_BUTTON; i = static_cast<MouseButton>(static_cast<int>(i) + 1)) {
-		m_mouseButton[i] = false;
-	}
+	m_mouseButtons.store(0, std::memory_order_relaxed);
+	m_keyEventWrite.store(0, std::memory_order_relaxed);
+	m_keyEventRead.store(0, std::memory_order_relaxed);
+	m_keyEventOverflow.store(false, std::memory_order_relaxed);
+	m_focused.store(true, std::memory_order_relaxed);
 
 	m_mousePosition = { 0, 0, 0, 0 };
 }
@@ -36,10 +39,19 @@ void InputManager::Update(SDL_Event& event) {
 		case SDL_MOUSEBUTTONUP:
 			OnMouseEvent(event.button, false);
 			break;
-			
+
 		case SDL_MOUSEMOTION:
 			OnMousePositionEvent(event.motion);
 			break;
+
+		case SDL_WINDOWEVENT:
+			if (event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED) {
+				m_focused = true;
+			}
+			else if (event.window.event == SDL_WINDOWEVENT_FOCUS_LOST) {
+				m_focused = false;
+			}
+			break;
 	}
 }
 
@@ -58,12 +70,65 @@ void InputManager::Release() {
 	}
 }
 
-bool InputManager::IsKeyDown(Keys key) {
-	return m_keyStates[key];
+bool InputManager::IsKeyDown(Keys key) const {
+	uint8_t index = static_cast<uint8_t>(key);
+	return (m_keyStates[index >> 6].load(std::memory_order_relaxed) >> (index & 63)) & 1;
 }
 
-bool InputManager::IsMouseButton(MouseButton button) {
-	return m_mouseButton[button];
+bool InputManager::IsMouseButton(MouseButton button) const {
+	if (button == MouseButton::INVALID_BUTTON) {
+		return false;
+	}
+
+	return (m_mouseButtons.load(std::memory_order_relaxed) >> static_cast<int>(button)) & 1;
+}
+
+bool InputManager::PollKeyEvent(KeyState& state) {
+	uint32_t read = m_keyEventRead.load(std::memory_order_relaxed);
+	if (read == m_keyEventWrite.load(std::memory_order_acquire)) {
+		return false;
+	}
+
+	state = m_keyEvents[read % kKeyEventCapacity];
+	m_keyEventRead.store(read + 1, std::memory_order_release);
+	return true;
+}
+
+void InputManager::FlushKeyEvents() {
+	m_keyEventRead.store(m_keyEventWrite.load(std::memory_order_acquire), std::memory_order_release);
+	m_keyEventOverflow.store(false, std::memory_order_relaxed);
+}
+
+bool InputManager::TakeKeyEventOverflow() {
+	return m_keyEventOverflow.exchange(false, std::memory_order_acq_rel);
+}
+
+bool InputManager::EnableRawKeyboard() {
+	if (m_rawKeyboard) {
+		return true;
+	}
+
+	auto rawKeyboard = std::make_unique<EvdevInput>();
+
+	// Called before the window loop runs, nothing else writes the key state yet
+	for (auto& word : m_keyStates) {
+		word.store(0, std::memory_order_relaxed);
+	}
+
+	bool started = rawKeyboard->Start([this](Keys key, bool isDown, uint64_t time) {
+		OnRawKeyEvent(key, isDown, time);
+	});
+
+	if (!started) {
+		return false;
+	}
+
+	m_rawKeyboard = std::move(rawKeyboard);
+	return true;
+}
+
+bool InputManager::IsRawKeyboard() const {
+	return m_rawKeyboard != nullptr;
 }
 
 void InputManager::ListenKeyEvent(key_event_callback callback) {
@@ -78,32 +143,66 @@ Rect InputManager::GetMousePosition() {
 	return m_mousePosition;
 }
 
+void InputManager::PushKeyEvent(const KeyState& state) {
+	uint32_t write = m_keyEventWrite.load(std::memory_order_relaxed);
+	if (write - m_keyEventRead.load(std::memory_order_acquire) >= kKeyEventCapacity) {
+		// The key state bits are still current, the consumer resyncs from them
+		m_keyEventOverflow.store(true, std::memory_order_release);
+		return;
+	}
+
+	m_keyEvents[write % kKeyEventCapacity] = state;
+	m_keyEventWrite.store(write + 1, std::memory_order_release);
+}
+
+bool InputManager::SetKeyState(Keys key, bool isDown) {
+	uint8_t  index = static_cast<uint8_t>(key);
+	uint64_t bit = 1ull << (index & 63);
+
+	auto& word = m_keyStates[index >> 6];
+	uint64_t last = isDown ? word.fetch_or(bit, std::memory_order_relaxed) : word.fetch_and(~bit, std::memory_order_relaxed);
+
+	// Key repeat reports a down for a key that is already down
+	return ((last & bit) != 0) != isDown;
+}
+
+void InputManager::OnRawKeyEvent(Keys key, bool isDown, uint64_t time) {
+	// evdev sees every key on the machine; presses only count while the window has focus, releases always do so nothing sticks
+	if (isDown && !m_focused) {
+		return;
+	}
+
+	if (SetKeyState(key, isDown)) {
+		PushKeyEvent({ key, isDown ? KeyEventType::KEY_DOWN : KeyEventType::KEY_UP, time });
+	}
+}
+
 void InputManager::OnKeyEvent(SDL_Event& event, bool isDown) {
-	Keys key = (Keys)event.key.keysym.scancode;
-	if (key == Keys::INVALID_KEY) {
+	// Keys is 8 bit, anything past it would alias a different key
+	if (event.key.keysym.scancode <= 0 || event.key.keysym.scancode > 0xFF) {
 		return;
 	}
 
-	int lastState = m_keyStates[key];
-	KeyState state = { key, isDown ? KeyEventType::KEY_DOWN : KeyEventType::KEY_UP };
+	Keys     key = (Keys)event.key.keysym.scancode;
+	uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	KeyState state = { key, isDown ? KeyEventType::KEY_DOWN : KeyEventType::KEY_UP, time };
 
-	if (isDown) {
-		m_keyStates[key] = true;
-		
-		if (!lastState && m_keyStates[key]) {
-			for (auto& it : m_keyEventCallbacks) {
-				it(state);
-			}
+	if (m_rawKeyboard) {
+		// Key state and the ring belong to the raw keyboard thread, SDL only drives the callbacks
+		if (event.key.repeat) {
+			return;
 		}
 	}
 	else {
-		m_keyStates[key] = false;
-		
-		if (lastState && !m_keyStates[key]) {
-			for (auto& it : m_keyEventCallbacks) {
-				it(state);
-			}
+		if (!SetKeyState(key, isDown)) {
+			return;
 		}
+
+		PushKeyEvent(state);
+	}
+
+	for (auto& it : m_keyEventCallbacks) {
+		it(state);
 	}
 }
 
@@ -116,31 +215,25 @@ void InputManager::OnMouseEvent(SDL_MouseButtonEvent& event, bool isDown) {
 		case SDL_BUTTON_MIDDLE: button = MouseButton::MIDDLE; break;
 	}
 
-	if (button != MouseButton::INVALID_BUTTON) {
-		bool lastState = m_mouseButton[button];
+	if (button == MouseButton::INVALID_BUTTON) {
+		return;
+	}
+
+	uint8_t bit = static_cast<uint8_t>(1 << static_cast<int>(button));
+	uint8_t last = isDown ? m_mouseButtons.fetch_or(bit, std::memory_order_relaxed) : m_mouseButtons.fetch_and(static_cast<uint8_t>(~bit), std::memory_order_relaxed);
 
-		m_mouseButton[button] = isDown;
+	if (((last & bit) != 0) == isDown) {
+		return;
+	}
 
-		MouseState state = {};
-		state.button = button;
-		state.isDown = isDown;
-		state.posX = m_mousePosition.left;
-		state.posY = m_mousePosition.right;
+	MouseState state = {};
+	state.button = button;
+	state.isDown = isDown;
+	state.posX = m_mousePosition.left;
+	state.posY = m_mousePosition.right;
 
-		if (isDown) {
-			if (!lastState && m_mouseButton[button]) {
-				for (auto& it : m_mouseEventCallbacks) {
-					it(state);
-				}
-			}
-		}
-		else {
-			if (!lastState && !m_mouseButton[button]) {
-				for (auto& it : m_mouseEventCallbacks) {
-					it(state);
-				}
-			}
-		}
+	for (auto& it : m_mouseEventCallbacks) {
+		it(state);
 	}
 }
 
@@ -148,6 +241,6 @@ void InputManager::OnMousePositionEvent(SDL_MouseMotionEvent& event) {
 	GameWindow* wnd = GameWindow::GetInstance();
 	int x = (event.x * wnd->GetBufferWidth()) / wnd->GetWidth();
 	int y = (event.y * wnd->GetBufferHeight()) / wnd->GetHeight();
-	
+
 	m_mousePosition = { x, y, 0, 0 };
 }
@@ -1,16 +1,138 @@
 #include "Console.h"
+#include <deque>
+#include <float.h>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <vector>
 #include <Imgui/ImguiUtil.h>
 #include <Imgui/imgui.h>
+#include <Misc/FramePacer.h>
 #include <Texture/MathUtils.h>
 
 namespace {
-    std::string outputBuffer = {};
-    bool        showConsole = false;
+    struct Line
+    {
+        LogLevel    Level;
+        std::string Text;
+    };
+
+    std::mutex       linesLock; // Writer thread appends while the render thread draws
+    std::deque<Line> lines = {};
+    bool             linesAdded = false;
+
+    bool             showConsole = false;
+    bool             autoScroll = true;
+    int              levelFilter = static_cast<int>(LogLevel::Debug);
+    ImGuiTextFilter  textFilter;
+    std::vector<int> filtered;
+    FramePacer      *framePacer = nullptr;
+
+    ImVec4 GetLevelColor(LogLevel level)
+    {
+        switch (level) {
+            case LogLevel::Debug:
+                return ImVec4(0.6f, 0.6f, 0.6f, 1.0f);
+            case LogLevel::Warning:
+                return ImVec4(1.0f, 0.8f, 0.3f, 1.0f);
+            case LogLevel::Error:
+                return ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
+            default:
+                return ImGui::GetStyleColorVec4(ImGuiCol_Text);
+        }
+    }
+
+    void DrawLine(const Line &line)
+    {
+        if (line.Level == LogLevel::Info) {
+            ImGui::TextUnformatted(line.Text.c_str(), line.Text.c_str() + line.Text.size());
+            return;
+        }
+
+        ImGui::PushStyleColor(ImGuiCol_Text, GetLevelColor(line.Level));
+        ImGui::TextUnformatted(line.Text.c_str(), line.Text.c_str() + line.Text.size());
+        ImGui::PopStyleColor();
+    }
+
+    void DrawLines()
+    {
+        std::lock_guard<std::mutex> lock(linesLock);
+
+        // Only the rows inside the child window are submitted, the rest are skipped by height
+        ImGuiListClipper clipper;
+
+        bool filtering = textFilter.IsActive() || levelFilter > static_cast<int>(LogLevel::Debug);
+        if (filtering) {
+            filtered.clear();
+            for (int i = 0; i < static_cast<int>(lines.size()); i++) {
+                auto &line = lines[i];
+                if (static_cast<int>(line.Level) >= levelFilter && textFilter.PassFilter(line.Text.c_str(), line.Text.c_str() + line.Text.size())) {
+                    filtered.push_back(i);
+                }
+            }
+
+            clipper.Begin(static_cast<int>(filtered.size()));
+        } else {
+            clipper.Begin(static_cast<int>(lines.size()));
+        }
+
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                DrawLine(lines[filtering ? filtered[i] : i]);
+            }
+        }
+
+        clipper.End();
+
+        if (linesAdded && autoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
+            ImGui::SetScrollHereY(1.0f);
+        }
+
+        linesAdded = false;
+    }
+
+    void DrawFramePacing()
+    {
+        if (!ImGui::CollapsingHeader("Frame pacing")) {
+            return;
+        }
+
+        ImGui::Text("Frames: %llu  avg %.2f ms  min %.2f ms  max %.2f ms",
+                    static_cast<unsigned long long>(framePacer->GetFrameCount()),
+                    framePacer->GetAverage(),
+                    framePacer->GetMinimum(),
+                    framePacer->GetMaximum());
+        ImGui::Text("p50 %.1f ms  p90 %.1f ms  p99 %.1f ms",
+                    framePacer->GetPercentile(50.0),
+                    framePacer->GetPercentile(90.0),
+                    framePacer->GetPercentile(99.0));
+
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "0 - %.0f ms", FramePacer::kBucketCount * FramePacer::kBucketWidth);
+
+        ImGui::PlotHistogram("##frame_pacing", framePacer->GetHistogram(), FramePacer::kBucketCount, 0, overlay, 0.0f, FLT_MAX, MathUtil::ScaleVec2(0, 80));
+
+        if (ImGui::Button("Reset")) {
+            framePacer->ResetStats();
+        }
+    }
 } // namespace
 
-void Console::Send(std::string output)
+void Console::Send(LogLevel level, const char *output)
 {
-    outputBuffer += output + "\n";
+    std::lock_guard<std::mutex> lock(linesLock);
+
+    if (lines.size() >= kMaxLines) {
+        lines.pop_front();
+    }
+
+    lines.push_back({ level, output });
+    linesAdded = true;
+}
+
+void Console::SetFramePacer(FramePacer *pacer)
+{
+    framePacer = pacer;
 }
 
 void Console::Draw()
@@ -24,17 +146,30 @@ void Console::Draw()
     ImGui::SetNextWindowSize(MathUtil::ScaleVec2(400, 400), ImGuiCond_FirstUseEver);
     if (showConsole && ImGui::Begin("Console", &showConsole, 0)) {
         if (ImGui::Button("Clear Console")) {
-            outputBuffer.clear();
+            std::lock_guard<std::mutex> lock(linesLock);
+            lines.clear();
         }
 
-        auto size = ImGui::GetWindowSize();
-        size -= MathUtil::ScaleVec2(10, 50);
+        ImGui::SameLine();
+        ImGui::Checkbox("Auto-scroll", &autoScroll);
+
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(MathUtil::ScaleVec2(90, 0).x);
+        ImGui::Combo("##console_level", &levelFilter, "Debug\0Info\0Warning\0Error\0");
+
+        ImGui::SameLine();
+        textFilter.Draw("Filter", -FLT_MIN);
+
+        if (framePacer) {
+            DrawFramePacing();
+        }
 
-        if (ImGui::BeginChild("#console_child_window", size, true, 0)) {
-            ImGui::Text("%s", outputBuffer.c_str());
+        auto size = ImGui::GetContentRegionAvail();
 
-            ImGui::EndChild();
+        if (ImGui::BeginChild("#console_child_window", size, true, ImGuiWindowFlags_HorizontalScrollbar)) {
+            DrawLines();
         }
+        ImGui::EndChild();
 
         ImGui::End();
     }
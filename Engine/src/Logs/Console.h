@@ -1,7 +1,16 @@
 #pragma once
+#include <Logs.h>
 #include <iostream>
 
+class FramePacer;
+
 namespace Console {
-    void Send(std::string output);
+    /* Keeps the last kMaxLines lines, safe to call from any thread */
+    constexpr size_t kMaxLines = 4096;
+
+    void Send(LogLevel level, const char *output);
     void Draw();
-}
\ No newline at end of file
+
+    /* Pacer whose frame time histogram is shown in the console window, nullptr hides it */
+    void SetFramePacer(FramePacer *pacer);
+}
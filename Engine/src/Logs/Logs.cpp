@@ -1,18 +1,492 @@
 #include <Logs.h>
+#include <atomic>
+#include <chrono>
 #include <cstdarg>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <string_view>
+#include <thread>
+#include <time.h>
 
 #include "Console.h"
 
+namespace {
+    constexpr size_t kQueueSize = 4096; // Power of two
+    constexpr size_t kMessageSize = 256; // Same truncation as the old stack buffer
+
+    struct Entry
+    {
+        std::atomic<size_t>                   Sequence;
+        LogLevel                              Level;
+        std::chrono::system_clock::time_point Time;
+        char                                  Message[kMessageSize];
+    };
+
+    class FileSink
+    {
+    public:
+        bool Open(const std::filesystem::path &path, size_t maxBytes, int maxFiles)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            m_stream.close();
+            m_path = path;
+            m_maxBytes = maxBytes;
+            m_maxFiles = maxFiles;
+
+            if (m_path.empty()) {
+                return true;
+            }
+
+            m_stream.open(m_path, std::ios::out | std::ios::app | std::ios::binary);
+            m_size = m_stream ? static_cast<size_t>(m_stream.tellp()) : 0;
+
+            return m_stream.is_open();
+        }
+
+        void Write(LogLevel level, std::chrono::system_clock::time_point time, const char *message)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            WriteLocked(level, time, message);
+        }
+
+        /* Crash path, gives up instead of blocking when the faulting thread may be holding the sink */
+        void TryWrite(LogLevel level, std::chrono::system_clock::time_point time, const char *message)
+        {
+            std::unique_lock<std::mutex> lock(m_lock, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                return;
+            }
+
+            WriteLocked(level, time, message);
+            if (m_stream.is_open()) {
+                m_stream.flush();
+            }
+        }
+
+        void Flush()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_stream.is_open()) {
+                m_stream.flush();
+            }
+        }
+
+    private:
+        void WriteLocked(LogLevel level, std::chrono::system_clock::time_point time, const char *message)
+        {
+            if (!m_stream.is_open()) {
+                return;
+            }
+
+            time_t seconds = std::chrono::system_clock::to_time_t(time);
+            int    millis = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000);
+
+            struct tm local = {};
+#if _WIN32
+            localtime_s(&local, &seconds);
+#else
+            localtime_r(&seconds, &local);
+#endif
+
+            char prefix[64];
+            int  length = static_cast<int>(strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &local));
+            length += snprintf(prefix + length, sizeof(prefix) - length, ".%03d %-7s ", millis, Logs::LevelName(level));
+
+            size_t messageLength = strlen(message);
+            m_stream.write(prefix, length);
+            m_stream.write(message, messageLength);
+            m_stream.put('\n');
+            m_size += length + messageLength + 1;
+
+            if (m_size >= m_maxBytes) {
+                Rotate();
+            }
+        }
+
+        void Rotate()
+        {
+            m_stream.close();
+
+            std::error_code ec;
+            for (int i = m_maxFiles - 1; i >= 1; i--) {
+                auto from = m_path.string() + "." + std::to_string(i);
+                auto to = m_path.string() + "." + std::to_string(i + 1);
+                std::filesystem::rename(from, to, ec);
+            }
+
+            if (m_maxFiles > 0) {
+                std::filesystem::rename(m_path, m_path.string() + ".1", ec);
+            } else {
+                std::filesystem::remove(m_path, ec);
+            }
+
+            m_stream.open(m_path, std::ios::out | std::ios::trunc | std::ios::binary);
+            m_size = 0;
+        }
+
+        std::mutex            m_lock; // Only the writer thread, SetFileSink and WriteFatal contend on it
+        std::ofstream         m_stream;
+        std::filesystem::path m_path;
+        size_t                m_size = 0;
+        size_t                m_maxBytes = 0;
+        int                   m_maxFiles = 0;
+    };
+
+    /*
+     * Bounded multi-producer ring (Vyukov): a producer claims a slot with a
+     * CAS on the enqueue position and publishes it through the slot's
+     * sequence number, so no producer ever waits on another or on the writer.
+     */
+    class Logger
+    {
+    public:
+        Logger()
+        {
+            for (size_t i = 0; i < kQueueSize; i++) {
+                m_entries[i].Sequence.store(i, std::memory_order_relaxed);
+            }
+
+            m_running = true;
+            m_thread = std::thread(&Logger::Worker, this);
+        }
+
+        ~Logger()
+        {
+            Stop();
+        }
+
+        bool IsRunning() const
+        {
+            return m_running.load(std::memory_order_acquire);
+        }
+
+        bool Push(LogLevel level, const char *message)
+        {
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            Entry *entry = nullptr;
+
+            for (;;) {
+                entry = &m_entries[pos & (kQueueSize - 1)];
+                size_t   sequence = entry->Sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+                if (diff == 0) {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                } else {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            entry->Level = level;
+            entry->Time = std::chrono::system_clock::now();
+            strncpy(entry->Message, message, kMessageSize - 1);
+            entry->Message[kMessageSize - 1] = '\0';
+            entry->Sequence.store(pos + 1, std::memory_order_release);
+
+            Wake();
+            return true;
+        }
+
+        void Flush()
+        {
+            size_t target = m_enqueuePos.load(std::memory_order_acquire);
+
+            m_flushing.fetch_add(1, std::memory_order_acq_rel);
+            Wake();
+
+            size_t written = m_written.load(std::memory_order_acquire);
+            while (written < target && IsRunning()) {
+                m_written.wait(written, std::memory_order_acquire);
+                written = m_written.load(std::memory_order_acquire);
+            }
+
+            m_flushing.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        void Stop()
+        {
+            if (m_stopping.exchange(true, std::memory_order_acq_rel)) {
+                return;
+            }
+
+            // Producers keep using the ring until the writer has drained it, so nothing written in place overtakes it
+            m_sleeping.store(false, std::memory_order_seq_cst);
+            m_sleeping.notify_one();
+
+            if (m_thread.joinable()) {
+                m_thread.join();
+            }
+
+            // The writer is gone, so this thread owns the dequeue side; pick up whatever landed after its last drain
+            m_running.store(false, std::memory_order_release);
+            Drain();
+
+            m_sink.Flush();
+        }
+
+        FileSink &GetSink()
+        {
+            return m_sink;
+        }
+
+        void Output(LogLevel level, std::chrono::system_clock::time_point time, const char *message)
+        {
+            ::puts(message);
+            m_sink.Write(level, time, message);
+            Console::Send(level, message);
+        }
+
+        void OutputFatal(const char *message)
+        {
+            ::fputs(message, stdout);
+            ::fputc('\n', stdout);
+            ::fflush(stdout);
+
+            m_sink.TryWrite(LogLevel::Error, std::chrono::system_clock::now(), message);
+        }
+
+    private:
+        void Wake()
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // Plain load first so busy producers don't all write the flag's cache line
+            if (m_sleeping.load(std::memory_order_seq_cst) && m_sleeping.exchange(false, std::memory_order_seq_cst)) {
+                m_sleeping.notify_one();
+            }
+        }
+
+        bool HasPending()
+        {
+            auto &entry = m_entries[m_dequeuePos & (kQueueSize - 1)];
+            return entry.Sequence.load(std::memory_order_acquire) == m_dequeuePos + 1;
+        }
+
+        size_t Drain()
+        {
+            size_t count = 0;
+
+            while (HasPending()) {
+                auto &entry = m_entries[m_dequeuePos & (kQueueSize - 1)];
+                Output(entry.Level, entry.Time, entry.Message);
+
+                entry.Sequence.store(m_dequeuePos + kQueueSize, std::memory_order_release);
+                m_dequeuePos++;
+                count++;
+            }
+
+            size_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped) {
+                char message[64];
+                snprintf(message, sizeof(message), "[Logs] Log ring full, dropped %zu messages", dropped);
+                Output(LogLevel::Warning, std::chrono::system_clock::now(), message);
+            }
+
+            if (count || m_flushing.load(std::memory_order_acquire)) {
+                if (m_flushing.load(std::memory_order_acquire)) {
+                    m_sink.Flush();
+                    fflush(stdout);
+                }
+
+                m_written.store(m_dequeuePos, std::memory_order_release);
+                m_written.notify_all();
+            }
+
+            return count;
+        }
+
+        void Worker()
+        {
+            while (!m_stopping) {
+                if (Drain()) {
+                    continue;
+                }
+
+                m_sleeping.store(true, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if (!HasPending() && !m_stopping && !m_flushing.load(std::memory_order_acquire)) {
+                    m_sleeping.wait(true, std::memory_order_seq_cst);
+                }
+
+                m_sleeping.store(false, std::memory_order_relaxed);
+            }
+
+            Drain();
+
+            m_written.store(m_dequeuePos, std::memory_order_release);
+            m_written.notify_all();
+        }
+
+        Entry               m_entries[kQueueSize];
+        std::atomic<size_t> m_enqueuePos = 0;
+        size_t              m_dequeuePos = 0; // Writer thread only
+
+        std::atomic<size_t> m_written = 0;
+        std::atomic<size_t> m_dropped = 0;
+        std::atomic<int>    m_flushing = 0;
+        std::atomic<bool>   m_sleeping = false;
+        std::atomic<bool>   m_stopping = false;
+        std::atomic<bool>   m_running = false;
+
+        FileSink    m_sink;
+        std::thread m_thread;
+    };
+
+    Logger &GetLogger()
+    {
+        static Logger logger;
+        return logger;
+    }
+
+    std::atomic<LogLevel> minimumLevel = LogLevel::Debug;
+
+    // Per category levels, the flag keeps the common no-override case off the lock
+    std::shared_mutex                            categoryLock;
+    std::map<std::string, LogLevel, std::less<>> categoryLevels;
+    std::atomic<bool>                            hasCategoryLevels = false;
+
+    bool IsFiltered(LogLevel level, std::string_view category)
+    {
+        if (level < minimumLevel.load(std::memory_order_relaxed)) {
+            return true;
+        }
+
+        if (category.empty() || !hasCategoryLevels.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        std::shared_lock<std::shared_mutex> lock(categoryLock);
+
+        auto it = categoryLevels.find(category);
+        return it != categoryLevels.end() && level < it->second;
+    }
+
+    std::string_view TagCategory(const char *fmt)
+    {
+        if (fmt[0] != '[') {
+            return {};
+        }
+
+        const char *end = strchr(fmt, ']');
+        return end ? std::string_view(fmt + 1, end - fmt - 1) : std::string_view();
+    }
+
+    void Submit(LogLevel level, const char *message)
+    {
+        auto &logger = GetLogger();
+
+        if (logger.IsRunning()) {
+            logger.Push(level, message);
+            return;
+        }
+
+        // After Shutdown, or from static destructors, write in place
+        logger.Output(level, std::chrono::system_clock::now(), message);
+    }
+} // namespace
+
 void Logs::Puts(const char *fmt, ...)
 {
-    char buffer[256] = {};
+    if (IsFiltered(LogLevel::Info, TagCategory(fmt))) {
+        return;
+    }
+
+    char buffer[kMessageSize];
 
     va_list args;
     va_start(args, fmt);
     vsnprintf(buffer, sizeof(buffer), fmt, args);
     va_end(args);
 
-    ::puts(buffer);
-    Console::Send(buffer);
-}
\ No newline at end of file
+    Submit(LogLevel::Info, buffer);
+}
+
+void Logs::Write(LogLevel level, const char *category, const char *fmt, ...)
+{
+    if (IsFiltered(level, category ? std::string_view(category) : std::string_view())) {
+        return;
+    }
+
+    char buffer[kMessageSize];
+    int  length = 0;
+
+    if (category && *category) {
+        length = snprintf(buffer, sizeof(buffer), "[%s] ", category);
+        length = length < 0 ? 0 : (length < static_cast<int>(sizeof(buffer)) ? length : static_cast<int>(sizeof(buffer)) - 1);
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buffer + length, sizeof(buffer) - length, fmt, args);
+    va_end(args);
+
+    Submit(level, buffer);
+}
+
+void Logs::SetLevel(LogLevel level)
+{
+    minimumLevel.store(level, std::memory_order_relaxed);
+}
+
+LogLevel Logs::GetLevel()
+{
+    return minimumLevel.load(std::memory_order_relaxed);
+}
+
+void Logs::SetCategoryLevel(const char *category, LogLevel level)
+{
+    std::unique_lock<std::shared_mutex> lock(categoryLock);
+
+    categoryLevels[category] = level;
+    hasCategoryLevels.store(true, std::memory_order_release);
+}
+
+bool Logs::SetFileSink(const std::filesystem::path &path, size_t maxBytes, int maxFiles)
+{
+    return GetLogger().GetSink().Open(path, maxBytes, maxFiles);
+}
+
+void Logs::Flush()
+{
+    auto &logger = GetLogger();
+    if (logger.IsRunning()) {
+        logger.Flush();
+    }
+}
+
+void Logs::Shutdown()
+{
+    GetLogger().Stop();
+}
+
+void Logs::WriteFatal(const char *message)
+{
+    GetLogger().OutputFatal(message);
+}
+
+const char *Logs::LevelName(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::Debug:
+            return "DEBUG";
+        case LogLevel::Info:
+            return "INFO";
+        case LogLevel::Warning:
+            return "WARNING";
+        case LogLevel::Error:
+            return "ERROR";
+    }
+
+    return "UNKNOWN";
+}
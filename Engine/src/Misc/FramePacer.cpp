@@ -0,0 +1,168 @@
+#include "Misc/FramePacer.h"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <string.h>
+#include <thread>
+
+#if __linux__
+#include <errno.h>
+#include <time.h>
+#endif
+
+namespace {
+#if _WIN32
+    // Windows sleeps round up to the 1 ms timer resolution SDL requests, plus scheduling slack
+    constexpr double kDefaultSpinThreshold = 2.0;
+#else
+    constexpr double kDefaultSpinThreshold = 1.0;
+#endif
+} // namespace
+
+FramePacer::FramePacer()
+{
+    m_frequency = SDL_GetPerformanceFrequency();
+    m_deadline = 0;
+    m_lastFrame = 0;
+    m_rate = 0;
+
+    SetSpinThreshold(kDefaultSpinThreshold);
+    ResetStats();
+}
+
+double FramePacer::Wait(double rate)
+{
+    uint64_t now = SDL_GetPerformanceCounter();
+
+    if (rate > 0) {
+        uint64_t period = static_cast<uint64_t>(m_frequency / rate);
+
+        // A new rate (menu -> gameplay) starts a new schedule instead of catching up to the old one
+        if (rate != m_rate || m_deadline == 0) {
+            m_rate = rate;
+            m_deadline = now;
+        }
+
+        m_deadline += period;
+
+        if (now < m_deadline) {
+            SleepUntil(m_deadline);
+            now = SDL_GetPerformanceCounter();
+        } else if (now - m_deadline > period) {
+            // More than a whole frame late (hitch, breakpoint), drop the missed frames instead of bursting
+            m_deadline = now;
+        }
+    }
+
+    double delta = 0;
+    if (m_lastFrame != 0) {
+        delta = static_cast<double>(now - m_lastFrame) / m_frequency;
+        Record(delta * 1000.0);
+    }
+
+    m_lastFrame = now;
+    return delta;
+}
+
+void FramePacer::SetSpinThreshold(double milliseconds)
+{
+    m_spinTicks = static_cast<uint64_t>(std::max(milliseconds, 0.0) * m_frequency / 1000.0);
+}
+
+void FramePacer::SleepUntil(uint64_t deadline)
+{
+    uint64_t now = SDL_GetPerformanceCounter();
+
+    if (deadline - now > m_spinTicks) {
+        uint64_t sleepTicks = deadline - now - m_spinTicks;
+
+#if __linux__
+        uint64_t        nanoseconds = sleepTicks * 1000000000ull / m_frequency;
+        struct timespec request = {};
+        request.tv_sec = static_cast<time_t>(nanoseconds / 1000000000ull);
+        request.tv_nsec = static_cast<long>(nanoseconds % 1000000000ull);
+
+        // Relative sleep, the performance counter may not be on CLOCK_MONOTONIC; the spin below absorbs the difference
+        while (clock_nanosleep(CLOCK_MONOTONIC, 0, &request, &request) == EINTR) {
+        }
+#else
+        // With a spin window the sleep truncates and the spin takes the rest; without one it rounds up so a sub-millisecond wait
+        // (the 1000 Hz input loop) still sleeps instead of yielding the whole way, at the cost of waking up to 1 ms late
+        uint64_t scaled = sleepTicks * 1000;
+        Uint32   milliseconds = static_cast<Uint32>(m_spinTicks > 0 ? scaled / m_frequency : (scaled + m_frequency - 1) / m_frequency);
+        if (milliseconds > 0) {
+            SDL_Delay(milliseconds);
+        }
+#endif
+    }
+
+    // Spin window, also catches an early wake-up when the performance counter and the sleep clock disagree
+    while (SDL_GetPerformanceCounter() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::Record(double milliseconds)
+{
+    int bucket = static_cast<int>(milliseconds / kBucketWidth);
+    bucket = std::clamp(bucket, 0, kBucketCount - 1);
+
+    m_histogram[bucket] += 1.0f;
+    m_frames++;
+    m_total += milliseconds;
+    m_minimum = std::min(m_minimum, milliseconds);
+    m_maximum = std::max(m_maximum, milliseconds);
+}
+
+void FramePacer::ResetStats()
+{
+    memset(m_histogram, 0, sizeof(m_histogram));
+    m_frames = 0;
+    m_total = 0;
+    m_minimum = 1e9;
+    m_maximum = 0;
+}
+
+const float *FramePacer::GetHistogram() const
+{
+    return m_histogram;
+}
+
+uint64_t FramePacer::GetFrameCount() const
+{
+    return m_frames;
+}
+
+double FramePacer::GetAverage() const
+{
+    return m_frames > 0 ? m_total / m_frames : 0.0;
+}
+
+double FramePacer::GetMinimum() const
+{
+    return m_frames > 0 ? m_minimum : 0.0;
+}
+
+double FramePacer::GetMaximum() const
+{
+    return m_maximum;
+}
+
+double FramePacer::GetPercentile(double percent) const
+{
+    if (m_frames == 0) {
+        return 0.0;
+    }
+
+    double target = m_frames * percent / 100.0;
+    double count = 0;
+
+    for (int i = 0; i < kBucketCount; i++) {
+        count += m_histogram[i];
+        if (count >= target) {
+            // Upper edge of the bucket, the histogram is too coarse for anything finer
+            return std::min(static_cast<double>((i + 1) * kBucketWidth), m_maximum);
+        }
+    }
+
+    return m_maximum;
+}
@@ -0,0 +1,126 @@
+#include "Misc/MappedFile.h"
+
+#if _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+    m_data = nullptr;
+    m_size = 0;
+
+#if _WIN32
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+#else
+    m_fd = -1;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(std::filesystem::path path)
+{
+    Close();
+
+#if _WIN32
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = reinterpret_cast<const uint8_t *>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.string().c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st = {};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void *view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_data = reinterpret_cast<const uint8_t *>(view);
+    m_size = static_cast<size_t>(st.st_size);
+#endif
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data == nullptr) {
+        return;
+    }
+
+#if _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle((HANDLE)m_mapping);
+    CloseHandle((HANDLE)m_file);
+
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+#else
+    ::munmap(const_cast<uint8_t *>(m_data), m_size);
+    ::close(m_fd);
+
+    m_fd = -1;
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool MappedFile::IsOpen() const
+{
+    return m_data != nullptr;
+}
+
+const uint8_t *MappedFile::Data() const
+{
+    return m_data;
+}
+
+size_t MappedFile::Size() const
+{
+    return m_size;
+}
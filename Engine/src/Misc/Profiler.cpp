@@ -0,0 +1,263 @@
+#include "Misc/Profiler.h"
+
+#if O2GAME_PROFILER
+#include <Imgui/imgui.h>
+#include <Logs.h>
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <string.h>
+
+namespace {
+    thread_local Profiler::ThreadData *currentThread = nullptr;
+
+    void InitTrack(Profiler::Track &track, const char *name)
+    {
+        memset(&track, 0, sizeof(track));
+        track.Name = name;
+    }
+
+    void DrawTrack(const Profiler::Track &track)
+    {
+        if (track.Count == 0) {
+            return;
+        }
+
+        // Unroll the ring so the graph scrolls from left to right
+        float values[Profiler::kHistoryLength];
+        float total = 0.0f;
+        float peak = 0.0f;
+
+        int start = track.Count < Profiler::kHistoryLength ? 0 : track.Head;
+        for (int i = 0; i < track.Count; i++) {
+            values[i] = track.History[(start + i) % Profiler::kHistoryLength];
+            total += values[i];
+            peak = std::max(peak, values[i]);
+        }
+
+        float last = values[track.Count - 1];
+
+        char overlay[128];
+        snprintf(overlay, sizeof(overlay), "%.3f ms (avg %.3f, max %.3f)", last, total / track.Count, peak);
+
+        ImGui::TextUnformatted(track.Name);
+        ImGui::PlotLines((std::string("##") + track.Name).c_str(), values, track.Count, 0, overlay, 0.0f, std::max(peak, 1.0f), ImVec2(0, 40));
+    }
+
+    // Marker names are string literals, but keep the trace valid if one ever carries a quote
+    void WriteEscaped(std::ofstream &fs, const char *text)
+    {
+        for (const char *c = text; *c; c++) {
+            if (*c == '"' || *c == '\\') {
+                fs << '\\';
+            }
+
+            fs << *c;
+        }
+    }
+} // namespace
+
+Profiler *Profiler::m_instance = nullptr;
+
+Profiler::Profiler()
+{
+    m_frequency = SDL_GetPerformanceFrequency();
+    m_origin = SDL_GetPerformanceCounter();
+    m_visible = false;
+
+    InitTrack(m_gpu, "GPU frame");
+}
+
+Profiler::~Profiler()
+{
+    currentThread = nullptr;
+}
+
+Profiler *Profiler::GetInstance()
+{
+    if (m_instance == nullptr) {
+        m_instance = new Profiler();
+    }
+
+    return m_instance;
+}
+
+void Profiler::Release()
+{
+    if (m_instance != nullptr) {
+        delete m_instance;
+        m_instance = nullptr;
+    }
+}
+
+Profiler::ThreadData *Profiler::GetThreadData()
+{
+    if (currentThread) {
+        return currentThread;
+    }
+
+    auto data = std::make_unique<ThreadData>();
+    data->Events.reserve(kEventCapacity);
+    data->EventHead = 0;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    data->Id = static_cast<uint32_t>(m_threads.size());
+    data->Name = "Thread " + std::to_string(data->Id);
+
+    currentThread = data.get();
+    m_threads.push_back(std::move(data));
+
+    return currentThread;
+}
+
+void Profiler::SetThreadName(const char *name)
+{
+    auto data = GetThreadData();
+
+    std::lock_guard<std::mutex> lock(data->Mutex);
+    data->Name = name;
+}
+
+void Profiler::Push(Track &track, float value)
+{
+    track.History[track.Head] = value;
+    track.Head = (track.Head + 1) % kHistoryLength;
+    track.Count = std::min(track.Count + 1, kHistoryLength);
+}
+
+void Profiler::Submit(const char *name, uint64_t start, uint64_t end)
+{
+    auto data = GetThreadData();
+
+    std::lock_guard<std::mutex> lock(data->Mutex);
+
+    if (data->Events.size() < kEventCapacity) {
+        data->Events.push_back({ name, start, end });
+    } else {
+        data->Events[data->EventHead] = { name, start, end };
+        data->EventHead = (data->EventHead + 1) % kEventCapacity;
+    }
+
+    // A thread only has a handful of distinct markers, a linear scan beats hashing here.
+    // The same literal can live at different addresses in different translation units
+    auto it = std::find_if(data->Tracks.begin(), data->Tracks.end(), [name](const Track &track) {
+        return track.Name == name || strcmp(track.Name, name) == 0;
+    });
+
+    if (it == data->Tracks.end()) {
+        data->Tracks.emplace_back();
+        InitTrack(data->Tracks.back(), name);
+        it = data->Tracks.end() - 1;
+    }
+
+    Push(*it, static_cast<float>((end - start) * 1000.0 / m_frequency));
+}
+
+void Profiler::SubmitGpuTime(double milliseconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Push(m_gpu, static_cast<float>(milliseconds));
+}
+
+void Profiler::DrawOverlay()
+{
+    if (ImGui::IsKeyPressed(ImGuiKey_F9, false)) {
+        m_visible = !m_visible;
+    }
+
+    if (!m_visible) {
+        return;
+    }
+
+    ImGui::SetNextWindowSize(ImVec2(420, 480), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Profiler", &m_visible, 0)) {
+        if (ImGui::Button("Export Chrome trace")) {
+            ExportChromeTrace("trace.json");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_gpu.Count > 0 && ImGui::CollapsingHeader("GPU", ImGuiTreeNodeFlags_DefaultOpen)) {
+                DrawTrack(m_gpu);
+            }
+
+            for (auto &thread : m_threads) {
+                std::lock_guard<std::mutex> threadLock(thread->Mutex);
+
+                ImGui::PushID(thread.get());
+                if (ImGui::CollapsingHeader(thread->Name.c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
+                    for (auto &track : thread->Tracks) {
+                        DrawTrack(track);
+                    }
+                }
+                ImGui::PopID();
+            }
+        }
+    }
+
+    // Begin has to be paired with End even when the window is collapsed
+    ImGui::End();
+}
+
+bool Profiler::ExportChromeTrace(std::filesystem::path path)
+{
+    std::ofstream fs(path, std::ios::trunc);
+    if (!fs.is_open()) {
+        Logs::Write(LogLevel::Error, "Profiler", "Failed to open %s for writing", path.string().c_str());
+        return false;
+    }
+
+    // Timestamps are microseconds since startup, keep them out of scientific notation
+    fs << std::fixed << std::setprecision(3);
+    fs << "{\"traceEvents\":[";
+
+    bool   first = true;
+    size_t count = 0;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &thread : m_threads) {
+        std::lock_guard<std::mutex> threadLock(thread->Mutex);
+
+        fs << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread->Id << ",\"args\":{\"name\":\"";
+        WriteEscaped(fs, thread->Name.c_str());
+        fs << "\"}}";
+        first = false;
+
+        // Oldest first, chrome://tracing does not need sorted input but Perfetto is faster with it
+        size_t size = thread->Events.size();
+        for (size_t i = 0; i < size; i++) {
+            auto &event = thread->Events[(thread->EventHead + i) % size];
+            if (event.Start < m_origin) {
+                continue;
+            }
+
+            double start = (event.Start - m_origin) * 1000000.0 / m_frequency;
+            double duration = (event.End - event.Start) * 1000000.0 / m_frequency;
+
+            fs << ",\n{\"name\":\"";
+            WriteEscaped(fs, event.Name);
+            fs << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread->Id << ",\"ts\":" << start << ",\"dur\":" << duration << "}";
+        }
+
+        count += size;
+    }
+
+    fs << "\n]}\n";
+
+    Logs::Puts("[Profiler] Wrote %zu events to %s", count, path.string().c_str());
+    return true;
+}
+
+Profiler::Scope::Scope(const char *name)
+{
+    m_name = name;
+    m_start = SDL_GetPerformanceCounter();
+}
+
+Profiler::Scope::~Scope()
+{
+    Profiler::GetInstance()->Submit(m_name, m_start, SDL_GetPerformanceCounter());
+}
+#endif
@@ -0,0 +1,242 @@
+#include <Misc/TimerWheel.h>
+#include <algorithm>
+#include <bit>
+
+namespace {
+    constexpr uint64_t kTopLevelSpan = 1ull << (TimerWheel::kLevels * TimerWheel::kSlotBits);
+
+    uint32_t GetIndex(TimerHandle handle)
+    {
+        return static_cast<uint32_t>(handle & 0xFFFFFFFF) - 1;
+    }
+
+    uint32_t GetGeneration(TimerHandle handle)
+    {
+        return static_cast<uint32_t>(handle >> 32);
+    }
+} // namespace
+
+TimerWheel::TimerWheel()
+{
+    m_origin = Clock::now();
+    m_currentTick = 0;
+    m_pending = 0;
+
+    std::fill(std::begin(m_heads), std::end(m_heads), kNone);
+}
+
+TimerHandle TimerWheel::Schedule(Clock::duration delay, std::function<void()> callback)
+{
+    // Rounded up so a callback never runs before its delay has passed
+    uint64_t expiry = ToTick(Clock::now() + std::max(delay, Clock::duration::zero()), true);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    int32_t index;
+    if (m_free.size()) {
+        index = m_free.back();
+        m_free.pop_back();
+    } else {
+        index = static_cast<int32_t>(m_nodes.size());
+        m_nodes.push_back({});
+        m_nodes[index].Generation = 1;
+    }
+
+    auto &node = m_nodes[index];
+    node.Callback = std::move(callback);
+    node.Expiry = std::max(expiry, m_currentTick + 1); // Ticks up to m_currentTick are already processed
+    Link(index);
+
+    m_pending++;
+
+    return (static_cast<TimerHandle>(node.Generation) << 32) | static_cast<uint32_t>(index + 1);
+}
+
+bool TimerWheel::Cancel(TimerHandle handle)
+{
+    if (handle == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    uint32_t index = GetIndex(handle);
+    if (index >= m_nodes.size()) {
+        return false;
+    }
+
+    auto &node = m_nodes[index];
+    if (node.Generation != GetGeneration(handle) || node.Slot == kNone) {
+        return false;
+    }
+
+    Unlink(static_cast<int32_t>(index));
+    Release(static_cast<int32_t>(index));
+    m_pending--;
+
+    return true;
+}
+
+void TimerWheel::Advance(Clock::time_point now)
+{
+    std::vector<std::function<void()>> due;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        uint64_t target = ToTick(now, false);
+
+        while (m_currentTick < target) {
+            // Nothing pending, no slot can fire or cascade until something is scheduled
+            if (m_pending == 0) {
+                m_currentTick = target;
+                break;
+            }
+
+            uint64_t tick = ++m_currentTick;
+
+            if ((tick & (kTopLevelSpan - 1)) == 0) {
+                Relink(kOverflowSlot);
+            }
+
+            // Higher levels first, what they hand down may land in a lower level slot cascading this tick
+            for (int level = kLevels - 1; level > 0; level--) {
+                uint64_t mask = (1ull << (level * kSlotBits)) - 1;
+                if ((tick & mask) == 0) {
+                    Relink(level * kSlots + static_cast<int>((tick >> (level * kSlotBits)) & (kSlots - 1)));
+                }
+            }
+
+            int32_t index = m_heads[tick & (kSlots - 1)];
+            while (index != kNone) {
+                int32_t next = m_nodes[index].Next;
+
+                m_due.push_back(std::move(m_nodes[index].Callback));
+                Unlink(index);
+                Release(index);
+                m_pending--;
+
+                index = next;
+            }
+        }
+
+        due.swap(m_due);
+    }
+
+    if (due.empty()) {
+        return;
+    }
+
+    // Run outside the lock, a callback may schedule or cancel on this wheel
+    for (auto &callback : due) {
+        callback();
+    }
+
+    due.clear();
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_due.empty()) {
+        m_due = std::move(due);
+    }
+}
+
+void TimerWheel::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    for (int32_t i = 0; i < static_cast<int32_t>(m_nodes.size()); i++) {
+        if (m_nodes[i].Slot != kNone) {
+            Unlink(i);
+            Release(i);
+        }
+    }
+
+    m_pending = 0;
+}
+
+size_t TimerWheel::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_pending;
+}
+
+uint64_t TimerWheel::ToTick(Clock::time_point time, bool roundUp) const
+{
+    if (time <= m_origin) {
+        return 0;
+    }
+
+    auto elapsed = time - m_origin;
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+    if (roundUp && millis < elapsed) {
+        millis += std::chrono::milliseconds(1);
+    }
+
+    return static_cast<uint64_t>(millis.count());
+}
+
+void TimerWheel::Link(int32_t index)
+{
+    auto &node = m_nodes[index];
+
+    // The level is picked by the highest 6 bit group in which the deadline differs from now
+    uint64_t diff = node.Expiry ^ m_currentTick;
+    int      level = diff ? (std::bit_width(diff) - 1) / kSlotBits : 0;
+
+    int slot = kOverflowSlot;
+    if (level < kLevels) {
+        slot = level * kSlots + static_cast<int>((node.Expiry >> (level * kSlotBits)) & (kSlots - 1));
+    }
+
+    node.Slot = slot;
+    node.Prev = kNone;
+    node.Next = m_heads[slot];
+
+    if (node.Next != kNone) {
+        m_nodes[node.Next].Prev = index;
+    }
+
+    m_heads[slot] = index;
+}
+
+void TimerWheel::Unlink(int32_t index)
+{
+    auto &node = m_nodes[index];
+
+    if (node.Prev != kNone) {
+        m_nodes[node.Prev].Next = node.Next;
+    } else {
+        m_heads[node.Slot] = node.Next;
+    }
+
+    if (node.Next != kNone) {
+        m_nodes[node.Next].Prev = node.Prev;
+    }
+
+    node.Slot = kNone;
+    node.Prev = node.Next = kNone;
+}
+
+void TimerWheel::Relink(int slot)
+{
+    int32_t index = m_heads[slot];
+    m_heads[slot] = kNone;
+
+    while (index != kNone) {
+        int32_t next = m_nodes[index].Next;
+        Link(index);
+
+        index = next;
+    }
+}
+
+void TimerWheel::Release(int32_t index)
+{
+    auto &node = m_nodes[index];
+
+    node.Callback = nullptr;
+    node.Generation = node.Generation == kMaxGeneration ? 1 : node.Generation + 1;
+    node.Slot = kNone;
+
+    m_free.push_back(index);
+}
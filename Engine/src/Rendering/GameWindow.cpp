@@ -47,6 +47,9 @@ bool GameWindow::Create(RendererMode mode, std::string title, int width, int hei
     if (mode == RendererMode::VULKAN) {
         flags |= SDL_WINDOW_VULKAN;
     }
+    if (mode == RendererMode::HEADLESS) {
+        flags = (flags & ~SDL_WINDOW_SHOWN) | SDL_WINDOW_HIDDEN;
+    }
 
     // check if width and height are same in current display
     SDL_DisplayMode dm;
@@ -2,11 +2,14 @@
 #include "../Data/Imgui/imgui_impl_sdl2.h"
 #include "../Data/Imgui/imgui_impl_sdlrenderer2.h"
 #include "../Data/SDLRenderStruct.h"
+#include "Configuration.h"
 #include "Exception/SDLException.h"
 #include "Imgui/ImguiUtil.h"
 #include "MsgBox.h"
+#include "Rendering/SDLBatch.h"
 #include "Rendering/Vulkan/VulkanEngine.h"
 #include <Logs.h>
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
 
@@ -69,9 +72,26 @@ bool Renderer::Create(RendererMode mode, GameWindow *window, bool failed)
                 rendererName = "metal";
                 break;
             }
+
+            case RendererMode::HEADLESS:
+            {
+                rendererName = "software";
+                break;
+            }
         }
 
-        if (bUsedSDLRenderer) {
+        if (mode == RendererMode::HEADLESS) {
+            // Rendered into a plain surface, the window (if any) never gets presented to
+            m_headlessSurface = SDL_CreateRGBSurfaceWithFormat(0, window->GetWidth(), window->GetHeight(), 32, SDL_PIXELFORMAT_RGBA32);
+            if (!m_headlessSurface) {
+                throw SDLException();
+            }
+
+            m_renderer = SDL_CreateSoftwareRenderer(m_headlessSurface);
+            if (!m_renderer) {
+                throw SDLException();
+            }
+        } else if (bUsedSDLRenderer) {
             // loop and find the first available renderer
             if (!failed) {
                 bool found = false;
@@ -105,9 +125,11 @@ bool Renderer::Create(RendererMode mode, GameWindow *window, bool failed)
             }
 
             if (failed) {
-                Logs::Puts("[Renderer] Failed to create renderer with backend: %s, and fallback to %s", rendererName.c_str(), SDL_GetCurrentVideoDriver());
+                Logs::Write(LogLevel::Warning, "Renderer", "Failed to create renderer with backend: %s, and fallback to %s", rendererName.c_str(), SDL_GetCurrentVideoDriver());
             }
+        }
 
+        if (bUsedSDLRenderer) {
             m_blendMode = SDL_ComposeCustomBlendMode(
                 SDL_BLENDFACTOR_SRC_ALPHA,
                 SDL_BLENDFACTOR_ONE,
@@ -120,6 +142,13 @@ bool Renderer::Create(RendererMode mode, GameWindow *window, bool failed)
                 throw SDLException();
             }
 
+            m_batch = new SDLBatch(m_renderer);
+
+            // Game.ini [Game] SDLBatching=0 submits every sprite on its own, for comparing both paths
+            if (Configuration::Load("Game", "SDLBatching") == "0") {
+                m_batch->SetEnabled(false);
+            }
+
             IMGUI_CHECKVERSION();
             ImGui::CreateContext();
 
@@ -233,6 +262,9 @@ bool Renderer::EndRender()
 
         m_vulkan->end();
     } else {
+        // Sprites queued this frame have to land before the ImGui overlay
+        m_batch->EndFrame();
+
         if (ImguiUtil::HasFrameQueue()) {
             ImguiUtil::Reset();
 
@@ -242,6 +274,10 @@ bool Renderer::EndRender()
         SDL_RenderPresent(m_renderer);
     }
 
+    if (m_capturing) {
+        CaptureFrame();
+    }
+
     return true;
 }
 
@@ -259,6 +295,11 @@ SDL_BlendMode Renderer::GetSDLBlendMode()
     return m_blendMode;
 }
 
+SDLBatch *Renderer::GetSDLBatch()
+{
+    return m_batch;
+}
+
 VulkanEngine *Renderer::GetVulkanEngine()
 {
     return m_vulkan;
@@ -279,6 +320,82 @@ bool Renderer::IsVulkan()
     return GetVulkanEngine() != nullptr;
 }
 
+bool Renderer::IsHeadless()
+{
+    return m_headlessSurface != nullptr;
+}
+
+void Renderer::SetFrameDump(std::filesystem::path path)
+{
+    m_frameDump.open(path, std::ios::out | std::ios::trunc);
+    if (!m_frameDump.is_open()) {
+        Logs::Write(LogLevel::Error, "Renderer", "Failed to open frame dump: %s", path.string().c_str());
+    }
+}
+
+void Renderer::BeginCapture()
+{
+    m_capturing = true;
+    m_capturedFrames = 0;
+    m_frameTimes.clear();
+    m_lastFrame = std::chrono::steady_clock::now();
+}
+
+void Renderer::CaptureFrame()
+{
+    auto now = std::chrono::steady_clock::now();
+    m_frameTimes.push_back(std::chrono::duration<double, std::milli>(now - m_lastFrame).count());
+    m_lastFrame = now;
+
+    if (m_headlessSurface && m_frameDump.is_open()) {
+        // FNV-1a over the visible pixels, row padding excluded
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        int      rowBytes = m_headlessSurface->w * 4;
+
+        for (int y = 0; y < m_headlessSurface->h; y++) {
+            auto row = (const uint8_t *)m_headlessSurface->pixels + (size_t)y * m_headlessSurface->pitch;
+            for (int x = 0; x < rowBytes; x++) {
+                hash = (hash ^ row[x]) * 0x100000001b3ULL;
+            }
+        }
+
+        char line[64];
+        snprintf(line, sizeof(line), "%d %016llx\n", m_capturedFrames, (unsigned long long)hash);
+        m_frameDump << line;
+    }
+
+    m_capturedFrames++;
+}
+
+void Renderer::ReportCapture()
+{
+    if (m_frameTimes.empty()) {
+        return;
+    }
+
+    std::vector<double> sorted = m_frameTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto percentile = [&](double p) {
+        size_t index = std::min(sorted.size() - 1, (size_t)(p / 100.0 * (sorted.size() - 1) + 0.5));
+        return sorted[index];
+    };
+
+    double total = 0;
+    for (double time : sorted) {
+        total += time;
+    }
+
+    Logs::Puts("[Benchmark] %d frames, avg %.3f ms, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms",
+               (int)sorted.size(), total / sorted.size(), percentile(50), percentile(90), percentile(99), sorted.back());
+
+    if (m_frameDump.is_open()) {
+        m_frameDump.flush();
+    }
+
+    m_capturing = false;
+}
+
 Renderer *Renderer::GetInstance()
 {
     if (s_instance == nullptr) {
@@ -315,7 +432,16 @@ bool Renderer::Destroy()
 
         ImGui_ImplSDLRenderer2_Shutdown();
 
+        delete m_batch;
+        m_batch = nullptr;
+
         SDL_DestroyRenderer(m_renderer);
+        m_renderer = nullptr;
+    }
+
+    if (m_headlessSurface) {
+        SDL_FreeSurface(m_headlessSurface);
+        m_headlessSurface = nullptr;
     }
 
     if (IsVulkan()) {
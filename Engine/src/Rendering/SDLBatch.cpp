@@ -0,0 +1,128 @@
+#include "Rendering/SDLBatch.h"
+#include "Exception/SDLException.h"
+#include <string.h>
+
+SDLBatch::SDLBatch(SDL_Renderer *renderer)
+{
+    m_renderer = renderer;
+
+    m_texture = nullptr;
+    m_blendMode = SDL_BLENDMODE_NONE;
+    m_clip = {};
+    m_hasClip = false;
+
+    m_appliedClip = {};
+    m_hasAppliedClip = false;
+    m_clipKnown = false;
+
+    m_enabled = true;
+    m_drawCalls = 0;
+    m_lastDrawCalls = 0;
+
+    m_vertices.reserve(4096);
+    m_indices.reserve(6144);
+}
+
+void SDLBatch::QueueQuad(SDL_Texture *texture, const SDL_Vertex *vertices, SDL_BlendMode blendMode, const SDL_Rect *clip)
+{
+    bool hasClip = clip != nullptr;
+
+    if (m_vertices.size()) {
+        bool sameClip = hasClip == m_hasClip && (!hasClip || memcmp(clip, &m_clip, sizeof(SDL_Rect)) == 0);
+        if (texture != m_texture || blendMode != m_blendMode || !sameClip) {
+            Flush();
+        }
+    }
+
+    m_texture = texture;
+    m_blendMode = blendMode;
+    m_hasClip = hasClip;
+    if (hasClip) {
+        m_clip = *clip;
+    }
+
+    int base = (int)m_vertices.size();
+    m_vertices.insert(m_vertices.end(), vertices, vertices + 4);
+
+    int quad[6] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+    m_indices.insert(m_indices.end(), quad, quad + 6);
+
+    if (!m_enabled) {
+        Flush();
+    }
+}
+
+void SDLBatch::Flush()
+{
+    if (m_vertices.empty()) {
+        return;
+    }
+
+    // Consecutive batches mostly share the clip, only touch it when it actually changes
+    bool sameClip = m_clipKnown && m_hasClip == m_hasAppliedClip && (!m_hasClip || memcmp(&m_clip, &m_appliedClip, sizeof(SDL_Rect)) == 0);
+    if (!sameClip) {
+        SDL_RenderSetClipRect(m_renderer, m_hasClip ? &m_clip : nullptr);
+
+        m_appliedClip = m_clip;
+        m_hasAppliedClip = m_hasClip;
+        m_clipKnown = true;
+    }
+
+    SDL_BlendMode oldBlendMode = SDL_BLENDMODE_NONE;
+    SDL_GetTextureBlendMode(m_texture, &oldBlendMode);
+    if (oldBlendMode != m_blendMode) {
+        SDL_SetTextureBlendMode(m_texture, m_blendMode);
+    }
+
+    int error = SDL_RenderGeometry(
+        m_renderer,
+        m_texture,
+        m_vertices.data(),
+        (int)m_vertices.size(),
+        m_indices.data(),
+        (int)m_indices.size());
+
+    if (oldBlendMode != m_blendMode) {
+        SDL_SetTextureBlendMode(m_texture, oldBlendMode);
+    }
+
+    m_vertices.clear();
+    m_indices.clear();
+    m_drawCalls++;
+
+    if (error != 0) {
+        throw SDLException();
+    }
+}
+
+void SDLBatch::InvalidateState()
+{
+    m_clipKnown = false;
+}
+
+void SDLBatch::SetEnabled(bool enabled)
+{
+    Flush();
+    m_enabled = enabled;
+}
+
+bool SDLBatch::IsEnabled() const
+{
+    return m_enabled;
+}
+
+void SDLBatch::EndFrame()
+{
+    Flush();
+
+    m_lastDrawCalls = m_drawCalls;
+    m_drawCalls = 0;
+
+    // ImGui and present change the clip behind our back
+    InvalidateState();
+}
+
+uint32_t SDLBatch::GetLastDrawCalls() const
+{
+    return m_lastDrawCalls;
+}
@@ -17,6 +17,24 @@ static int                                                        m_textureCount
 static std::mutex                                                 m_textureMutex;
 static std::unique_ptr<Texture2D_Vulkan>                          m_dummyTexture;
 
+/*
+ * While a batch is open, pixels are appended to one shared staging area instead
+ * of getting a buffer and a blocking submit each; EndBatch uploads them all
+ * with a single command buffer that is retired asynchronously.
+ */
+struct UploadBatch
+{
+    std::vector<uint8_t>            Staging;
+    std::vector<Texture2D_Vulkan *> Textures;
+    std::vector<VkDeviceSize>       Offsets;
+};
+
+static int         m_batchDepth = 0;
+static UploadBatch m_batch;
+
+// Staging memory above this is flushed early, so a huge batch doesn't hold it all at once
+constexpr size_t kMaxBatchStaging = 64 * 1024 * 1024;
+
 Texture2D_Vulkan *CreateTexture()
 {
     // find the empty slot
@@ -71,6 +89,131 @@ Texture2D_Vulkan *vkTexture::TexLoadImage(std::filesystem::path imagePath)
     return TexLoadImage(buffer.data(), size);
 }
 
+void RecordImageCopies(VkCommandBuffer cmd, VkBuffer staging, Texture2D_Vulkan **textures, const VkDeviceSize *offsets, size_t count)
+{
+    std::vector<VkImageMemoryBarrier> copy_barriers(count);
+    std::vector<VkImageMemoryBarrier> use_barriers(count);
+
+    for (size_t i = 0; i < count; i++) {
+        auto &copy_barrier = copy_barriers[i];
+        copy_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        copy_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        copy_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        copy_barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        copy_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        copy_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        copy_barrier.image = textures[i]->Image;
+        copy_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copy_barrier.subresourceRange.levelCount = 1;
+        copy_barrier.subresourceRange.layerCount = 1;
+
+        auto &use_barrier = use_barriers[i];
+        use_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        use_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        use_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        use_barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        use_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        use_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        use_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        use_barrier.image = textures[i]->Image;
+        use_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        use_barrier.subresourceRange.levelCount = 1;
+        use_barrier.subresourceRange.layerCount = 1;
+    }
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, (uint32_t)count, copy_barriers.data());
+
+    for (size_t i = 0; i < count; i++) {
+        VkBufferImageCopy region = {};
+        region.bufferOffset = offsets ? offsets[i] : 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent.width = textures[i]->Width;
+        region.imageExtent.height = textures[i]->Height;
+        region.imageExtent.depth = 1;
+        vkCmdCopyBufferToImage(cmd, staging, textures[i]->Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    }
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, (uint32_t)count, use_barriers.data());
+}
+
+void SubmitBatch()
+{
+    if (m_batch.Textures.empty()) {
+        return;
+    }
+
+    auto vulkan_driver = VulkanEngine::GetInstance();
+    auto device = vulkan_driver->_device;
+
+    VkBuffer       staging = VK_NULL_HANDLE;
+    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
+    VkDeviceSize   size = m_batch.Staging.size();
+
+    {
+        VkBufferCreateInfo buffer_info = {};
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.size = size;
+        buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateBuffer(device, &buffer_info, nullptr, &staging) != VK_SUCCESS) {
+            throw std::runtime_error("Vulkan: Failed to create staging buffer");
+        }
+
+        VkMemoryRequirements req;
+        vkGetBufferMemoryRequirements(device, staging, &req);
+        VkMemoryAllocateInfo alloc_info = {};
+        alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        alloc_info.allocationSize = req.size;
+        alloc_info.memoryTypeIndex = findMemoryType(vulkan_driver->_chosenGPU, req.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        if (vkAllocateMemory(device, &alloc_info, nullptr, &stagingMemory) != VK_SUCCESS) {
+            throw std::runtime_error("Vulkan: Failed to allocate staging buffer");
+        }
+
+        if (vkBindBufferMemory(device, staging, stagingMemory, 0) != VK_SUCCESS) {
+            throw std::runtime_error("Vulkan: Failed to bind staging buffer");
+        }
+    }
+
+    {
+        void *map = NULL;
+        if (vkMapMemory(device, stagingMemory, 0, size, 0, &map) != VK_SUCCESS) {
+            throw std::runtime_error("Vulkan: Failed to map staging buffer");
+        }
+
+        memcpy(map, m_batch.Staging.data(), (size_t)size);
+        vkUnmapMemory(device, stagingMemory);
+    }
+
+    auto textures = std::move(m_batch.Textures);
+    auto offsets = std::move(m_batch.Offsets);
+    m_batch = {};
+
+    vulkan_driver->async_submit(
+        [&](VkCommandBuffer cmd) {
+            RecordImageCopies(cmd, staging, textures.data(), offsets.data(), textures.size());
+        },
+        [=] {
+            vkDestroyBuffer(device, staging, nullptr);
+            vkFreeMemory(device, stagingMemory, nullptr);
+        });
+}
+
+void StageBatchImage(Texture2D_Vulkan *tex_data, const unsigned char *image_data, size_t image_size)
+{
+    if (m_batch.Staging.size() + image_size > kMaxBatchStaging) {
+        SubmitBatch();
+    }
+
+    // Buffer offsets of a copy must be a multiple of the texel size, 16 keeps every row nicely aligned too
+    size_t offset = (m_batch.Staging.size() + 15) & ~(size_t)15;
+    m_batch.Staging.resize(offset + image_size);
+    memcpy(m_batch.Staging.data() + offset, image_data, image_size);
+
+    m_batch.Textures.push_back(tex_data);
+    m_batch.Offsets.push_back(offset);
+}
+
 void InternalLoad(
     VulkanEngine     *vulkan_driver,
     Texture2D_Vulkan *tex_data,
@@ -155,6 +298,11 @@ void InternalLoad(
 
     tex_data->DS = ImGui_ImplVulkan_AddTexture(tex_data->Sampler, tex_data->ImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
+    if (m_batchDepth > 0) {
+        StageBatchImage(tex_data, image_data, image_size);
+        return;
+    }
+
     {
         VkBufferCreateInfo buffer_info = {};
         buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -203,43 +351,8 @@ void InternalLoad(
         vkUnmapMemory(vulkan_driver->_device, tex_data->UploadBufferMemory);
     }
 
-    stbi_image_free(image_data);
-
     vulkan_driver->immediate_submit([&](VkCommandBuffer cmd) {
-        VkImageMemoryBarrier copy_barrier[1] = {};
-        copy_barrier[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        copy_barrier[0].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        copy_barrier[0].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        copy_barrier[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        copy_barrier[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        copy_barrier[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        copy_barrier[0].image = tex_data->Image;
-        copy_barrier[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copy_barrier[0].subresourceRange.levelCount = 1;
-        copy_barrier[0].subresourceRange.layerCount = 1;
-        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, copy_barrier);
-
-        VkBufferImageCopy region = {};
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.layerCount = 1;
-        region.imageExtent.width = tex_data->Width;
-        region.imageExtent.height = tex_data->Height;
-        region.imageExtent.depth = 1;
-        vkCmdCopyBufferToImage(cmd, tex_data->UploadBuffer, tex_data->Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-        VkImageMemoryBarrier use_barrier[1] = {};
-        use_barrier[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        use_barrier[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        use_barrier[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        use_barrier[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        use_barrier[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        use_barrier[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        use_barrier[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        use_barrier[0].image = tex_data->Image;
-        use_barrier[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        use_barrier[0].subresourceRange.levelCount = 1;
-        use_barrier[0].subresourceRange.layerCount = 1;
-        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, use_barrier);
+        RecordImageCopies(cmd, tex_data->UploadBuffer, &tex_data, nullptr, 1);
     });
 }
 
@@ -261,6 +374,20 @@ Texture2D_Vulkan *vkTexture::TexLoadImage(void *buffer, size_t size)
         throw std::runtime_error("Failed to load the image");
 
     InternalLoad(vulkan_driver, tex_data, image_data);
+    stbi_image_free(image_data);
+
+    return tex_data;
+}
+
+Texture2D_Vulkan *vkTexture::TexLoadRaw(const void *pixels, int width, int height)
+{
+    auto vulkan_driver = VulkanEngine::GetInstance();
+    auto tex_data = CreateTexture();
+    tex_data->Channels = 4;
+    tex_data->Width = width;
+    tex_data->Height = height;
+
+    InternalLoad(vulkan_driver, tex_data, (unsigned char *)pixels);
 
     return tex_data;
 }
@@ -292,11 +419,29 @@ Texture2D_Vulkan *vkTexture::GetDummyImage()
         auto vulkan_driver = VulkanEngine::GetInstance();
 
         InternalLoad(vulkan_driver, m_dummyTexture.get(), image_data);
+        stbi_image_free(image_data);
     }
 
     return m_dummyTexture.get();
 }
 
+void vkTexture::BeginBatch()
+{
+    m_batchDepth++;
+}
+
+void vkTexture::EndBatch()
+{
+    if (m_batchDepth == 0) {
+        return;
+    }
+
+    m_batchDepth--;
+    if (m_batchDepth == 0) {
+        SubmitBatch();
+    }
+}
+
 VkDescriptorSet vkTexture::GetVkDescriptorSet(Texture2D_Vulkan *handle)
 {
     return handle->DS;
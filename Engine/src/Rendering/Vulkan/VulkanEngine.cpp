@@ -5,12 +5,14 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_vulkan.h>
 
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
 #include "../../Data/Imgui/imgui_impl_sdl2.h"
 #include "../../Data/Imgui/imgui_impl_vulkan.h"
 #include "Exception/SDLException.h"
+#include "Misc/Profiler.h"
 #include "Rendering/Vulkan/Texture2DVulkan.h"
 #include "vkinit.h"
 #include <Logs.h>
@@ -48,6 +50,32 @@ using namespace std;
 #pragma GCC diagnostic ignored "-Wdeprecated"
 #endif
 
+namespace {
+    void CreateHostBuffer(VkDevice device, VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer &buffer, VkDeviceMemory &memory)
+    {
+        VkBufferCreateInfo bufferInfo = {};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VK_CHECK(vkCreateBuffer(device, &bufferInfo, nullptr, &buffer));
+
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = memRequirements.size;
+        allocInfo.memoryTypeIndex = vkTexture::FindMemoryType(
+            memRequirements.memoryTypeBits,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        VK_CHECK(vkAllocateMemory(device, &allocInfo, nullptr, &memory));
+        VK_CHECK(vkBindBufferMemory(device, buffer, memory, 0));
+    }
+} // namespace
+
 VulkanEngine::~VulkanEngine()
 {
     cleanup();
@@ -97,6 +125,7 @@ void VulkanEngine::cleanup()
     if (_isInitialized) {
         vkDeviceWaitIdle(_device);
 
+        poll_uploads(true);
         vkTexture::Cleanup();
 
         _swapChainQueue.flush();
@@ -149,8 +178,25 @@ void VulkanEngine::begin()
 
     VK_CHECK(vkResetFences(_device, 1, &get_current_frame()._renderFence));
 
+#if O2GAME_PROFILER
+    // The fence above guarantees the timestamps of this frame slot's previous submit are available
+    auto &timedFrame = get_current_frame();
+    if (timedFrame._timestampsWritten) {
+        uint64_t timestamps[2] = {};
+        auto     queryResult = vkGetQueryPoolResults(_device, timedFrame._timestampPool, 0, 2, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+        if (queryResult == VK_SUCCESS && timestamps[1] >= timestamps[0]) {
+            Profiler::GetInstance()->SubmitGpuTime((timestamps[1] - timestamps[0]) * _gpuProperties.limits.timestampPeriod / 1000000.0);
+        }
+
+        timedFrame._timestampsWritten = false;
+    }
+#endif
+
     VK_CHECK(vkResetCommandBuffer(get_current_frame()._mainCommandBuffer, 0));
 
+    // A texture released this frame may still be the target of an upload in flight
+    poll_uploads(_perFrameDeletionQueue.deletors.size() > 0);
     _perFrameDeletionQueue.flush();
 
     if (!get_current_frame().IsValid)
@@ -161,6 +207,13 @@ void VulkanEngine::begin()
 
     VK_CHECK(vkBeginCommandBuffer(cmd, &cmdBeginInfo));
 
+#if O2GAME_PROFILER
+    if (get_current_frame()._timestampPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(cmd, get_current_frame()._timestampPool, 0, 2);
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, get_current_frame()._timestampPool, 0);
+    }
+#endif
+
     VkClearValue clearValue;
     clearValue.color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
 
@@ -191,6 +244,14 @@ void VulkanEngine::end()
     VkCommandBuffer cmd = get_current_frame()._mainCommandBuffer;
 
     vkCmdEndRenderPass(cmd);
+
+#if O2GAME_PROFILER
+    if (get_current_frame()._timestampPool != VK_NULL_HANDLE) {
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, get_current_frame()._timestampPool, 1);
+        get_current_frame()._timestampsWritten = true;
+    }
+#endif
+
     VK_CHECK(vkEndCommandBuffer(cmd));
 
     VkSubmitInfo         submit = vkinit::submit_info(&cmd);
@@ -624,73 +685,39 @@ void VulkanEngine::init_commands()
 
     VK_CHECK(vkAllocateCommandBuffers(_device, &cmdAllocInfo, &_uploadContext._commandBuffer));
 
-    const int MAX_OBJECTS = 50000;
-    _maxVertexBufferSize = sizeof(ImDrawVert) * MAX_OBJECTS;
-    _maxIndexBufferSize = sizeof(int) * MAX_OBJECTS;
-
-    {
-        VkBufferCreateInfo bufferInfo = {};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = _maxVertexBufferSize;
-        bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-        vkCreateBuffer(_device, &bufferInfo, nullptr, &_vertexBuffer);
+    VkCommandPoolCreateInfo asyncUploadPoolInfo = vkinit::command_pool_create_info(_graphicsQueueFamily);
+    VK_CHECK(vkCreateCommandPool(_device, &asyncUploadPoolInfo, nullptr, &_asyncUploadPool));
 
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(_device, _vertexBuffer, &memRequirements);
-
-        VkMemoryAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = vkTexture::FindMemoryType(
-            memRequirements.memoryTypeBits,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-        vkAllocateMemory(_device, &allocInfo, nullptr, &_vertexBufferMemory);
+    _mainDeletionQueue.push_function([=]() {
+        vkDestroyCommandPool(_device, _asyncUploadPool, nullptr);
+    });
 
-        vkBindBufferMemory(_device, _vertexBuffer, _vertexBufferMemory, 0);
-    }
+    // 65536 vertices keeps every batch addressable with 16-bit indices
+    _maxVertices = 65536 * 2;
+    _maxIndices = _maxVertices / 4 * 6;
 
-    {
-        VkBufferCreateInfo bufferInfo = {};
-        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        bufferInfo.size = _maxIndexBufferSize;
-        bufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    for (int i = 0; i < FRAME_OVERLAP; i++) {
+        auto &frame = _frames[i];
 
-        vkCreateBuffer(_device, &bufferInfo, nullptr, &_indexBuffer);
+        CreateHostBuffer(_device, sizeof(ImDrawVert) * _maxVertices, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, frame._vertexBuffer, frame._vertexBufferMemory);
+        CreateHostBuffer(_device, sizeof(uint16_t) * _maxIndices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, frame._indexBuffer, frame._indexBufferMemory);
 
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(_device, _indexBuffer, &memRequirements);
+        VK_CHECK(vkMapMemory(_device, frame._vertexBufferMemory, 0, VK_WHOLE_SIZE, 0, &frame._vertexMapped));
+        VK_CHECK(vkMapMemory(_device, frame._indexBufferMemory, 0, VK_WHOLE_SIZE, 0, &frame._indexMapped));
 
-        VkMemoryAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = vkTexture::FindMemoryType(
-            memRequirements.memoryTypeBits,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        _mainDeletionQueue.push_function([=]() {
+            vkUnmapMemory(_device, _frames[i]._vertexBufferMemory);
+            vkUnmapMemory(_device, _frames[i]._indexBufferMemory);
 
-        vkAllocateMemory(_device, &allocInfo, nullptr, &_indexBufferMemory);
+            vkDestroyBuffer(_device, _frames[i]._vertexBuffer, nullptr);
+            vkFreeMemory(_device, _frames[i]._vertexBufferMemory, nullptr);
+            vkDestroyBuffer(_device, _frames[i]._indexBuffer, nullptr);
+            vkFreeMemory(_device, _frames[i]._indexBufferMemory, nullptr);
 
-        vkBindBufferMemory(_device, _indexBuffer, _indexBufferMemory, 0);
+            _frames[i]._vertexMapped = nullptr;
+            _frames[i]._indexMapped = nullptr;
+        });
     }
-
-    _mainDeletionQueue.push_function([=]() {
-        if (_vertexBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(_device, _vertexBuffer, nullptr);
-            vkFreeMemory(_device, _vertexBufferMemory, nullptr);
-            _vertexBuffer = VK_NULL_HANDLE;
-            _vertexBufferMemory = VK_NULL_HANDLE;
-        }
-
-        if (_indexBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(_device, _indexBuffer, nullptr);
-            vkFreeMemory(_device, _indexBufferMemory, nullptr);
-            _indexBuffer = VK_NULL_HANDLE;
-            _indexBufferMemory = VK_NULL_HANDLE;
-        }
-    });
 }
 
 void VulkanEngine::init_sync_structures()
@@ -714,6 +741,25 @@ void VulkanEngine::init_sync_structures()
         });
     }
 
+#if O2GAME_PROFILER
+    if (_gpuProperties.limits.timestampComputeAndGraphics) {
+        VkQueryPoolCreateInfo queryPoolInfo = {};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = 2;
+
+        for (int i = 0; i < FRAME_OVERLAP; i++) {
+            VK_CHECK(vkCreateQueryPool(_device, &queryPoolInfo, nullptr, &_frames[i]._timestampPool));
+            _mainDeletionQueue.push_function([=]() {
+                vkDestroyQueryPool(_device, _frames[i]._timestampPool, nullptr);
+                _frames[i]._timestampPool = VK_NULL_HANDLE;
+            });
+        }
+    } else {
+        Logs::Puts("[VulkanRenderer] The gpu does not support timestamp queries, GPU frame time is unavailable");
+    }
+#endif
+
     VkFenceCreateInfo uploadFenceCreateInfo = vkinit::fence_create_info();
 
     VK_CHECK(vkCreateFence(_device, &uploadFenceCreateInfo, nullptr, &_uploadContext._uploadFence));
@@ -747,63 +793,167 @@ void VulkanEngine::immediate_submit(std::function<void(VkCommandBuffer cmd)> &&f
     vkResetCommandPool(_device, _uploadContext._commandPool, 0);
 }
 
-void VulkanEngine::queue_submit(SubmitQueueInfo info)
+void VulkanEngine::async_submit(std::function<void(VkCommandBuffer cmd)> &&function, std::function<void()> &&onComplete)
 {
-    _queueInfos.emplace_back(std::move(info));
+    if (_swapchain == VK_NULL_HANDLE) {
+        throw std::runtime_error("NO_SWAP_CHAIN");
+    }
+
+    std::lock_guard<std::mutex> lock(_uploadMutex);
+
+    PendingUpload upload = {};
+    upload.onComplete = std::move(onComplete);
+
+    VkCommandBufferAllocateInfo cmdAllocInfo = vkinit::command_buffer_allocate_info(_asyncUploadPool, 1);
+    VK_CHECK(vkAllocateCommandBuffers(_device, &cmdAllocInfo, &upload.cmd));
+
+    VkFenceCreateInfo fenceCreateInfo = vkinit::fence_create_info();
+    VK_CHECK(vkCreateFence(_device, &fenceCreateInfo, nullptr, &upload.fence));
+
+    VkCommandBufferBeginInfo cmdBeginInfo = vkinit::command_buffer_begin_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+    VK_CHECK(vkBeginCommandBuffer(upload.cmd, &cmdBeginInfo));
+
+    function(upload.cmd);
+
+    VK_CHECK(vkEndCommandBuffer(upload.cmd));
+
+    // Same queue as rendering, so the barriers recorded above already order it before any later draw
+    VkSubmitInfo submit = vkinit::submit_info(&upload.cmd);
+    VK_CHECK(vkQueueSubmit(_graphicsQueue, 1, &submit, upload.fence));
+
+    _pendingUploads.push_back(std::move(upload));
 }
 
-void VulkanEngine::flush_queue()
+void VulkanEngine::poll_uploads(bool wait)
 {
-    if (_queueInfos.size() <= 0) {
-        return;
+    std::lock_guard<std::mutex> lock(_uploadMutex);
+
+    for (auto it = _pendingUploads.begin(); it != _pendingUploads.end();) {
+        if (wait) {
+            vkWaitForFences(_device, 1, &it->fence, true, UINT64_MAX);
+        } else if (vkGetFenceStatus(_device, it->fence) != VK_SUCCESS) {
+            it++;
+            continue;
+        }
+
+        if (it->onComplete) {
+            it->onComplete();
+        }
+
+        vkDestroyFence(_device, it->fence, nullptr);
+        vkFreeCommandBuffers(_device, _asyncUploadPool, 1, &it->cmd);
+
+        it = _pendingUploads.erase(it);
     }
+}
 
-    int width, height;
-    SDL_GetWindowSize(_window, &width, &height);
+SpriteBatch *VulkanEngine::reserve_batch(uint32_t vertexCount, uint32_t indexCount, VkDescriptorSet descriptor, bool alphaBlend, const VkRect2D &scissor)
+{
+    if (_vertexCount + vertexCount > _maxVertices || _indexCount + indexCount > _maxIndices) {
+        return nullptr;
+    }
 
-    if (_swapChainOutdated || _swapchain == VK_NULL_HANDLE || width <= 0 || height <= 0 || SDL_GetWindowFlags(_window) & SDL_WINDOW_MINIMIZED) {
-        _queueInfos.clear();
+    if (_batches.size()) {
+        auto &last = _batches.back();
+
+        bool sameState = last.descriptor == descriptor && last.AlphaBlend == alphaBlend && memcmp(&last.scissor, &scissor, sizeof(VkRect2D)) == 0;
+        if (sameState && last.vertexCount + vertexCount <= 65536) {
+            return &last;
+        }
+    }
+
+    SpriteBatch batch = {};
+    batch.descriptor = descriptor;
+    batch.scissor = scissor;
+    batch.AlphaBlend = alphaBlend;
+    batch.firstIndex = _indexCount;
+    batch.vertexOffset = (int32_t)_vertexCount;
+
+    _batches.push_back(batch);
+    return &_batches.back();
+}
+
+void VulkanEngine::queue_quad(const ImDrawVert *vertices, VkDescriptorSet descriptor, bool alphaBlend, const VkRect2D &scissor)
+{
+    auto &frame = get_current_frame();
+    if (!frame._vertexMapped) {
         return;
     }
 
-    VkDeviceSize vertex_size = 0;
-    VkDeviceSize indices_size = 0;
-    for (auto &info : _queueInfos) {
-        vertex_size += info.vertices.size() * sizeof(info.vertices[0]);
-        indices_size += info.indices.size() * sizeof(info.indices[0]);
+    SpriteBatch *batch = reserve_batch(4, 6, descriptor, alphaBlend, scissor);
+    if (!batch) {
+        return;
     }
 
-    vertex_size = std::clamp((uint64_t)vertex_size, (uint64_t)0, _maxVertexBufferSize);
-    indices_size = std::clamp((uint64_t)indices_size, (uint64_t)0, _maxIndexBufferSize);
+    memcpy((ImDrawVert *)frame._vertexMapped + _vertexCount, vertices, sizeof(ImDrawVert) * 4);
 
-    void *data;
-    VK_CHECK(vkMapMemory(_device, _vertexBufferMemory, 0, vertex_size, 0, &data));
+    uint16_t  base = (uint16_t)batch->vertexCount;
+    uint16_t *indices = (uint16_t *)frame._indexMapped + _indexCount;
 
-    void *data2;
-    VK_CHECK(vkMapMemory(_device, _indexBufferMemory, 0, indices_size, 0, &data2));
+    indices[0] = base;
+    indices[1] = base + 1;
+    indices[2] = base + 2;
+    indices[3] = base;
+    indices[4] = base + 2;
+    indices[5] = base + 3;
 
-    VkDeviceSize offset = 0;
-    for (auto &info : _queueInfos) {
-        if (offset >= _maxVertexBufferSize) {
-            continue;
-        }
+    batch->vertexCount += 4;
+    batch->indexCount += 6;
+
+    _vertexCount += 4;
+    _indexCount += 6;
+}
+
+void VulkanEngine::queue_submit(const SubmitQueueInfo &info)
+{
+    auto &frame = get_current_frame();
+    if (!frame._vertexMapped || info.vertices.empty()) {
+        return;
+    }
 
-        memcpy((char *)data + offset, info.vertices.data(), info.vertices.size() * sizeof(info.vertices[0]));
-        offset += info.vertices.size() * sizeof(info.vertices[0]);
+    SpriteBatch *batch = reserve_batch((uint32_t)info.vertices.size(), (uint32_t)info.indices.size(), info.descriptor, info.AlphaBlend, info.scissor);
+    if (!batch) {
+        return;
     }
 
-    offset = 0;
-    for (auto &info : _queueInfos) {
-        memcpy((char *)data2 + offset, info.indices.data(), info.indices.size() * sizeof(info.indices[0]));
-        offset += info.indices.size() * sizeof(info.indices[0]);
+    memcpy((ImDrawVert *)frame._vertexMapped + _vertexCount, info.vertices.data(), sizeof(ImDrawVert) * info.vertices.size());
+
+    // Indices are relative to the batch, so rebase them onto the vertices already in it
+    uint16_t  base = (uint16_t)batch->vertexCount;
+    uint16_t *indices = (uint16_t *)frame._indexMapped + _indexCount;
+    for (size_t i = 0; i < info.indices.size(); i++) {
+        indices[i] = base + info.indices[i];
     }
 
-    vkUnmapMemory(_device, _vertexBufferMemory);
-    vkUnmapMemory(_device, _indexBufferMemory);
+    batch->vertexCount += (uint32_t)info.vertices.size();
+    batch->indexCount += (uint32_t)info.indices.size();
 
-    if (!get_current_frame().IsValid)
+    _vertexCount += (uint32_t)info.vertices.size();
+    _indexCount += (uint32_t)info.indices.size();
+}
+
+void VulkanEngine::flush_queue()
+{
+    PROFILE_SCOPE("VulkanEngine::flush_queue");
+
+    if (_batches.size() <= 0) {
         return;
-    auto cmd = get_current_frame()._mainCommandBuffer;
+    }
+
+    int width, height;
+    SDL_GetWindowSize(_window, &width, &height);
+
+    bool skip = _swapChainOutdated || _swapchain == VK_NULL_HANDLE || width <= 0 || height <= 0 || SDL_GetWindowFlags(_window) & SDL_WINDOW_MINIMIZED;
+    if (skip || !get_current_frame().IsValid) {
+        _batches.clear();
+        _vertexCount = 0;
+        _indexCount = 0;
+        return;
+    }
+
+    auto &frame = get_current_frame();
+    auto  cmd = frame._mainCommandBuffer;
 
     VkViewport viewport = {};
     viewport.x = 0;
@@ -815,43 +965,52 @@ void VulkanEngine::flush_queue()
     vkCmdSetViewport(cmd, 0, 1, &viewport);
 
     VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(cmd, 0, 1, &_vertexBuffer, offsets);
-    vkCmdBindIndexBuffer(cmd, _indexBuffer, 0, VK_INDEX_TYPE_UINT16);
-
-    float scale[2];
-    scale[0] = 2.0f / _windowExtent.width;
-    scale[1] = 2.0f / _windowExtent.height;
-
-    float translate[2];
-    translate[0] = -1.0f;
-    translate[1] = -1.0f;
-
-    int currentVertIndex = 0; // vertex
-    int currentIndiIndex = 0; // indicies
-
-    for (auto &info : _queueInfos) {
-        auto pipeline = _pipeline_layout;
-        auto graphics = _graphics_pipeline;
-
-        if (!info.AlphaBlend) {
-            pipeline = _pipeline_layout_non_blend;
-            graphics = _graphics_pipeline_non_blend;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &frame._vertexBuffer, offsets);
+    vkCmdBindIndexBuffer(cmd, frame._indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+
+    float constants[4];
+    constants[0] = 2.0f / _windowExtent.width; // scale
+    constants[1] = 2.0f / _windowExtent.height;
+    constants[2] = -1.0f; // translate
+    constants[3] = -1.0f;
+
+    VkPipeline      boundPipeline = VK_NULL_HANDLE;
+    VkDescriptorSet boundDescriptor = VK_NULL_HANDLE;
+    VkRect2D        boundScissor = {};
+    bool            hasScissor = false;
+
+    for (auto &batch : _batches) {
+        auto layout = batch.AlphaBlend ? _pipeline_layout : _pipeline_layout_non_blend;
+        auto graphics = batch.AlphaBlend ? _graphics_pipeline : _graphics_pipeline_non_blend;
+
+        if (graphics != boundPipeline) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics);
+            vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), constants);
+
+            boundPipeline = graphics;
+            boundDescriptor = VK_NULL_HANDLE;
         }
 
-        vkCmdPushConstants(cmd, pipeline, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(float) * 2, scale);
-        vkCmdPushConstants(cmd, pipeline, VK_SHADER_STAGE_VERTEX_BIT, sizeof(float) * 2, sizeof(float) * 2, translate);
+        if (batch.descriptor != boundDescriptor) {
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &batch.descriptor, 0, nullptr);
+            boundDescriptor = batch.descriptor;
+        }
 
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline, 0, 1, &info.descriptor, 0, nullptr);
-        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, graphics);
+        if (!hasScissor || memcmp(&batch.scissor, &boundScissor, sizeof(VkRect2D)) != 0) {
+            vkCmdSetScissor(cmd, 0, 1, &batch.scissor);
 
-        vkCmdSetScissor(cmd, 0, 1, &info.scissor);
+            boundScissor = batch.scissor;
+            hasScissor = true;
+        }
 
-        vkCmdDrawIndexed(cmd, (uint32_t)info.vertices.size(), 1, currentIndiIndex, currentVertIndex, 0);
-        currentVertIndex += (int)info.vertices.size();
-        currentIndiIndex += (int)info.indices.size();
+        vkCmdDrawIndexed(cmd, batch.indexCount, 1, batch.firstIndex, batch.vertexOffset, 0);
     }
 
-    _queueInfos.clear();
+    _lastDrawCalls = (uint32_t)_batches.size();
+
+    _batches.clear();
+    _vertexCount = 0;
+    _indexCount = 0;
 }
 
 void VulkanEngine::init_descriptors()
@@ -1,8 +1,10 @@
 #include "SceneManager.h"
 #include "Game.h"
 #include "Imgui/ImguiUtil.h"
+#include "Misc/Profiler.h"
 #include "MsgBox.h"
 #include "Overlay.h"
+#include "Rendering/Vulkan/Texture2DVulkan.h"
 #include "Scene.h"
 
 #include <Logs.h>
@@ -15,6 +17,8 @@
 static std::condition_variable m_cv;
 static bool                    m_ready_change_state = false;
 
+constexpr TimerHandle kWindowQueueBit = 1ull << 63;
+
 SceneManager::SceneManager()
 {
     m_scenes = {};
@@ -46,7 +50,14 @@ void SceneManager::Update(double delta)
             m_onSceneChange();
         }
 
-        if (!m_nextScene->Attach()) {
+        bool attached;
+        {
+            // Textures created while attaching are uploaded together instead of one blocking submit each
+            vkTexture::BatchScope batch;
+            attached = m_nextScene->Attach();
+        }
+
+        if (!attached) {
             MsgBox::ShowOut("EstEngine Error", "Failed to init next scene", MsgBoxType::OK, MsgBoxFlags::BTN_ERROR);
             m_parent->Stop();
             return;
@@ -68,22 +79,19 @@ void SceneManager::Update(double delta)
     } else {
         m_currentScene->Update(delta);
 
-        if (m_queue_render.size()) {
-            for (auto it = m_queue_render.begin(); it != m_queue_render.end();) {
-                if (it->time <= std::chrono::system_clock::now()) {
-                    it->callback();
-                    it = m_queue_render.erase(it);
-                } else {
-                    it++;
-                }
-            }
-        }
+        m_queue_update.Advance();
     }
 
     if (m_nextOverlay != nullptr) {
         // std::lock_guard<std::mutex> lock(m_mutex);
 
-        if (!m_nextOverlay->Attach()) {
+        bool attached;
+        {
+            vkTexture::BatchScope batch;
+            attached = m_nextOverlay->Attach();
+        }
+
+        if (!attached) {
             MsgBox::ShowOut("EstEngine Error", "Failed to init next overlay", MsgBoxType::OK, MsgBoxFlags::BTN_ERROR);
             m_parent->Stop();
             return;
@@ -111,6 +119,8 @@ void SceneManager::Update(double delta)
 
 void SceneManager::Render(double delta)
 {
+    PROFILE_SCOPE("SceneManager::Render");
+
     m_renderId = std::this_thread::get_id();
     m_ready_change_state = false;
 
@@ -159,16 +169,7 @@ void SceneManager::Input(double delta)
     if (m_currentScene)
         m_currentScene->Input(delta);
 
-    if (m_queue_input.size()) {
-        for (auto it = m_queue_input.begin(); it != m_queue_input.end();) {
-            if (it->time <= std::chrono::system_clock::now()) {
-                it->callback();
-                it = m_queue_input.erase(it);
-            } else {
-                it++;
-            }
-        }
-    }
+    m_queue_window.Advance();
 }
 
 void SceneManager::OnKeyDown(const KeyState &state)
@@ -311,41 +312,62 @@ void SceneManager::DisplayFade(int transparency, std::function<void()> callback)
     }).detach();
 }
 
-void SceneManager::ExecuteAfter(int ms_time, std::function<void()> callback)
+TimerHandle SceneManager::ExecuteAfter(int ms_time, std::function<void()> callback)
 {
-    QueueInfo info = {};
-    info.callback = callback;
-    info.time = std::chrono::system_clock::now() + std::chrono::milliseconds(ms_time);
+    ExecuteThread thread = std::this_thread::get_id() == s_instance->m_renderId ? ExecuteThread::UPDATE : ExecuteThread::WINDOW;
 
-    auto thread_id = std::this_thread::get_id();
-    if (thread_id == s_instance->m_renderId) {
-        s_instance->m_queue_render.push_back(std::move(info));
-    } else {
-        s_instance->m_queue_input.push_back(std::move(info));
-    }
+    return GameExecuteAfter(thread, ms_time, std::move(callback));
 }
 
-void SceneManager::GameExecuteAfter(ExecuteThread thread, int ms_time, std::function<void()> callback)
+TimerHandle SceneManager::GameExecuteAfter(ExecuteThread thread, int ms_time, std::function<void()> callback)
 {
     Game *game = s_instance->m_parent;
 
+    if (ms_time > 0) {
+        auto delay = std::chrono::milliseconds(ms_time);
+
+        // Bit 63 is never set by the wheel, it records which one to cancel from
+        switch (thread) {
+            case ExecuteThread::UPDATE:
+            {
+                return s_instance->m_queue_update.Schedule(delay, std::move(callback));
+            }
+
+            case ExecuteThread::WINDOW:
+            {
+                return s_instance->m_queue_window.Schedule(delay, std::move(callback)) | kWindowQueueBit;
+            }
+        }
+    }
+
     if (game->GetThreadMode() == ThreadMode::SINGLE_THREAD) {
-        game->GetMainThread()->QueueAction(callback);
+        game->GetMainThread()->QueueAction(std::move(callback));
     } else {
         switch (thread) {
             case ExecuteThread::UPDATE:
             {
-                game->GetRenderThread()->QueueAction(callback);
+                game->GetRenderThread()->QueueAction(std::move(callback));
                 break;
             }
 
             case ExecuteThread::WINDOW:
             {
-                game->GetMainThread()->QueueAction(callback);
+                game->GetMainThread()->QueueAction(std::move(callback));
                 break;
             }
         }
     }
+
+    return 0;
+}
+
+bool SceneManager::CancelExecute(TimerHandle handle)
+{
+    if (handle & kWindowQueueBit) {
+        return s_instance->m_queue_window.Cancel(handle & ~kWindowQueueBit);
+    }
+
+    return s_instance->m_queue_update.Cancel(handle);
 }
 
 void SceneManager::StopGame()
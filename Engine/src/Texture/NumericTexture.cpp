@@ -1,6 +1,7 @@
 #include "Texture/NumericTexture.h"
 #include "Rendering/Renderer.h"
 #include "Texture/Bitmap.h"
+#include "Texture/TextureAtlas.h"
 #include <filesystem>
 #include <stdexcept>
 
@@ -13,12 +14,16 @@ NumericTexture::NumericTexture(std::vector<std::string> numericsFiles)
     Position2 = UDim2::fromOffset(0, 0);
     AnchorPoint = { 0, 0 };
 
-    m_numericsTexture.resize(10);
-    for (int i = 0; i < 10; i++) {
-        auto path = numericsFiles[i];
-        m_numericsTexture[i] = new Texture2D(path);
-        m_numbericsWidth[i] = m_numericsTexture[i]->GetOriginalRECT();
+    std::vector<std::filesystem::path> paths;
+    for (auto file : numericsFiles) {
+        if (!std::filesystem::exists(file)) {
+            file = std::filesystem::current_path().string() + file;
+        }
+
+        paths.push_back(file);
     }
+
+    LoadAtlas(paths);
 }
 
 NumericTexture::NumericTexture(std::vector<std::filesystem::path> numericsPath)
@@ -30,12 +35,7 @@ NumericTexture::NumericTexture(std::vector<std::filesystem::path> numericsPath)
     Position2 = UDim2::fromOffset(0, 0);
     AnchorPoint = { 0, 0 };
 
-    m_numericsTexture.resize(10);
-    for (int i = 0; i < 10; i++) {
-        auto path = numericsPath[i];
-        m_numericsTexture[i] = new Texture2D(path);
-        m_numbericsWidth[i] = m_numericsTexture[i]->GetOriginalRECT();
-    }
+    LoadAtlas(numericsPath);
 }
 
 NumericTexture::~NumericTexture()
@@ -43,6 +43,31 @@ NumericTexture::~NumericTexture()
     for (auto &tex : m_numericsTexture) {
         delete tex;
     }
+
+    delete m_atlas;
+}
+
+void NumericTexture::LoadAtlas(std::vector<std::filesystem::path> &paths)
+{
+    // All ten digits share one page, a number is drawn without switching textures
+    m_atlas = new TextureAtlas();
+
+    std::vector<int> ids;
+    for (auto &path : paths) {
+        if (!std::filesystem::exists(path)) {
+            throw std::runtime_error(path.string() + " not found!");
+        }
+
+        ids.push_back(m_atlas->Add(path));
+    }
+
+    m_atlas->Build();
+
+    m_numericsTexture.resize(10);
+    for (int i = 0; i < 10; i++) {
+        m_numericsTexture[i] = m_atlas->CreateTexture(ids[i]);
+        m_numbericsWidth[i] = m_numericsTexture[i]->GetOriginalRECT();
+    }
 }
 
 void NumericTexture::DrawNumber(int number)
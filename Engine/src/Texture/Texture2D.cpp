@@ -1,5 +1,6 @@
 #include "Texture/Texture2D.h"
 #include <array>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -8,6 +9,7 @@
 #include "../Rendering/Vulkan/Texture2DVulkan_Internal.h"
 #include "Exception/SDLException.h"
 #include "Rendering/Renderer.h"
+#include "Rendering/SDLBatch.h"
 #include "Rendering/Vulkan/Texture2DVulkan.h"
 #include "Rendering/Vulkan/VulkanEngine.h"
 #include "Texture/MathUtils.h"
@@ -29,6 +31,9 @@ Texture2D::Texture2D()
 
     m_sdl_surface = nullptr;
     m_sdl_tex = nullptr;
+    m_vk_tex = nullptr;
+
+    m_uvRect = { 0.0f, 0.0f, 1.0f, 1.0f };
 
     m_bDisposeTexture = false;
 
@@ -115,6 +120,14 @@ Texture2D::Texture2D(uint8_t *fileData, size_t size) : Texture2D()
     LoadImageResources(buffer, size);
 }
 
+Texture2D::Texture2D(const uint8_t *pixels, int width, int height) : Texture2D()
+{
+    m_sdl_tex = nullptr;
+    m_vk_tex = nullptr;
+
+    LoadRawResources(pixels, width, height);
+}
+
 Texture2D::Texture2D(SDL_Texture *texture) : Texture2D()
 {
     m_bDisposeTexture = false;
@@ -221,55 +234,17 @@ void Texture2D::Draw(Rect *clipRect, bool manualDraw)
             return;
         }
 
-        ImVec2 uv1(0.0f, 0.0f); // Top-left UV coordinate
-        ImVec2 uv2(1.0f, 0.0f); // Top-right UV coordinate
-        ImVec2 uv3(1.0f, 1.0f); // Bottom-right UV coordinate
-        ImVec2 uv4(0.0f, 1.0f); // Bottom-left UV coordinate
-
         ImU32 color = IM_COL32_WHITE;
 
-        std::array<ImDrawVert, 6> vertexData;
-
-        for (int i = 0; i < 6; i++) {
-            ImDrawVert &vertex = vertexData[i];
-            switch (i) {
-                case 0:
-                    vertex.pos = ImVec2(x1, y1);
-                    vertex.uv = uv1;
-                    break;
-                case 1:
-                    vertex.pos = ImVec2(x2, y1);
-                    vertex.uv = uv2;
-                    break;
-                case 2:
-                    vertex.pos = ImVec2(x2, y2);
-                    vertex.uv = uv3;
-                    break;
-                case 3:
-                    vertex.pos = ImVec2(x1, y1);
-                    vertex.uv = uv1;
-                    break;
-                case 4:
-                    vertex.pos = ImVec2(x2, y2);
-                    vertex.uv = uv3;
-                    break;
-                case 5:
-                    vertex.pos = ImVec2(x1, y2);
-                    vertex.uv = uv4;
-                    break;
-            }
-            vertex.col = color;
-        }
-
-        SubmitQueueInfo info = {};
-        info.AlphaBlend = AlphaBlend;
-        info.descriptor = imageId;
-        info.vertices = std::vector(vertexData.begin(), vertexData.end());
-        info.indices = { 0, 1, 2, 3, 4, 5 };
-        info.scissor = scissor;
+        // Top-left, top-right, bottom-right, bottom-left
+        ImDrawVert vertices[4];
+        vertices[0] = { ImVec2(x1, y1), ImVec2(m_uvRect.left, m_uvRect.top), color };
+        vertices[1] = { ImVec2(x2, y1), ImVec2(m_uvRect.right, m_uvRect.top), color };
+        vertices[2] = { ImVec2(x2, y2), ImVec2(m_uvRect.right, m_uvRect.bottom), color };
+        vertices[3] = { ImVec2(x1, y2), ImVec2(m_uvRect.left, m_uvRect.bottom), color };
 
-        // submit to queue
-        vulkan_driver->queue_submit(info);
+        // Written straight into the frame's vertex buffer, merged with the previous draw if the state matches
+        vulkan_driver->queue_quad(vertices, imageId, AlphaBlend, scissor);
     } else {
         SDL_FRect destRect = { m_calculatedSizeF.left, m_calculatedSizeF.top, m_calculatedSizeF.right, m_calculatedSizeF.bottom };
         if (scaleOutput) {
@@ -279,61 +254,60 @@ void Texture2D::Draw(Rect *clipRect, bool manualDraw)
             destRect.h = destRect.h * window->GetHeightScale();
         }
 
-        SDL_Rect      originClip = {};
-        SDL_BlendMode oldBlendMode = SDL_BLENDMODE_NONE;
-
+        SDL_Rect clip = {};
         if (clipRect) {
-            SDL_RenderGetClipRect(renderer->GetSDLRenderer(), &originClip);
-
-            SDL_Rect testClip = { clipRect->left, clipRect->top, clipRect->right - clipRect->left, clipRect->bottom - clipRect->top };
+            clip = { clipRect->left, clipRect->top, clipRect->right - clipRect->left, clipRect->bottom - clipRect->top };
             if (scaleOutput) {
-                testClip.x = static_cast<int>(testClip.x * window->GetWidthScale());
-                testClip.y = static_cast<int>(testClip.y * window->GetHeightScale());
-                testClip.w = static_cast<int>(testClip.w * window->GetWidthScale());
-                testClip.h = static_cast<int>(testClip.h * window->GetHeightScale());
+                clip.x = static_cast<int>(clip.x * window->GetWidthScale());
+                clip.y = static_cast<int>(clip.y * window->GetHeightScale());
+                clip.w = static_cast<int>(clip.w * window->GetWidthScale());
+                clip.h = static_cast<int>(clip.h * window->GetHeightScale());
             }
-
-            SDL_RenderSetClipRect(renderer->GetSDLRenderer(), &testClip);
         }
 
-        if (AlphaBlend) {
-            SDL_GetTextureBlendMode(m_sdl_tex, &oldBlendMode);
-            SDL_SetTextureBlendMode(m_sdl_tex, renderer->GetSDLBlendMode());
+        SDL_BlendMode blendMode = renderer->GetSDLBlendMode();
+        if (!AlphaBlend) {
+            SDL_GetTextureBlendMode(m_sdl_tex, &blendMode);
         }
 
-        SDL_Color color = { (uint8_t)(TintColor.R * 255.0f), (uint8_t)(TintColor.G * 255.0f), (uint8_t)(TintColor.B * 255.0f), (uint8_t)255 };
-        if (SDL_BYTEORDER == SDL_BIG_ENDIAN) {
-            color.r = (uint8_t)(TintColor.B * 255.0f);
-            color.b = (uint8_t)(TintColor.R * 255.0f);
+        // Vertex color modulates the texture like SDL_SetTextureColorMod/AlphaMod did
+        SDL_Color color = {
+            (uint8_t)(TintColor.R * 255.0f),
+            (uint8_t)(TintColor.G * 255.0f),
+            (uint8_t)(TintColor.B * 255.0f),
+            static_cast<uint8_t>(255 - (Transparency / 100.0) * 255)
+        };
+
+        // Corners around the destination center, matching SDL_RenderCopyExF's rotation
+        float cx = destRect.x + destRect.w * 0.5f;
+        float cy = destRect.y + destRect.h * 0.5f;
+        float hw = destRect.w * 0.5f;
+        float hh = destRect.h * 0.5f;
+
+        SDL_FPoint corners[4] = { { -hw, -hh }, { hw, -hh }, { hw, hh }, { -hw, hh } };
+        if (Rotation != 0.0f) {
+            float rad = Rotation * 3.14159265f / 180.0f;
+            float s = sinf(rad);
+            float c = cosf(rad);
+
+            for (auto &corner : corners) {
+                corner = { corner.x * c - corner.y * s, corner.x * s + corner.y * c };
+            }
         }
 
-        SDL_SetTextureColorMod(m_sdl_tex, color.r, color.g, color.b);
-        SDL_SetTextureAlphaMod(m_sdl_tex, static_cast<uint8_t>(255 - (Transparency / 100.0) * 255));
-
-        int error = SDL_RenderCopyExF(
-            renderer->GetSDLRenderer(),
-            m_sdl_tex,
-            nullptr,
-            &destRect,
-            Rotation,
-            nullptr,
-            (SDL_RendererFlip)0);
-
-        if (error != 0) {
-            throw SDLException();
+        SDL_Vertex vertices[4];
+        for (int i = 0; i < 4; i++) {
+            vertices[i].position = { cx + corners[i].x, cy + corners[i].y };
+            vertices[i].color = color;
         }
 
-        if (AlphaBlend) {
-            SDL_SetTextureBlendMode(m_sdl_tex, oldBlendMode);
-        }
+        vertices[0].tex_coord = { m_uvRect.left, m_uvRect.top };
+        vertices[1].tex_coord = { m_uvRect.right, m_uvRect.top };
+        vertices[2].tex_coord = { m_uvRect.right, m_uvRect.bottom };
+        vertices[3].tex_coord = { m_uvRect.left, m_uvRect.bottom };
 
-        if (clipRect) {
-            if (originClip.w == 0 || originClip.h == 0) {
-                SDL_RenderSetClipRect(renderer->GetSDLRenderer(), nullptr);
-            } else {
-                SDL_RenderSetClipRect(renderer->GetSDLRenderer(), &originClip);
-            }
-        }
+        // Merged with the previous sprite when texture, blend and clip match, see SDLBatch
+        renderer->GetSDLBatch()->QueueQuad(m_sdl_tex, vertices, blendMode, clipRect ? &clip : nullptr);
     }
 }
 
@@ -382,6 +356,44 @@ Texture2D *Texture2D::FromTexture2D(Texture2D *tex)
     copy->Position = tex->Position;
     copy->Size = tex->Size;
 
+    copy->m_uvRect = tex->m_uvRect;
+
+    return copy;
+}
+
+Texture2D *Texture2D::FromRegion(Texture2D *page, Rect region)
+{
+    Texture2D *tex = page->m_vk_tex ? new Texture2D(page->m_vk_tex) : new Texture2D(page->m_sdl_tex);
+
+    float pageWidth = (float)page->m_actualSize.right;
+    float pageHeight = (float)page->m_actualSize.bottom;
+
+    tex->m_actualSize = { 0, 0, region.right, region.bottom };
+    tex->m_uvRect = {
+        region.left / pageWidth,
+        region.top / pageHeight,
+        (region.left + region.right) / pageWidth,
+        (region.top + region.bottom) / pageHeight
+    };
+
+    return tex;
+}
+
+Texture2D *Texture2D::FromRegion(std::shared_ptr<Texture2D> page, Rect region)
+{
+    Texture2D *tex = FromRegion(page.get(), region);
+    tex->m_shared = std::move(page);
+
+    return tex;
+}
+
+Texture2D *Texture2D::FromShared(std::shared_ptr<Texture2D> tex)
+{
+    Texture2D *copy = tex->m_vk_tex ? new Texture2D(tex->m_vk_tex) : new Texture2D(tex->m_sdl_tex);
+    copy->m_actualSize = tex->m_actualSize;
+    copy->m_uvRect = tex->m_uvRect;
+    copy->m_shared = std::move(tex);
+
     return copy;
 }
 
@@ -456,3 +468,29 @@ void Texture2D::LoadImageResources(uint8_t *buffer, size_t size)
 
     delete[] buffer;
 }
+
+void Texture2D::LoadRawResources(const uint8_t *pixels, int width, int height)
+{
+    if (Renderer::GetInstance()->IsVulkan()) {
+        auto tex_data = vkTexture::TexLoadRaw(pixels, width, height);
+
+        m_actualSize = { 0, 0, tex_data->Width, tex_data->Height };
+        m_vk_tex = tex_data;
+    } else {
+        m_sdl_tex = SDL_CreateTexture(Renderer::GetInstance()->GetSDLRenderer(), SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, width, height);
+        if (!m_sdl_tex) {
+            throw SDLException();
+        }
+
+        if (SDL_UpdateTexture(m_sdl_tex, nullptr, pixels, width * 4) != 0) {
+            throw SDLException();
+        }
+
+        SDL_SetTextureBlendMode(m_sdl_tex, SDL_BLENDMODE_BLEND);
+
+        m_actualSize = { 0, 0, width, height };
+    }
+
+    m_bDisposeTexture = true;
+    m_ready = true;
+}
@@ -0,0 +1,211 @@
+#include "Texture/TextureAtlas.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string.h>
+
+#include "../Data/stb_image.h"
+#include "Rendering/Threading/JobSystem.h"
+#include "Rendering/Vulkan/Texture2DVulkan.h"
+#include "Texture/Texture2D.h"
+#include "Texture/TextureCache.h"
+#include "Texture/TexturePack.h"
+
+// imgui_draw.cpp keeps its copy static, so this translation unit needs its own
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "Imgui/imstb_rectpack.h"
+
+TextureAtlas::TextureAtlas(int pageSize, int padding)
+{
+    m_pageSize = pageSize;
+    m_padding = padding;
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    for (auto &page : m_pages) {
+        delete page;
+    }
+}
+
+int TextureAtlas::Add(std::filesystem::path path)
+{
+    if (m_pages.size()) {
+        throw std::runtime_error("TextureAtlas::Add: atlas is already built");
+    }
+
+    // Decoded later in Build, all files at once on the job system
+    Image image = {};
+    image.Path = path;
+
+    m_images.push_back(std::move(image));
+    return (int)m_images.size() - 1;
+}
+
+void TextureAtlas::Decode()
+{
+    std::vector<std::string> errors(m_images.size());
+    auto                     pack = TextureCache::GetInstance()->GetPack();
+
+    JobSystem::GetInstance()->ParallelFor(m_images.size(), [&](size_t i) {
+        auto &image = m_images[i];
+        if (image.Path.empty()) {
+            return;
+        }
+
+        if (pack && pack->CopyPixels(image.Path, image.Pixels, image.Width, image.Height)) {
+            return;
+        }
+
+        std::fstream fs(image.Path, std::ios::binary | std::ios::in);
+        if (!fs.is_open()) {
+            errors[i] = image.Path.string() + " cannot opened!";
+            return;
+        }
+
+        fs.seekg(0, std::ios::end);
+        size_t size = fs.tellg();
+        fs.seekg(0, std::ios::beg);
+
+        std::vector<uint8_t> buffer(size);
+        fs.read((char *)buffer.data(), size);
+        fs.close();
+
+        int      channels;
+        uint8_t *pixels = stbi_load_from_memory(buffer.data(), (int)buffer.size(), &image.Width, &image.Height, &channels, 4);
+        if (pixels == nullptr) {
+            errors[i] = "Failed to load image: " + image.Path.string() + "!";
+            return;
+        }
+
+        image.Pixels.assign(pixels, pixels + (size_t)image.Width * image.Height * 4);
+        stbi_image_free(pixels);
+    });
+
+    for (auto &error : errors) {
+        if (error.size()) {
+            throw std::runtime_error(error);
+        }
+    }
+}
+
+int TextureAtlas::Add(const uint8_t *pixels, int width, int height)
+{
+    if (m_pages.size()) {
+        throw std::runtime_error("TextureAtlas::Add: atlas is already built");
+    }
+
+    Image image = {};
+    image.Width = width;
+    image.Height = height;
+    image.Pixels.assign(pixels, pixels + (size_t)width * height * 4);
+
+    m_images.push_back(std::move(image));
+    return (int)m_images.size() - 1;
+}
+
+void TextureAtlas::Build()
+{
+    Decode();
+
+    m_regions.resize(m_images.size());
+
+    std::vector<int> pending(m_images.size());
+    for (int i = 0; i < (int)pending.size(); i++) {
+        pending[i] = i;
+    }
+
+    {
+        // Every page goes up in one transfer
+        vkTexture::BatchScope batch;
+        BuildPages(pending);
+    }
+
+    m_images.clear();
+    m_images.shrink_to_fit();
+}
+
+void TextureAtlas::BuildPages(std::vector<int> &pending)
+{
+    std::vector<stbrp_node> nodes(m_pageSize);
+
+    while (pending.size()) {
+        std::vector<stbrp_rect> rects;
+        for (int id : pending) {
+            stbrp_rect rect = {};
+            rect.id = id;
+            rect.w = m_images[id].Width + m_padding;
+            rect.h = m_images[id].Height + m_padding;
+
+            rects.push_back(rect);
+        }
+
+        stbrp_context context;
+        stbrp_init_target(&context, m_pageSize, m_pageSize, nodes.data(), (int)nodes.size());
+        stbrp_pack_rects(&context, rects.data(), (int)rects.size());
+
+        int pageWidth = 0, pageHeight = 0;
+        for (auto &rect : rects) {
+            if (rect.was_packed) {
+                pageWidth = std::max(pageWidth, rect.x + rect.w);
+                pageHeight = std::max(pageHeight, rect.y + rect.h);
+            }
+        }
+
+        // Nothing fits, the first image is larger than a page so it gets one of its own
+        bool oversized = pageWidth == 0;
+        if (oversized) {
+            auto &rect = rects[0];
+            rect.x = 0;
+            rect.y = 0;
+            rect.was_packed = 1;
+
+            pageWidth = m_images[rect.id].Width;
+            pageHeight = m_images[rect.id].Height;
+        }
+
+        int                  pageIndex = (int)m_pages.size();
+        std::vector<uint8_t> pixels((size_t)pageWidth * pageHeight * 4, 0);
+
+        pending.clear();
+        for (size_t i = 0; i < rects.size(); i++) {
+            auto &rect = rects[i];
+            if (!rect.was_packed || (oversized && i > 0)) {
+                pending.push_back(rect.id);
+                continue;
+            }
+
+            auto &image = m_images[rect.id];
+            for (int y = 0; y < image.Height; y++) {
+                memcpy(
+                    pixels.data() + ((size_t)(rect.y + y) * pageWidth + rect.x) * 4,
+                    image.Pixels.data() + (size_t)y * image.Width * 4,
+                    (size_t)image.Width * 4);
+            }
+
+            m_regions[rect.id] = { pageIndex, { rect.x, rect.y, image.Width, image.Height } };
+        }
+
+        m_pages.push_back(new Texture2D(pixels.data(), pageWidth, pageHeight));
+    }
+}
+
+Texture2D *TextureAtlas::CreateTexture(int id) const
+{
+    auto &region = m_regions.at(id);
+
+    return Texture2D::FromRegion(m_pages[region.Page], region.Area);
+}
+
+Rect TextureAtlas::GetRect(int id) const
+{
+    auto &region = m_regions.at(id);
+
+    return { 0, 0, region.Area.right, region.Area.bottom };
+}
+
+int TextureAtlas::GetPageCount() const
+{
+    return (int)m_pages.size();
+}
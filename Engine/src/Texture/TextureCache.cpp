@@ -0,0 +1,258 @@
+#include "Texture/TextureCache.h"
+#include <fstream>
+#include <stdexcept>
+
+#include "../Data/stb_image.h"
+#include "Rendering/Threading/JobSystem.h"
+#include "Rendering/Vulkan/Texture2DVulkan.h"
+#include "Texture/Texture2D.h"
+#include "Texture/TexturePack.h"
+
+TextureCache *TextureCache::s_instance = nullptr;
+
+// Roughly the whole gameplay skin plus a couple of song select backgrounds
+constexpr size_t kDefaultBudget = 256 * 1024 * 1024;
+
+TextureCache::TextureCache()
+{
+    m_budget = kDefaultBudget;
+    m_usage = 0;
+    m_clock = 0;
+}
+
+TextureCache::~TextureCache()
+{
+    Clear();
+}
+
+std::string TextureCache::Key(const std::filesystem::path &path)
+{
+    std::error_code ec;
+    auto            canonical = std::filesystem::weakly_canonical(path, ec);
+
+    return ec ? path.lexically_normal().string() : canonical.string();
+}
+
+Texture2D *TextureCache::Load(std::filesystem::path path)
+{
+    if (auto pack = GetPack()) {
+        if (auto texture = pack->CreateTexture(path)) {
+            return texture;
+        }
+    }
+
+    std::error_code ec;
+    auto            modifiedTime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        throw std::runtime_error(path.string() + " not found!");
+    }
+
+    auto key = Key(path);
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto it = m_entries.find(key);
+        if (it != m_entries.end() && it->second.ModifiedTime == modifiedTime) {
+            it->second.LastUse = ++m_clock;
+            return Texture2D::FromShared(it->second.Texture);
+        }
+    }
+
+    auto texture = std::make_shared<Texture2D>(path);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    Insert(key, texture, modifiedTime);
+
+    return Texture2D::FromShared(texture);
+}
+
+void TextureCache::Preload(const std::vector<std::filesystem::path> &paths)
+{
+    struct Pending
+    {
+        std::filesystem::path           Path;
+        std::string                     Key;
+        std::filesystem::file_time_type ModifiedTime;
+
+        uint8_t *Pixels = nullptr;
+        int      Width = 0;
+        int      Height = 0;
+    };
+
+    std::vector<Pending> pending;
+    auto                 pack = GetPack();
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        for (auto &path : paths) {
+            // Already decoded in the pack, Load() uploads its page on first use
+            if (pack && pack->Contains(path)) {
+                continue;
+            }
+
+            std::error_code ec;
+            auto            modifiedTime = std::filesystem::last_write_time(path, ec);
+            if (ec) {
+                continue;
+            }
+
+            auto key = Key(path);
+            auto it = m_entries.find(key);
+            if (it != m_entries.end() && it->second.ModifiedTime == modifiedTime) {
+                continue;
+            }
+
+            Pending item = {};
+            item.Path = path;
+            item.Key = key;
+            item.ModifiedTime = modifiedTime;
+
+            pending.push_back(std::move(item));
+        }
+    }
+
+    JobSystem::GetInstance()->ParallelFor(pending.size(), [&](size_t i) {
+        auto &item = pending[i];
+
+        std::fstream fs(item.Path, std::ios::binary | std::ios::in);
+        if (!fs.is_open()) {
+            return;
+        }
+
+        fs.seekg(0, std::ios::end);
+        size_t size = fs.tellg();
+        fs.seekg(0, std::ios::beg);
+
+        std::vector<uint8_t> buffer(size);
+        fs.read((char *)buffer.data(), size);
+        fs.close();
+
+        int channels;
+        item.Pixels = stbi_load_from_memory(buffer.data(), (int)buffer.size(), &item.Width, &item.Height, &channels, 4);
+    });
+
+    vkTexture::BatchScope batch;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (auto &item : pending) {
+        // Unreadable files are skipped here, Load() reports them when they are actually used
+        if (item.Pixels == nullptr) {
+            continue;
+        }
+
+        Insert(item.Key, std::make_shared<Texture2D>(item.Pixels, item.Width, item.Height), item.ModifiedTime);
+        stbi_image_free(item.Pixels);
+    }
+}
+
+void TextureCache::Insert(const std::string &key, std::shared_ptr<Texture2D> texture, std::filesystem::file_time_type modifiedTime)
+{
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        // Holders of the stale texture keep it alive until they let go
+        m_usage -= it->second.Bytes;
+        m_entries.erase(it);
+    }
+
+    Rect size = texture->GetOriginalRECT();
+
+    Entry entry = {};
+    entry.Texture = texture;
+    entry.ModifiedTime = modifiedTime;
+    entry.Bytes = (size_t)size.right * size.bottom * 4;
+    entry.LastUse = ++m_clock;
+
+    m_usage += entry.Bytes;
+    m_entries[key] = std::move(entry);
+
+    TrimLocked();
+}
+
+void TextureCache::SetPack(std::shared_ptr<TexturePack> pack)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    m_pack = std::move(pack);
+}
+
+std::shared_ptr<TexturePack> TextureCache::GetPack()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    return m_pack;
+}
+
+void TextureCache::SetBudget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    m_budget = bytes;
+    TrimLocked();
+}
+
+size_t TextureCache::GetUsage()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    return m_usage;
+}
+
+void TextureCache::Trim()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    TrimLocked();
+}
+
+void TextureCache::TrimLocked()
+{
+    while (m_usage > m_budget) {
+        auto victim = m_entries.end();
+
+        for (auto it = m_entries.begin(); it != m_entries.end(); it++) {
+            // Still drawn somewhere, evicting it would not free anything
+            if (it->second.Texture.use_count() > 1) {
+                continue;
+            }
+
+            if (victim == m_entries.end() || it->second.LastUse < victim->second.LastUse) {
+                victim = it;
+            }
+        }
+
+        if (victim == m_entries.end()) {
+            break;
+        }
+
+        m_usage -= victim->second.Bytes;
+        m_entries.erase(victim);
+    }
+}
+
+void TextureCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    m_entries.clear();
+    m_pack.reset();
+    m_usage = 0;
+}
+
+TextureCache *TextureCache::GetInstance()
+{
+    if (s_instance == nullptr) {
+        s_instance = new TextureCache;
+    }
+
+    return s_instance;
+}
+
+void TextureCache::Release()
+{
+    if (s_instance != nullptr) {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+}
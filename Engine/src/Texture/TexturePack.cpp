@@ -0,0 +1,572 @@
+#include "Texture/TexturePack.h"
+#include <Logs.h>
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+
+#include "../Data/stb_image.h"
+#include "Rendering/Threading/JobSystem.h"
+#include "Texture/Texture2D.h"
+
+// imgui_draw.cpp keeps its copy static, so this translation unit needs its own
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "Imgui/imstb_rectpack.h"
+
+namespace {
+    const char     PACK_SIGNATURE[4] = { 'O', '2', 'P', 'K' };
+    const uint32_t PACK_VERSION = 1;
+    const size_t   PACK_ALIGNMENT = 16;
+    const int      PACK_PADDING = 1;
+
+    size_t AlignUp(size_t value)
+    {
+        return (value + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1);
+    }
+
+    bool StatSource(const std::filesystem::path &path, int64_t &modifiedTime, uint64_t &size)
+    {
+        std::error_code ec;
+        auto            time = std::filesystem::last_write_time(path, ec);
+        if (ec) {
+            return false;
+        }
+
+        size = std::filesystem::file_size(path, ec);
+        if (ec) {
+            return false;
+        }
+
+        modifiedTime = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    void PutString(std::vector<uint8_t> &out, const std::string &value)
+    {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        out.insert(out.end(), (uint8_t *)&length, (uint8_t *)&length + sizeof(length));
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    void PutCount(std::vector<uint8_t> &out, size_t count)
+    {
+        uint32_t value = static_cast<uint32_t>(count);
+        out.insert(out.end(), (uint8_t *)&value, (uint8_t *)&value + sizeof(value));
+    }
+
+    struct BlobReader
+    {
+        const uint8_t *Data;
+        size_t         Size;
+        size_t         Offset;
+
+        bool Count(uint32_t &value)
+        {
+            if (Offset + sizeof(value) > Size) {
+                return false;
+            }
+
+            memcpy(&value, Data + Offset, sizeof(value));
+            Offset += sizeof(value);
+            return true;
+        }
+
+        bool String(std::string &value)
+        {
+            uint32_t length;
+            if (!Count(length) || Offset + length > Size) {
+                return false;
+            }
+
+            value.assign((const char *)Data + Offset, length);
+            Offset += length;
+            return true;
+        }
+    };
+} // namespace
+
+TexturePack::TexturePack()
+{
+    m_pages = nullptr;
+    m_images = nullptr;
+    m_inis = nullptr;
+    m_names = nullptr;
+}
+
+TexturePack::~TexturePack()
+{
+    Close();
+}
+
+bool TexturePack::Open(std::filesystem::path file, std::filesystem::path root)
+{
+    Close();
+
+    if (!m_file.Open(file)) {
+        return false;
+    }
+
+    const uint8_t *data = m_file.Data();
+    size_t         size = m_file.Size();
+
+    Header header = {};
+    if (size < sizeof(header)) {
+        Close();
+        return false;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.Signature, PACK_SIGNATURE, sizeof(PACK_SIGNATURE)) != 0 || header.Version != PACK_VERSION) {
+        Logs::Puts("[TexturePack] %s is not a pack of version %d, ignoring it", file.string().c_str(), PACK_VERSION);
+        Close();
+        return false;
+    }
+
+    size_t tables = sizeof(Header) + header.PageCount * sizeof(Page) + header.ImageCount * sizeof(Image) + header.IniCount * sizeof(Ini);
+    if (tables > size) {
+        Close();
+        return false;
+    }
+
+    m_pages = reinterpret_cast<const Page *>(data + sizeof(Header));
+    m_images = reinterpret_cast<const Image *>(m_pages + header.PageCount);
+    m_inis = reinterpret_cast<const Ini *>(m_images + header.ImageCount);
+    m_names = reinterpret_cast<const char *>(m_inis + header.IniCount);
+
+    for (uint32_t i = 0; i < header.PageCount; i++) {
+        auto &page = m_pages[i];
+        if (page.Offset + (uint64_t)page.Width * page.Height * 4 > size) {
+            Logs::Puts("[TexturePack] %s is truncated, ignoring it", file.string().c_str());
+            Close();
+            return false;
+        }
+    }
+
+    m_root = root.lexically_normal();
+    m_uploaded.resize(header.PageCount);
+
+    size_t namesSize = size - tables;
+    auto   nameOf = [&](const Source &source) -> std::string {
+        if ((uint64_t)source.NameOffset + source.NameLength > namesSize) {
+            return {};
+        }
+
+        return std::string(m_names + source.NameOffset, source.NameLength);
+    };
+
+    int stale = 0;
+    for (uint32_t i = 0; i < header.ImageCount; i++) {
+        auto &image = m_images[i];
+        auto  name = nameOf(image.File);
+
+        bool inBounds = image.Page < header.PageCount && image.X >= 0 && image.Y >= 0 && image.X + image.Width <= (int32_t)m_pages[image.Page].Width && image.Y + image.Height <= (int32_t)m_pages[image.Page].Height;
+        if (name.empty() || !inBounds) {
+            continue;
+        }
+
+        if (!IsFresh(image.File)) {
+            stale++;
+            continue;
+        }
+
+        m_imageLookup[name] = i;
+    }
+
+    for (uint32_t i = 0; i < header.IniCount; i++) {
+        auto &ini = m_inis[i];
+        auto  name = nameOf(ini.File);
+
+        if (name.empty() || ini.DataOffset + ini.DataLength > size) {
+            continue;
+        }
+
+        if (!IsFresh(ini.File)) {
+            stale++;
+            continue;
+        }
+
+        m_iniLookup[name] = i;
+    }
+
+    if (stale > 0) {
+        Logs::Puts("[TexturePack] %d entries of %s are older than their source files and will be loaded from disk", stale, file.string().c_str());
+    }
+
+    return true;
+}
+
+void TexturePack::Close()
+{
+    {
+        // Textures handed out keep their page alive, only the pack's references go here
+        std::lock_guard<std::mutex> lock(m_uploadLock);
+        m_uploaded.clear();
+    }
+
+    m_imageLookup.clear();
+    m_iniLookup.clear();
+
+    m_pages = nullptr;
+    m_images = nullptr;
+    m_inis = nullptr;
+    m_names = nullptr;
+
+    m_file.Close();
+}
+
+bool TexturePack::IsOpen() const
+{
+    return m_file.IsOpen();
+}
+
+std::string TexturePack::Key(const std::filesystem::path &path) const
+{
+    auto relative = path.lexically_normal().lexically_relative(m_root);
+    if (relative.empty() || *relative.begin() == "..") {
+        return {};
+    }
+
+    return relative.generic_string();
+}
+
+bool TexturePack::IsFresh(const Source &source) const
+{
+    auto path = m_root / std::string(m_names + source.NameOffset, source.NameLength);
+
+    int64_t  modifiedTime;
+    uint64_t size;
+    if (!StatSource(path, modifiedTime, size)) {
+        return false;
+    }
+
+    return modifiedTime == source.ModifiedTime && size == source.Size;
+}
+
+bool TexturePack::Contains(const std::filesystem::path &path) const
+{
+    return m_imageLookup.find(Key(path)) != m_imageLookup.end();
+}
+
+Texture2D *TexturePack::CreateTexture(const std::filesystem::path &path)
+{
+    auto it = m_imageLookup.find(Key(path));
+    if (it == m_imageLookup.end()) {
+        return nullptr;
+    }
+
+    auto &image = m_images[it->second];
+
+    std::shared_ptr<Texture2D> page;
+    {
+        std::lock_guard<std::mutex> lock(m_uploadLock);
+
+        auto &uploaded = m_uploaded[image.Page];
+        if (!uploaded) {
+            // Uploaded straight from the mapping, nothing to decode
+            auto &info = m_pages[image.Page];
+            uploaded = std::make_shared<Texture2D>(m_file.Data() + info.Offset, (int)info.Width, (int)info.Height);
+        }
+
+        page = uploaded;
+    }
+
+    return Texture2D::FromRegion(std::move(page), { image.X, image.Y, image.Width, image.Height });
+}
+
+bool TexturePack::CopyPixels(const std::filesystem::path &path, std::vector<uint8_t> &pixels, int &width, int &height) const
+{
+    auto it = m_imageLookup.find(Key(path));
+    if (it == m_imageLookup.end()) {
+        return false;
+    }
+
+    auto &image = m_images[it->second];
+    auto &page = m_pages[image.Page];
+
+    width = image.Width;
+    height = image.Height;
+    pixels.resize((size_t)width * height * 4);
+
+    const uint8_t *source = m_file.Data() + page.Offset;
+    for (int y = 0; y < height; y++) {
+        memcpy(
+            pixels.data() + (size_t)y * width * 4,
+            source + ((size_t)(image.Y + y) * page.Width + image.X) * 4,
+            (size_t)width * 4);
+    }
+
+    return true;
+}
+
+bool TexturePack::ReadIni(const std::filesystem::path &path, mINI::INIStructure &ini) const
+{
+    auto it = m_iniLookup.find(Key(path));
+    if (it == m_iniLookup.end()) {
+        return false;
+    }
+
+    auto      &entry = m_inis[it->second];
+    BlobReader reader = { m_file.Data() + entry.DataOffset, (size_t)entry.DataLength, 0 };
+
+    uint32_t sectionCount;
+    if (!reader.Count(sectionCount)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < sectionCount; i++) {
+        std::string section;
+        uint32_t    keyCount;
+        if (!reader.String(section) || !reader.Count(keyCount)) {
+            return false;
+        }
+
+        auto &values = ini[section];
+        for (uint32_t j = 0; j < keyCount; j++) {
+            std::string key, value;
+            if (!reader.String(key) || !reader.String(value)) {
+                return false;
+            }
+
+            values[key] = value;
+        }
+    }
+
+    return true;
+}
+
+bool TexturePack::Write(std::filesystem::path file, std::filesystem::path root, const std::vector<std::filesystem::path> &images, const std::vector<std::filesystem::path> &inis, int pageSize)
+{
+    struct Decoded
+    {
+        std::string          Name;
+        Source               File;
+        std::vector<uint8_t> Pixels;
+        int                  Width = 0;
+        int                  Height = 0;
+        int                  Page = -1;
+        int                  X = 0, Y = 0;
+    };
+
+    root = root.lexically_normal();
+
+    std::vector<Decoded> decoded(images.size());
+    JobSystem::GetInstance()->ParallelFor(images.size(), [&](size_t i) {
+        auto &item = decoded[i];
+        auto  path = images[i].lexically_normal();
+
+        if (!StatSource(path, item.File.ModifiedTime, item.File.Size)) {
+            return;
+        }
+
+        std::fstream fs(path, std::ios::binary | std::ios::in);
+        if (!fs.is_open()) {
+            return;
+        }
+
+        std::vector<uint8_t> buffer(item.File.Size);
+        fs.read((char *)buffer.data(), buffer.size());
+        fs.close();
+
+        int      channels;
+        uint8_t *pixels = stbi_load_from_memory(buffer.data(), (int)buffer.size(), &item.Width, &item.Height, &channels, 4);
+        if (pixels == nullptr) {
+            return;
+        }
+
+        item.Name = path.lexically_relative(root).generic_string();
+        item.Pixels.assign(pixels, pixels + (size_t)item.Width * item.Height * 4);
+        stbi_image_free(pixels);
+    });
+
+    std::vector<int> pending;
+    for (int i = 0; i < (int)decoded.size(); i++) {
+        if (decoded[i].Name.empty()) {
+            Logs::Puts("[TexturePack] Skipping %s, it could not be decoded", images[i].string().c_str());
+            continue;
+        }
+
+        pending.push_back(i);
+    }
+
+    // Same packing as TextureAtlas, but the pages stay on the CPU and go into the file
+    std::vector<std::pair<Page, std::vector<uint8_t>>> pages;
+    std::vector<stbrp_node>                            nodes(pageSize);
+
+    while (pending.size()) {
+        std::vector<stbrp_rect> rects;
+        for (int id : pending) {
+            stbrp_rect rect = {};
+            rect.id = id;
+            rect.w = decoded[id].Width + PACK_PADDING * 2;
+            rect.h = decoded[id].Height + PACK_PADDING * 2;
+
+            rects.push_back(rect);
+        }
+
+        stbrp_context context;
+        stbrp_init_target(&context, pageSize, pageSize, nodes.data(), (int)nodes.size());
+        stbrp_pack_rects(&context, rects.data(), (int)rects.size());
+
+        int pageWidth = 0, pageHeight = 0;
+        for (auto &rect : rects) {
+            if (rect.was_packed) {
+                pageWidth = std::max(pageWidth, rect.x + rect.w);
+                pageHeight = std::max(pageHeight, rect.y + rect.h);
+            }
+        }
+
+        // Nothing fits, the first image is larger than a page so it gets one of its own
+        bool oversized = pageWidth == 0;
+        if (oversized) {
+            auto &rect = rects[0];
+            rect.x = 0;
+            rect.y = 0;
+            rect.was_packed = 1;
+
+            pageWidth = rect.w;
+            pageHeight = rect.h;
+        }
+
+        Page                 page = { (uint32_t)pageWidth, (uint32_t)pageHeight, 0 };
+        std::vector<uint8_t> pixels((size_t)pageWidth * pageHeight * 4, 0);
+
+        pending.clear();
+        for (size_t i = 0; i < rects.size(); i++) {
+            auto &rect = rects[i];
+            if (!rect.was_packed || (oversized && i > 0)) {
+                pending.push_back(rect.id);
+                continue;
+            }
+
+            // Edge pixels are extruded into the padding on every side, so filtering at a region border never samples a neighbour
+            auto &image = decoded[rect.id];
+            for (int y = -PACK_PADDING; y < image.Height + PACK_PADDING; y++) {
+                const uint8_t *source = image.Pixels.data() + (size_t)std::clamp(y, 0, image.Height - 1) * image.Width * 4;
+                uint8_t       *row = pixels.data() + ((size_t)(rect.y + PACK_PADDING + y) * pageWidth + rect.x) * 4;
+
+                for (int x = 0; x < PACK_PADDING; x++) {
+                    memcpy(row + (size_t)x * 4, source, 4);
+                    memcpy(row + (size_t)(PACK_PADDING + image.Width + x) * 4, source + (size_t)(image.Width - 1) * 4, 4);
+                }
+
+                memcpy(row + (size_t)PACK_PADDING * 4, source, (size_t)image.Width * 4);
+            }
+
+            image.Page = (int)pages.size();
+            image.X = rect.x + PACK_PADDING;
+            image.Y = rect.y + PACK_PADDING;
+            image.Pixels = {};
+        }
+
+        pages.push_back({ page, std::move(pixels) });
+    }
+
+    std::string          names;
+    std::vector<Image>   imageTable;
+    std::vector<Ini>     iniTable;
+    std::vector<uint8_t> iniData;
+
+    for (auto &image : decoded) {
+        if (image.Page < 0) {
+            continue;
+        }
+
+        Image entry = {};
+        entry.File = image.File;
+        entry.File.NameOffset = (uint32_t)names.size();
+        entry.File.NameLength = (uint32_t)image.Name.size();
+        entry.Page = (uint32_t)image.Page;
+        entry.X = image.X;
+        entry.Y = image.Y;
+        entry.Width = image.Width;
+        entry.Height = image.Height;
+
+        names += image.Name;
+        imageTable.push_back(entry);
+    }
+
+    for (auto &path : inis) {
+        auto normalized = path.lexically_normal();
+
+        Ini entry = {};
+        if (!StatSource(normalized, entry.File.ModifiedTime, entry.File.Size)) {
+            continue;
+        }
+
+        mINI::INIFile      f(normalized);
+        mINI::INIStructure ini;
+        if (!f.read(ini)) {
+            Logs::Puts("[TexturePack] Skipping %s, it could not be read", normalized.string().c_str());
+            continue;
+        }
+
+        auto name = normalized.lexically_relative(root).generic_string();
+
+        entry.File.NameOffset = (uint32_t)names.size();
+        entry.File.NameLength = (uint32_t)name.size();
+        entry.DataOffset = iniData.size(); // Rebased once the header size is known
+
+        PutCount(iniData, ini.size());
+        for (auto const &[section, values] : ini) {
+            PutString(iniData, section);
+            PutCount(iniData, values.size());
+
+            for (auto const &[key, value] : values) {
+                PutString(iniData, key);
+                PutString(iniData, value);
+            }
+        }
+
+        entry.DataLength = iniData.size() - entry.DataOffset;
+
+        names += name;
+        iniTable.push_back(entry);
+    }
+
+    Header header = {};
+    memcpy(header.Signature, PACK_SIGNATURE, sizeof(PACK_SIGNATURE));
+    header.Version = PACK_VERSION;
+    header.PageCount = (uint32_t)pages.size();
+    header.ImageCount = (uint32_t)imageTable.size();
+    header.IniCount = (uint32_t)iniTable.size();
+
+    size_t iniBase = sizeof(Header) + pages.size() * sizeof(Page) + imageTable.size() * sizeof(Image) + iniTable.size() * sizeof(Ini) + names.size();
+    for (auto &entry : iniTable) {
+        entry.DataOffset += iniBase;
+    }
+
+    size_t offset = AlignUp(iniBase + iniData.size());
+    for (auto &[page, pixels] : pages) {
+        page.Offset = offset;
+        offset = AlignUp(offset + pixels.size());
+    }
+
+    std::fstream fs(file, std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!fs.is_open()) {
+        Logs::Write(LogLevel::Error, "TexturePack", "Failed to open %s for writing", file.string().c_str());
+        return false;
+    }
+
+    fs.write((const char *)&header, sizeof(header));
+    for (auto &[page, pixels] : pages) {
+        fs.write((const char *)&page, sizeof(page));
+    }
+
+    fs.write((const char *)imageTable.data(), imageTable.size() * sizeof(Image));
+    fs.write((const char *)iniTable.data(), iniTable.size() * sizeof(Ini));
+    fs.write(names.data(), names.size());
+    fs.write((const char *)iniData.data(), iniData.size());
+
+    const char padding[PACK_ALIGNMENT] = {};
+    for (auto &[page, pixels] : pages) {
+        size_t position = (size_t)fs.tellp();
+        fs.write(padding, page.Offset - position);
+        fs.write((const char *)pixels.data(), pixels.size());
+    }
+
+    fs.close();
+
+    Logs::Puts("[TexturePack] Wrote %d images in %d pages and %d ini files to %s",
+               (int)imageTable.size(), (int)pages.size(), (int)iniTable.size(), file.string().c_str());
+    return !fs.fail();
+}
@@ -1,9 +1,11 @@
 #include "Rendering/Threading/GameThread.h"
+#include <chrono>
 
 GameThread::GameThread()
 {
     m_run = false;
     m_background = false;
+    m_queue_budget = 2.0;
 }
 
 GameThread::~GameThread()
@@ -18,18 +20,17 @@ void GameThread::Run(std::function<void()> callback, bool background)
     m_main_cb = callback;
     m_run = true;
     m_background = background;
+    m_thread_id.store(std::this_thread::get_id(), std::memory_order_relaxed);
 
     if (background) {
         m_thread = std::thread([&] {
+            // Published before the first tick, other threads may already be queueing actions
+            m_thread_id.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
             while (m_run) {
                 m_main_cb();
 
-                if (m_queue_cb.size()) {
-                    std::function<void()> queue_cb = m_queue_cb.back();
-                    m_queue_cb.pop_back();
-
-                    queue_cb();
-                }
+                DrainQueue();
             }
         });
     }
@@ -43,17 +44,42 @@ void GameThread::Update()
 
     m_main_cb();
 
-    if (m_queue_cb.size()) {
-        std::function<void()> queue_cb = m_queue_cb.back();
-        m_queue_cb.pop_back();
+    DrainQueue();
+}
+
+void GameThread::DrainQueue()
+{
+    auto   start = std::chrono::steady_clock::now();
+    Action action;
+
+    while (m_queue_cb.TryPop(action)) {
+        action();
+        action.Reset();
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= m_queue_budget) {
+            break;
+        }
+    }
+}
+
+void GameThread::QueueAction(Action callback)
+{
+    while (!m_queue_cb.TryPush(std::move(callback))) {
+        // Full queue, waiting on ourself would never finish so make room by running the oldest action
+        Action action;
+        if (std::this_thread::get_id() == m_thread_id.load(std::memory_order_relaxed) && m_queue_cb.TryPop(action)) {
+            action();
+            continue;
+        }
 
-        queue_cb();
+        std::this_thread::yield();
     }
 }
 
-void GameThread::QueueAction(std::function<void()> callback)
+void GameThread::SetQueueBudget(double ms)
 {
-    m_queue_cb.push_back(callback);
+    m_queue_budget = ms;
 }
 
 void GameThread::Stop()
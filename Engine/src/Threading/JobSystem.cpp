@@ -0,0 +1,434 @@
+#include "Rendering/Threading/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+
+#include <Logs.h>
+
+namespace {
+    thread_local int t_workerIndex = -1;
+
+    // Yields before a waiter parks, most waits end within a few of them
+    const int kWaitSpins = 64;
+
+    /* Takes the next entry, or with a counter the next entry belonging to it */
+    template <typename Entry>
+    bool TakeEntry(std::deque<Entry> &jobs, bool fromBack, JobCounter *counter, Entry &entry)
+    {
+        if (jobs.empty()) {
+            return false;
+        }
+
+        if (counter == nullptr) {
+            if (fromBack) {
+                entry = std::move(jobs.back());
+                jobs.pop_back();
+            } else {
+                entry = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            return true;
+        }
+
+        auto it = std::find_if(jobs.begin(), jobs.end(), [counter](const Entry &it) {
+            return it.Counter == counter;
+        });
+
+        if (it == jobs.end()) {
+            return false;
+        }
+
+        entry = std::move(*it);
+        jobs.erase(it);
+        return true;
+    }
+} // namespace
+
+JobSystem *JobSystem::s_instance = nullptr;
+
+int JobCounter::Get() const
+{
+    return m_value.load(std::memory_order_acquire);
+}
+
+bool JobCounter::IsDone() const
+{
+    return Get() == 0;
+}
+
+JobSystem::~JobSystem()
+{
+    Shutdown();
+}
+
+void JobSystem::Init(int workerCount)
+{
+    if (m_running) {
+        return;
+    }
+
+    if (workerCount <= 0) {
+        // Leave a core for the update and input threads
+        workerCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    }
+
+    m_running = true;
+
+    for (int i = 0; i < workerCount; i++) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (int i = 0; i < workerCount; i++) {
+        m_workers[i]->Thread = std::thread([this, i] {
+            WorkerLoop(i);
+        });
+    }
+
+    Logs::Puts("[JobSystem] Started with %d workers", workerCount);
+}
+
+void JobSystem::Shutdown()
+{
+    if (m_running) {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepLock);
+            m_running = false;
+        }
+        m_wake.notify_all();
+
+        for (auto &worker : m_workers) {
+            if (worker->Thread.joinable()) {
+                worker->Thread.join();
+            }
+        }
+
+        // Left in the deques, someone may still wait on their counters; anything they schedule now runs inline
+        while (TryRunOne(-1, false)) {
+        }
+    }
+
+    // Drains its queue before it exits, the workers are gone so whatever it schedules runs on the loader itself
+    StopLoader();
+
+    m_workers.clear();
+}
+
+void JobSystem::StopLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_loaderLock);
+        m_loaderStop = true;
+    }
+    m_loaderWake.notify_all();
+
+    if (m_loaderThread.joinable()) {
+        m_loaderThread.join();
+    }
+
+    // Pushed while the thread was already on its way out
+    std::deque<Entry> leftover;
+    {
+        std::lock_guard<std::mutex> lock(m_loaderLock);
+        m_loaderStop = false;
+        leftover.swap(m_loaderJobs);
+    }
+
+    for (auto &entry : leftover) {
+        Execute(entry);
+    }
+}
+
+void JobSystem::Schedule(Job job, JobCounter *counter, JobAffinity affinity)
+{
+    if (counter) {
+        counter->m_value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Push({ std::move(job), counter }, affinity);
+}
+
+void JobSystem::ScheduleAfter(JobCounter *dependency, Job job, JobCounter *counter, JobAffinity affinity)
+{
+    if (dependency) {
+        std::lock_guard<std::mutex> lock(dependency->m_lock);
+
+        if (!dependency->IsDone()) {
+            if (counter) {
+                counter->m_value.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            dependency->m_continuations.push_back({ std::move(job), counter, affinity });
+            return;
+        }
+    }
+
+    Schedule(std::move(job), counter, affinity);
+}
+
+void JobSystem::ParallelFor(size_t count, std::function<void(size_t)> fn)
+{
+    if (count == 0) {
+        return;
+    }
+
+    // One job per worker pulling indices, instead of one job per item
+    size_t batches = std::min(count, (size_t)GetWorkerCount() + 1);
+
+    std::atomic<size_t> next = 0;
+    JobCounter          counter;
+
+    for (size_t i = 1; i < batches; i++) {
+        Schedule([&] {
+            size_t index;
+            while ((index = next++) < count) {
+                fn(index);
+            }
+        },
+                 &counter);
+    }
+
+    size_t index;
+    while ((index = next++) < count) {
+        fn(index);
+    }
+
+    Wait(&counter);
+}
+
+void JobSystem::Wait(JobCounter *counter)
+{
+    bool mainThread = std::this_thread::get_id() == m_mainId.load(std::memory_order_relaxed);
+
+    // Running unrelated jobs here could re-enter locks the caller holds, or stall the update thread on a whole loader
+    int spins = 0;
+    while (!counter->IsDone()) {
+        if (TryRunOne(t_workerIndex, mainThread, counter)) {
+            spins = 0;
+            continue;
+        }
+
+        if (spins++ < kWaitSpins) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Nothing of ours is runnable, sleep until Finish signals; the timeout picks up jobs queued for the counter meanwhile
+        std::unique_lock<std::mutex> lock(counter->m_lock);
+        counter->m_done.wait_for(lock, std::chrono::milliseconds(1), [counter] {
+            return counter->IsDone();
+        });
+    }
+
+    // Make sure the last Finish call has released the counter
+    std::lock_guard<std::mutex> lock(counter->m_lock);
+}
+
+void JobSystem::PumpMainThread(double budget)
+{
+    m_mainId.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        Entry entry;
+        {
+            std::lock_guard<std::mutex> lock(m_mainLock);
+            if (m_mainJobs.empty()) {
+                break;
+            }
+
+            entry = std::move(m_mainJobs.front());
+            m_mainJobs.pop_front();
+        }
+
+        Execute(entry);
+
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= budget) {
+            break;
+        }
+    }
+}
+
+int JobSystem::GetWorkerCount() const
+{
+    return (int)m_workers.size();
+}
+
+bool JobSystem::IsWorkerThread() const
+{
+    return t_workerIndex != -1;
+}
+
+void JobSystem::WorkerLoop(int index)
+{
+    t_workerIndex = index;
+
+    while (m_running) {
+        if (TryRunOne(index, false)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepLock);
+        m_wake.wait(lock, [this] {
+            return !m_running || m_pending > 0;
+        });
+    }
+
+    t_workerIndex = -1;
+}
+
+void JobSystem::LoaderLoop()
+{
+    while (true) {
+        Entry entry;
+        {
+            std::unique_lock<std::mutex> lock(m_loaderLock);
+            m_loaderWake.wait(lock, [this] {
+                return m_loaderStop || !m_loaderJobs.empty();
+            });
+
+            if (m_loaderJobs.empty()) {
+                break;
+            }
+
+            entry = std::move(m_loaderJobs.front());
+            m_loaderJobs.pop_front();
+        }
+
+        Execute(entry);
+    }
+}
+
+void JobSystem::Push(Entry entry, JobAffinity affinity)
+{
+    if (affinity == JobAffinity::MAIN_THREAD) {
+        std::lock_guard<std::mutex> lock(m_mainLock);
+        m_mainJobs.push_back(std::move(entry));
+        return;
+    }
+
+    // Started on first use, a loader scheduled from the UI thread before Init must not run on the caller
+    if (affinity == JobAffinity::LONG_RUNNING) {
+        {
+            std::lock_guard<std::mutex> lock(m_loaderLock);
+            m_loaderJobs.push_back(std::move(entry));
+
+            if (!m_loaderThread.joinable()) {
+                m_loaderThread = std::thread([this] {
+                    LoaderLoop();
+                });
+            }
+        }
+
+        m_loaderWake.notify_one();
+        return;
+    }
+
+    // Not initialized (tools, early startup) or shutting down, nothing would ever pick it up
+    if (!m_running) {
+        Execute(entry);
+        return;
+    }
+
+    int index = t_workerIndex != -1 ? t_workerIndex : (int)(m_next++ % m_workers.size());
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->Lock);
+        m_workers[index]->Jobs.push_back(std::move(entry));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepLock);
+        m_pending++;
+    }
+    m_wake.notify_one();
+}
+
+bool JobSystem::TryRunOne(int index, bool mainThread, JobCounter *counter)
+{
+    Entry entry;
+    bool  found = false;
+
+    if (index != -1) {
+        auto                       &worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.Lock);
+
+        found = TakeEntry(worker.Jobs, true, counter, entry);
+    }
+
+    size_t count = m_workers.size();
+    for (size_t i = 1; !found && i <= count; i++) {
+        auto                       &victim = *m_workers[(index + i) % count];
+        std::lock_guard<std::mutex> lock(victim.Lock);
+
+        found = TakeEntry(victim.Jobs, false, counter, entry);
+    }
+
+    if (found) {
+        m_pending--;
+        Execute(entry);
+        return true;
+    }
+
+    if (mainThread) {
+        {
+            std::lock_guard<std::mutex> lock(m_mainLock);
+            if (!TakeEntry(m_mainJobs, false, counter, entry)) {
+                return false;
+            }
+        }
+
+        Execute(entry);
+        return true;
+    }
+
+    return false;
+}
+
+void JobSystem::Execute(Entry &entry)
+{
+    entry.Fn();
+    entry.Fn.Reset();
+
+    Finish(entry.Counter);
+}
+
+void JobSystem::Finish(JobCounter *counter)
+{
+    if (counter == nullptr) {
+        return;
+    }
+
+    // Counter usually lives on the stack of whoever waits on it, do not touch it once it is unlocked
+    std::vector<JobCounter::Continuation> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_lock);
+        if (counter->m_value.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        continuations.swap(counter->m_continuations);
+        counter->m_done.notify_all();
+    }
+
+    for (auto &continuation : continuations) {
+        // Counter was already incremented when the continuation was registered
+        Push({ std::move(continuation.Fn), continuation.Counter }, continuation.Affinity);
+    }
+}
+
+JobSystem *JobSystem::GetInstance()
+{
+    if (s_instance == nullptr) {
+        s_instance = new JobSystem;
+    }
+
+    return s_instance;
+}
+
+void JobSystem::Release()
+{
+    if (s_instance != nullptr) {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+}
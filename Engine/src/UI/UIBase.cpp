@@ -1,6 +1,7 @@
 #include <UI/UIBase.h>
 #include <Rendering/Window.h>
 #include <Rendering/Renderer.h>
+#include <Rendering/SDLBatch.h>
 #include <Rendering/Vulkan/VulkanEngine.h>
 #include <Rendering/Vulkan/Texture2DVulkan.h>
 #include <algorithm>
@@ -158,6 +159,9 @@ void UIBase::DrawVertices() {
             indices.push_back(m_indices[i]);
         }
 
+        // Keep draw order with the sprites queued before this shape
+        renderer->GetSDLBatch()->Flush();
+
         SDL_BlendMode previousBlend;
         SDL_GetRenderDrawBlendMode(renderer->GetSDLRenderer(), &previousBlend);
         SDL_SetRenderDrawBlendMode(renderer->GetSDLRenderer(), renderer->GetSDLBlendMode());
@@ -190,5 +194,6 @@ void UIBase::DrawVertices() {
 
         SDL_RenderSetClipRect(renderer->GetSDLRenderer(), nullptr);
         SDL_SetRenderDrawBlendMode(renderer->GetSDLRenderer(), previousBlend);
+        renderer->GetSDLBatch()->InvalidateState();
     }   
 }
\ No newline at end of file
@@ -47,9 +47,13 @@ Chart::Chart(Osu::Beatmap &beatmap)
     }
 
     // m_audio = beatmap.AudioFilename;
-    m_title = std::u8string(beatmap.Title.begin(), beatmap.Title.end());
+    // osu! stores metadata as UTF-8, prefer the original language fields when the chart has them
+    auto &title = beatmap.TitleUnicode.empty() ? beatmap.Title : beatmap.TitleUnicode;
+    auto &artist = beatmap.ArtistUnicode.empty() ? beatmap.Artist : beatmap.ArtistUnicode;
+
+    m_title = std::u8string(title.begin(), title.end());
     m_keyCount = (int)beatmap.CircleSize;
-    m_artist = std::u8string(beatmap.Artist.begin(), beatmap.Artist.end());
+    m_artist = std::u8string(artist.begin(), artist.end());
     m_beatmapDirectory = beatmap.CurrentDir;
 
     for (auto &event : beatmap.Events) {
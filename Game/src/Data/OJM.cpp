@@ -317,7 +317,7 @@ void OJM::LoadOJMData(std::fstream &fs, bool encrypted)
         memcpy(sample.AudioData.data(), ss.str().data(), ss.str().size());
 
         auto utf8_name = CodepageToUtf8(SampleHeader.sampleName, sizeof(SampleHeader.sampleName), "euc-kr");
-        memcpy(sample.FileName, utf8_name.c_str(), sizeof(sample.FileName));
+        memcpy(sample.FileName, utf8_name.c_str(), std::min(utf8_name.size(), sizeof(sample.FileName) - 1));
 
         delete[] buffer;
         ss.str("");
@@ -352,7 +352,7 @@ void OJM::LoadOJMData(std::fstream &fs, bool encrypted)
         memcpy(sample.AudioData.data(), buffer, SampleHeader.sampleSize);
 
         auto utf8_name = CodepageToUtf8(SampleHeader.sampleName, sizeof(SampleHeader.sampleName), "euc-kr");
-        memcpy(sample.FileName, utf8_name.c_str(), sizeof(sample.FileName));
+        memcpy(sample.FileName, utf8_name.c_str(), std::min(utf8_name.size(), sizeof(sample.FileName) - 1));
 
         Samples.push_back(sample);
         delete[] buffer;
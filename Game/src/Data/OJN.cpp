@@ -200,7 +200,7 @@ void OJN::ParseNoteData(OJN *ojn, std::map<int, std::vector<Package>> &pkg)
         ojm.Load(path);
 
         if (!ojm.IsValid()) {
-            Logs::Puts("[OJM] Failed to load OJM File: %s", path.string().c_str());
+            Logs::Write(LogLevel::Error, "OJM", "Failed to load OJM File: %s", path.string().c_str());
         }
     }
 
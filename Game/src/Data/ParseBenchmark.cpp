@@ -0,0 +1,200 @@
+#include "ParseBenchmark.hpp"
+#include "Util/TextScanner.hpp"
+#include "Util/Util.hpp"
+#include "bms.hpp"
+#include "osu.hpp"
+#include <Logs.h>
+#include <Misc/MappedFile.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Corpus
+    {
+        const char                        *Name = "";
+        char                               Delimiter = ','; // Field separator for the tokenizer comparison
+        std::vector<std::filesystem::path> Files;
+        uintmax_t                          Bytes = 0;
+    };
+
+    /* What the parsers did before TextScanner: the file copied through a stringstream, then a std::string per line and per field */
+    size_t TokenizeGetline(const std::filesystem::path &file, char delimiter)
+    {
+        std::fstream fs(file, std::ios::in);
+        if (!fs.is_open()) {
+            return 0;
+        }
+
+        std::stringstream ss;
+        ss << fs.rdbuf();
+        fs.close();
+
+        size_t fields = 0;
+        for (auto &lineraw : splitString(ss)) {
+            std::string line = lineraw;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+
+            size_t commentpos = line.find("//");
+            if (commentpos != std::string::npos) {
+                line = line.substr(0, commentpos);
+            }
+
+            line.erase(0, line.find_first_not_of(" "));
+            line.erase(line.find_last_not_of(" ") + 1);
+            if (line.empty()) {
+                continue;
+            }
+
+            fields += splitString(line, delimiter).size();
+        }
+
+        return fields;
+    }
+
+    /* Same lines and fields as TokenizeGetline, through the mapped file and TextScanner views */
+    size_t TokenizeScanner(const std::filesystem::path &file, char delimiter)
+    {
+        MappedFile mapping;
+        if (!mapping.Open(file) || mapping.Size() == 0) {
+            return 0;
+        }
+
+        std::string_view buffer(reinterpret_cast<const char *>(mapping.Data()), mapping.Size());
+        std::string_view line;
+
+        size_t fields = 0;
+        while (TextScanner::NextLine(buffer, line)) {
+            line = TextScanner::Trim(TextScanner::StripComment(line));
+
+            while (!line.empty()) {
+                TextScanner::NextToken(line, delimiter);
+                fields++;
+            }
+        }
+
+        return fields;
+    }
+
+    /* Returns the timed seconds, 0 when the corpus is empty */
+    template <typename ParseFunc>
+    double Measure(Corpus &corpus, const char *label, int iterations, ParseFunc parse)
+    {
+        if (corpus.Files.empty()) {
+            return 0;
+        }
+
+        // One untimed pass so the page cache is warm and every run reads from memory
+        size_t failed = 0;
+        for (auto &file : corpus.Files) {
+            failed += parse(file) ? 0 : 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            for (auto &file : corpus.Files) {
+                parse(file);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        double megabytes = static_cast<double>(corpus.Bytes) * iterations / (1024.0 * 1024.0);
+
+        Logs::Puts("[ParseBenchmark] %s %s: %zu files (%zu invalid), %.2f MB x %d in %.3f s, %.2f MB/s, %.3f ms/file",
+                   corpus.Name,
+                   label,
+                   corpus.Files.size(),
+                   failed,
+                   corpus.Bytes / (1024.0 * 1024.0),
+                   iterations,
+                   seconds,
+                   seconds > 0 ? megabytes / seconds : 0.0,
+                   seconds * 1000.0 / (static_cast<double>(corpus.Files.size()) * iterations));
+
+        return seconds;
+    }
+
+    /* Baseline for the parser rewrite: times the old getline tokenizing against TextScanner over the same files */
+    void CompareTokenizers(Corpus &corpus, int iterations)
+    {
+        char delimiter = corpus.Delimiter;
+
+        double getline = Measure(corpus, "getline tokenizer", iterations, [delimiter](std::filesystem::path &file) {
+            return TokenizeGetline(file, delimiter) > 0;
+        });
+
+        double scanner = Measure(corpus, "scanner tokenizer", iterations, [delimiter](std::filesystem::path &file) {
+            return TokenizeScanner(file, delimiter) > 0;
+        });
+
+        if (getline > 0 && scanner > 0) {
+            Logs::Puts("[ParseBenchmark] %s tokenizer speedup: %.1fx", corpus.Name, getline / scanner);
+        }
+    }
+} // namespace
+
+bool ParseBenchmark::Run(std::filesystem::path directory, int iterations)
+{
+    if (!std::filesystem::is_directory(directory)) {
+        Logs::Puts("[ParseBenchmark] %s is not a directory", directory.string().c_str());
+        return false;
+    }
+
+    Corpus osu;
+    osu.Name = "osu";
+    osu.Delimiter = ',';
+
+    Corpus bms;
+    bms.Name = "bms";
+    bms.Delimiter = ':';
+
+    for (auto &entry : std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+
+        auto extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+        Corpus *corpus = nullptr;
+        if (extension == ".osu") {
+            corpus = &osu;
+        } else if (extension == ".bms" || extension == ".bme" || extension == ".bml" || extension == ".bmsc") {
+            corpus = &bms;
+        }
+
+        if (corpus) {
+            corpus->Files.push_back(entry.path());
+            corpus->Bytes += entry.file_size();
+        }
+    }
+
+    if (osu.Files.empty() && bms.Files.empty()) {
+        Logs::Puts("[ParseBenchmark] No charts found in %s", directory.string().c_str());
+        return false;
+    }
+
+    iterations = std::max(iterations, 1);
+
+    CompareTokenizers(osu, iterations);
+    CompareTokenizers(bms, iterations);
+
+    Measure(osu, "parse", iterations, [](std::filesystem::path &file) {
+        Osu::Beatmap beatmap(file);
+        return beatmap.IsValid();
+    });
+
+    Measure(bms, "parse", iterations, [](std::filesystem::path &file) {
+        BMS::BMSFile beatmap;
+        beatmap.Load(file);
+        return beatmap.IsValid();
+    });
+
+    return true;
+}
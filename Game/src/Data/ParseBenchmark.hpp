@@ -0,0 +1,7 @@
+#pragma once
+#include <filesystem>
+
+namespace ParseBenchmark {
+    /* Parses every .osu and .bms/.bme/.bml/.bmsc file under the directory repeatedly and logs the throughput per format */
+    bool Run(std::filesystem::path directory, int iterations = 20);
+} // namespace ParseBenchmark
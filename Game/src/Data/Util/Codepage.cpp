@@ -0,0 +1,245 @@
+#include "Util.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iconv.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*
+ * iconv_open is far more expensive than converting a 64 byte OJN title, and
+ * the library scan converts three of them per song plus one per OJM sample.
+ * Converters are opened once per thread and encoding, and the double-byte
+ * code pages the game actually meets (EUC-KR/CP949, Shift_JIS/CP932) are
+ * decoded from a lookup table instead. The table is filled by asking iconv
+ * about every byte and byte pair once, so it matches the iconv output exactly
+ * without shipping mapping data.
+ */
+namespace {
+    constexpr uint16_t kInvalid = 0x0000;
+    constexpr uint16_t kLeadByte = 0xFFFF; // Noncharacter, never produced by a mapping
+
+    /* Single bytes live at [byte], pairs at [lead << 8 | trail]; lead bytes are >= 0x80 so they never overlap */
+    struct DecodeTable
+    {
+        std::array<uint16_t, 0x10000> Codepoints;
+    };
+
+    std::string NormalizeEncoding(const char *encoding)
+    {
+        std::string result;
+        for (const char *it = encoding; *it; it++) {
+            if (*it != '-' && *it != '_') {
+                result += static_cast<char>(::tolower(static_cast<unsigned char>(*it)));
+            }
+        }
+
+        return result;
+    }
+
+    bool IsDoubleByteEncoding(const std::string &normalized)
+    {
+        return normalized == "euckr" || normalized == "cp949" || normalized == "uhc"
+               || normalized == "shiftjis" || normalized == "sjis" || normalized == "cp932";
+    }
+
+    /* Converts one complete character, returns kInvalid when iconv rejects it or it needs more bytes */
+    uint16_t QueryCodepoint(iconv_t conv, const char *bytes, size_t length, bool &incomplete)
+    {
+        iconv(conv, nullptr, nullptr, nullptr, nullptr);
+
+        char    *inbuf = const_cast<char *>(bytes);
+        size_t   inbytesleft = length;
+        uint32_t output[2] = {};
+        char    *outbuf = reinterpret_cast<char *>(output);
+        size_t   outbytesleft = sizeof(output);
+
+        incomplete = false;
+        if (iconv(conv, &inbuf, &inbytesleft, &outbuf, &outbytesleft) == (size_t)-1) {
+            incomplete = errno == EINVAL;
+            return kInvalid;
+        }
+
+        // Anything but exactly one BMP code point can't be represented in the table
+        if (sizeof(output) - outbytesleft != sizeof(uint32_t) || output[0] == 0 || output[0] >= kLeadByte) {
+            return kInvalid;
+        }
+
+        return static_cast<uint16_t>(output[0]);
+    }
+
+    std::unique_ptr<DecodeTable> BuildTable(const char *encoding)
+    {
+        iconv_t conv = iconv_open("UTF-32LE", encoding);
+        if (conv == (iconv_t)-1) {
+            return nullptr;
+        }
+
+        auto table = std::make_unique<DecodeTable>();
+        table->Codepoints.fill(kInvalid);
+
+        for (int lead = 1; lead < 0x100; lead++) {
+            char     bytes[2] = { static_cast<char>(lead), 0 };
+            bool     incomplete = false;
+            uint16_t codepoint = QueryCodepoint(conv, bytes, 1, incomplete);
+
+            if (!incomplete) {
+                table->Codepoints[lead] = codepoint;
+                continue;
+            }
+
+            table->Codepoints[lead] = kLeadByte;
+
+            for (int trail = 1; trail < 0x100; trail++) {
+                bytes[1] = static_cast<char>(trail);
+                table->Codepoints[lead << 8 | trail] = QueryCodepoint(conv, bytes, 2, incomplete);
+            }
+        }
+
+        iconv_close(conv);
+        return table;
+    }
+
+    const DecodeTable *GetTable(const std::string &normalized, const char *encoding)
+    {
+        static std::mutex                                                    lock;
+        static std::unordered_map<std::string, std::unique_ptr<DecodeTable>> tables;
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        auto it = tables.find(normalized);
+        if (it == tables.end()) {
+            it = tables.emplace(normalized, BuildTable(encoding)).first;
+        }
+
+        return it->second.get();
+    }
+
+    struct Converter
+    {
+        iconv_t            Handle = (iconv_t)-1;
+        const DecodeTable *Table = nullptr;
+    };
+
+    /* iconv_t carries shift state and is not thread-safe, so every thread keeps its own */
+    class ConverterCache
+    {
+    public:
+        ~ConverterCache()
+        {
+            for (auto &[name, converter] : m_converters) {
+                if (converter.Handle != (iconv_t)-1) {
+                    iconv_close(converter.Handle);
+                }
+            }
+        }
+
+        Converter &Get(const char *encoding)
+        {
+            auto normalized = NormalizeEncoding(encoding);
+
+            auto it = m_converters.find(normalized);
+            if (it != m_converters.end()) {
+                return it->second;
+            }
+
+            Converter converter;
+            if (IsDoubleByteEncoding(normalized)) {
+                converter.Table = GetTable(normalized, encoding);
+            }
+
+            if (!converter.Table) {
+                converter.Handle = iconv_open("UTF-8", encoding);
+            }
+
+            return m_converters.emplace(std::move(normalized), converter).first->second;
+        }
+
+    private:
+        std::unordered_map<std::string, Converter> m_converters;
+    };
+
+    void AppendUtf8(std::u8string &result, uint16_t codepoint)
+    {
+        if (codepoint < 0x80) {
+            result += static_cast<char8_t>(codepoint);
+        } else if (codepoint < 0x800) {
+            result += static_cast<char8_t>(0xC0 | (codepoint >> 6));
+            result += static_cast<char8_t>(0x80 | (codepoint & 0x3F));
+        } else {
+            result += static_cast<char8_t>(0xE0 | (codepoint >> 12));
+            result += static_cast<char8_t>(0x80 | ((codepoint >> 6) & 0x3F));
+            result += static_cast<char8_t>(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    std::u8string DecodeWithTable(const DecodeTable &table, const uint8_t *string, size_t length)
+    {
+        std::u8string result;
+        result.reserve(length * 3 / 2);
+
+        for (size_t i = 0; i < length; i++) {
+            uint16_t codepoint = table.Codepoints[string[i]];
+
+            if (codepoint == kLeadByte) {
+                if (i + 1 >= length || string[i + 1] == 0) {
+                    break;
+                }
+
+                codepoint = table.Codepoints[string[i] << 8 | string[i + 1]];
+                i++;
+            }
+
+            // Stop at the first bad sequence and keep what was decoded, like the iconv path
+            if (codepoint == kInvalid) {
+                break;
+            }
+
+            AppendUtf8(result, codepoint);
+        }
+
+        return result;
+    }
+
+    std::u8string DecodeWithIconv(iconv_t conv, const char *string, size_t length)
+    {
+        if (length == 0) {
+            return std::u8string();
+        }
+
+        iconv(conv, nullptr, nullptr, nullptr, nullptr);
+
+        size_t            inbytesleft = length;
+        size_t            outbytesleft = length * 4;
+        char             *inbuf = const_cast<char *>(string);
+        std::vector<char> outbuf(outbytesleft, 0);
+        char             *outbufptr = outbuf.data();
+
+        // On failure whatever was converted before the bad sequence is kept
+        iconv(conv, &inbuf, &inbytesleft, &outbufptr, &outbytesleft);
+
+        return std::u8string(reinterpret_cast<const char8_t *>(outbuf.data()), outbufptr - outbuf.data());
+    }
+} // namespace
+
+std::u8string CodepageToUtf8(const char *string, size_t str_len, const char *encoding)
+{
+    thread_local ConverterCache cache;
+
+    // Chart headers are fixed-size fields, anything after the terminator is padding or garbage
+    str_len = std::find(string, string + str_len, '\0') - string;
+
+    auto &converter = cache.Get(encoding);
+    if (converter.Table) {
+        return DecodeWithTable(*converter.Table, reinterpret_cast<const uint8_t *>(string), str_len);
+    }
+
+    if (converter.Handle == (iconv_t)-1) {
+        return u8"<encoding error>";
+    }
+
+    return DecodeWithIconv(converter.Handle, string, str_len);
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <charconv>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+/*
+ * Non-allocating helpers for the chart text parsers, everything works on
+ * views into the (memory mapped) source buffer.
+ */
+namespace TextScanner {
+    inline std::string_view SkipBOM(std::string_view text)
+    {
+        if (text.size() >= 3 && text.substr(0, 3) == "\xEF\xBB\xBF") {
+            text.remove_prefix(3);
+        }
+
+        return text;
+    }
+
+    /* Splits the next line off the buffer, the LF or CRLF terminator is dropped */
+    inline bool NextLine(std::string_view &buffer, std::string_view &line)
+    {
+        if (buffer.empty()) {
+            return false;
+        }
+
+        size_t pos = buffer.find('\n');
+        if (pos == std::string_view::npos) {
+            line = buffer;
+            buffer = {};
+        } else {
+            line = buffer.substr(0, pos);
+            buffer.remove_prefix(pos + 1);
+        }
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        return true;
+    }
+
+    /* Splits the next field off the text, the delimiter is consumed */
+    inline std::string_view NextToken(std::string_view &text, char delimiter)
+    {
+        size_t           pos = text.find(delimiter);
+        std::string_view token = text.substr(0, pos);
+
+        text.remove_prefix(pos != std::string_view::npos ? pos + 1 : text.size());
+        return token;
+    }
+
+    inline std::string_view Trim(std::string_view text)
+    {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+            text.remove_prefix(1);
+        }
+
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+            text.remove_suffix(1);
+        }
+
+        return text;
+    }
+
+    inline std::string_view StripComment(std::string_view text)
+    {
+        return text.substr(0, text.find("//"));
+    }
+
+    /* Parses the leading number like std::stoi/std::stof do, trailing garbage is ignored */
+    template <typename T>
+    inline bool Parse(std::string_view text, T &value)
+    {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+            text.remove_prefix(1);
+        }
+
+        if (!text.empty() && text.front() == '+') {
+            text.remove_prefix(1);
+        }
+
+        const char *first = text.data();
+        const char *last = text.data() + text.size();
+
+        if constexpr (std::is_floating_point_v<T>) {
+            // Chart numbers are mostly integers, the integer parser is several times cheaper than the float one
+            long long integer = 0;
+            auto      result = std::from_chars(first, last, integer);
+            if (result.ec == std::errc() && (result.ptr == last || (*result.ptr != '.' && *result.ptr != 'e' && *result.ptr != 'E')) && integer > -(1ll << 53) && integer < (1ll << 53)) {
+                value = static_cast<T>(integer);
+                return true;
+            }
+        }
+
+        auto result = std::from_chars(first, last, value);
+        return result.ec == std::errc();
+    }
+
+    inline bool ParseHex(std::string_view text, int &value)
+    {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+        return result.ec == std::errc();
+    }
+
+    /* Case-insensitive base 36 digit, -1 when the character is not one */
+    inline int Base36Digit(char c)
+    {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+
+        if (c >= 'A' && c <= 'Z') {
+            return c - 'A' + 10;
+        }
+
+        if (c >= 'a' && c <= 'z') {
+            return c - 'a' + 10;
+        }
+
+        return -1;
+    }
+
+    /* Decodes a one or two digit base 36 value, -1 when it contains anything else */
+    inline int Base36Pair(std::string_view text)
+    {
+        int value = 0;
+        for (char c : text) {
+            int digit = Base36Digit(c);
+            if (digit < 0) {
+                return -1;
+            }
+
+            value = value * 36 + digit;
+        }
+
+        return text.empty() ? -1 : value;
+    }
+
+    /* ASCII case-insensitive, the prefix must be upper case */
+    inline bool IStartsWith(std::string_view text, std::string_view prefix)
+    {
+        if (text.size() < prefix.size()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < prefix.size(); i++) {
+            char c = text[i];
+            if (c >= 'a' && c <= 'z') {
+                c -= 'a' - 'A';
+            }
+
+            if (c != prefix[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+} // namespace TextScanner
@@ -42,4 +42,5 @@ T FindValue(std::vector<T2> vec, Predicate func) {
 	return T();
 }
 
+/* Converts up to len bytes or the first NUL, stopping at the first invalid sequence; converters are cached per thread */
 std::u8string CodepageToUtf8(const char* string, size_t len, const char* encoding);
\ No newline at end of file
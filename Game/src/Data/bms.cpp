@@ -1,11 +1,11 @@
 #include "bms.hpp"
-#include "Util/Util.hpp"
+#include "Util/TextScanner.hpp"
 #include <Logs.h>
+#include <Misc/MappedFile.h>
+#include <algorithm>
+#include <cctype>
 #include <filesystem>
-#include <fstream>
-#include <iostream>
 #include <numeric>
-#include <sstream>
 #include <string>
 
 constexpr double EPSILON = 0.0001;
@@ -14,6 +14,7 @@ namespace BMS {
     BMSFile::BMSFile()
     {
         m_lnType = 0;
+        m_sampleLookup.fill(-1);
     }
 
     BMSFile::~BMSFile()
@@ -22,20 +23,14 @@ namespace BMS {
 
     void BMSFile::Load(std::filesystem::path &path)
     {
-        std::fstream fs(path, std::ios::in);
-        if (!fs.is_open()) {
+        MappedFile mapping;
+        if (!mapping.Open(path)) {
             return;
         }
 
-        fs.imbue(std::locale{ ".932" });
         CurrentDir = std::filesystem::path(path).parent_path();
 
-        std::stringstream ss;
-        ss << fs.rdbuf();
-        fs.close();
-
-        auto lines = splitString(ss);
-        CompileData(lines);
+        CompileData(std::string_view(reinterpret_cast<const char *>(mapping.Data()), mapping.Size()));
         CompileNoteData();
         VerifyNote();
 
@@ -47,219 +42,205 @@ namespace BMS {
         return m_valid;
     }
 
-    void BMSFile::CompileData(std::vector<std::string> &lines)
+    void BMSFile::CompileData(std::string_view buffer)
     {
         m_events = {};
+        m_events.reserve(buffer.size() / 4);
 
-        for (std::string line : lines) {
-            if (line.starts_with("#")) {
-                line = removeComment(line);
-
-                auto        data = splitString(line, ' ');
-                std::string command = data[0];
-                std::transform(command.begin(), command.end(), command.begin(), ::toupper);
-
-                if (command.starts_with("PLAYER")) {
-                    try {
-                        if (data.size() == 2) {
-                            switch (std::atoi(data[1].c_str())) {
-                                case 1:
-                                {
-                                    break;
-                                }
-
-                                default:
-                                {
-                                    ::printf("[BMS] [WARNING] Unsupported #PLAYER file, some notes might not able to load it\n");
-                                    break;
-                                }
-                            }
-                        }
-                    } catch (const std::invalid_argument &) {
-                        ::printf("[BMS] [ERROR] Failed to parse #PLAYER, the notes might not able correctly load\n");
-                    }
+        std::string_view lineraw;
+        buffer = TextScanner::SkipBOM(buffer);
 
-                    continue;
-                }
+        while (TextScanner::NextLine(buffer, lineraw)) {
+            if (!lineraw.starts_with("#")) {
+                continue;
+            }
 
-                if (command.starts_with("TITLE")) {
-                    Title = mergeVectorWith(data, 1);
-                    continue;
+            std::string_view line = TextScanner::StripComment(lineraw.substr(1));
+            std::string_view value = line;
+            std::string_view command = TextScanner::NextToken(value, ' ');
+            value = TextScanner::Trim(value);
+
+            if (TextScanner::IStartsWith(command, "PLAYER")) {
+                int player = 0;
+                if (!value.empty() && !TextScanner::Parse(value, player)) {
+                    ::printf("[BMS] [ERROR] Failed to parse #PLAYER, the notes might not able correctly load\n");
+                } else if (!value.empty() && player != 1) {
+                    ::printf("[BMS] [WARNING] Unsupported #PLAYER file, some notes might not able to load it\n");
                 }
 
-                if (command.starts_with("ARTIST")) {
-                    Artist = mergeVectorWith(data, 1);
-                    continue;
-                }
+                continue;
+            }
 
-                if (command.starts_with("STAGEFILE")) {
-                    StageFile = mergeVectorWith(data, 1);
-                    continue;
-                }
+            if (TextScanner::IStartsWith(command, "TITLE")) {
+                Title = std::string(value);
+                continue;
+            }
 
-                if (command.starts_with("BPM") && command.size() == 3) {
-                    BPM = (float)std::atof(mergeVector(data, 1).c_str());
-                    continue;
-                }
+            if (TextScanner::IStartsWith(command, "ARTIST")) {
+                Artist = std::string(value);
+                continue;
+            }
 
-                // WAVS, BPM and STOP parsing
-                if (command.starts_with("WAV") && command.size() == 5) {
-                    std::string index = command.substr(3, 2);
-                    std::string file = mergeVectorWith(data, 1);
+            if (TextScanner::IStartsWith(command, "STAGEFILE")) {
+                StageFile = std::string(value);
+                continue;
+            }
 
-                    m_wavs.push_back({ index, file });
-                    continue;
-                }
+            if (TextScanner::IStartsWith(command, "BPM") && command.size() == 3) {
+                TextScanner::Parse(value, BPM);
+                continue;
+            }
 
-                if (command.starts_with("BPM") && command.size() == 5) {
-                    std::string index = command.substr(3, 2);
-                    double      bpm = std::atof(mergeVector(data, 1).c_str());
+            // WAVS, BPM and STOP parsing
+            if (TextScanner::IStartsWith(command, "WAV") && command.size() == 5) {
+                m_wavs.push_back({ TextScanner::Base36Pair(command.substr(3, 2)), std::string(value) });
+                continue;
+            }
 
-                    m_bpms[index] = bpm;
-                    continue;
-                }
+            if (TextScanner::IStartsWith(command, "BPM") && command.size() == 5) {
+                double bpm = 0;
+                TextScanner::Parse(value, bpm);
 
-                if (command.starts_with("STOP")) {
-                    std::string index = command.substr(4, 2);
-                    double      duration = std::atof(mergeVector(data, 1).c_str());
+                m_bpms[TextScanner::Base36Pair(command.substr(3, 2))] = bpm;
+                continue;
+            }
 
-                    m_stops[index] = duration;
-                    continue;
-                }
+            if (TextScanner::IStartsWith(command, "STOP")) {
+                double duration = 0;
+                TextScanner::Parse(value, duration);
 
-                if (command.starts_with("LNTYPE")) {
-                    m_lnType = std::atoi(data[1].c_str());
-                }
+                m_stops[TextScanner::Base36Pair(command.substr(4, 2))] = duration;
+                continue;
+            }
 
-                if (command.starts_with("LNOBJ")) {
-                    m_lnObj = data[1];
-                }
+            if (TextScanner::IStartsWith(command, "LNTYPE")) {
+                TextScanner::Parse(value, m_lnType);
+                continue;
+            }
 
-                // FIELD DATA parsing
-                data = splitString(line, ':');
-                if (data.size() == 2 && isdigit(data[0][0])) {
-                    int measure = std::atoi(data[0].substr(0, 3).c_str());
-                    int channel = std::atoi(data[0].substr(3, 2).c_str());
+            if (TextScanner::IStartsWith(command, "LNOBJ")) {
+                m_lnObj = std::string(TextScanner::NextToken(value, ' '));
+                continue;
+            }
 
-                    if (channel == 0) {
-                        continue;
-                    }
+            // FIELD DATA parsing, #mmmcc:data
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos || colon == 0 || !isdigit(static_cast<unsigned char>(line[0]))) {
+                continue;
+            }
 
-                    switch (channel) {
-                        case 2:
-                        {
-                            BMSEvent ev = {};
-                            ev.Channel = channel;
-                            ev.Measure = measure;
-                            ev.Value = std::atof(data[1].c_str());
-                            ev.Position = 0;
-
-                            m_events.push_back(ev);
-                            break;
-                        }
+            std::string_view header = line.substr(0, colon);
+            std::string_view data = TextScanner::Trim(line.substr(colon + 1));
+            if (data.empty() || data.find(':') != std::string_view::npos) {
+                continue;
+            }
 
-                        case 3:
-                        {
-                            for (int i = 0; i < data[1].size(); i += 2) {
-                                std::string value = data[1].substr(i, 2);
-                                double      position = (static_cast<double>(i) / 2.0) / (data[1].size() / 2.0);
-
-                                if (value == "00")
-                                    continue;
-
-                                BMSEvent ev = {};
-                                ev.Channel = channel;
-                                ev.Measure = measure;
-                                ev.Position = position;
-
-                                try {
-                                    ev.Value = std::stoi(value, nullptr, 16);
-                                } catch (const std::invalid_argument &) {
-                                    ::printf("[BMS] [ERROR] Failed to parse BPM, undefined behavior may occured!");
-                                    continue;
-                                }
-
-                                m_events.push_back(ev);
-                            }
-                            break;
-                        }
+            int measure = 0, channel = 0;
+            TextScanner::Parse(header.substr(0, 3), measure);
+            if (header.size() > 3) {
+                TextScanner::Parse(header.substr(3, 2), channel);
+            }
 
-                        case 8:
-                        {
-                            for (int i = 0; i < data[1].size(); i += 2) {
-                                std::string value = data[1].substr(i, 2);
-                                double      position = (static_cast<double>(i) / 2.0) / (data[1].size() / 2.0);
-
-                                if (value == "00")
-                                    continue;
-
-                                if (m_bpms.find(value) != m_bpms.end()) {
-                                    BMSEvent ev = {};
-                                    ev.Channel = channel;
-                                    ev.Measure = measure;
-                                    ev.Position = position;
-                                    ev.Value = m_bpms[value];
-
-                                    m_events.push_back(ev);
-                                }
-                            }
-                            break;
-                        }
+            if (channel == 0) {
+                continue;
+            }
 
-                        case 9:
-                        {
-                            for (int i = 0; i < data[1].size(); i += 2) {
-                                std::string value = data[1].substr(i, 2);
-                                double      position = (static_cast<double>(i) / 2.0) / (data[1].size() / 2.0);
-
-                                if (value == "00")
-                                    continue;
-
-                                if (m_stops.find(value) != m_stops.end()) {
-                                    BMSEvent ev = {};
-                                    ev.Channel = channel;
-                                    ev.Measure = measure;
-                                    ev.Position = position;
-                                    ev.Value = m_stops[value];
-
-                                    m_events.push_back(ev);
-                                }
-                            }
-                            break;
-                        }
+            CompileFieldData(measure, channel, data);
+        }
+
+        // First definition wins when a chart defines the same index twice
+        m_sampleLookup.fill(-1);
+        for (int i = 0; i < m_wavs.size(); i++) {
+            int index = m_wavs[i].first;
+            if (index >= 0 && m_sampleLookup[index] == -1) {
+                m_sampleLookup[index] = i;
+            }
+        }
+    }
+
+    void BMSFile::CompileFieldData(int measure, int channel, std::string_view data)
+    {
+        // Time signature is a single decimal number, not a list of pairs
+        if (channel == 2) {
+            BMSEvent ev = {};
+            ev.Channel = channel;
+            ev.Measure = measure;
+            ev.Position = 0;
+            TextScanner::Parse(data, ev.Value);
+
+            m_events.push_back(ev);
+            return;
+        }
 
-                        default:
-                        {
-                            for (int i = 0; i < data[1].size(); i += 2) {
-                                std::string value = data[1].substr(i, 2);
-                                double      position = (static_cast<double>(i) / 2.0) / (data[1].size() / 2.0);
+        for (size_t i = 0; i < data.size(); i += 2) {
+            std::string_view value = data.substr(i, 2);
+            double           position = (static_cast<double>(i) / 2.0) / (data.size() / 2.0);
 
-                                if (value == "00")
-                                    continue;
+            if (value == "00") {
+                continue;
+            }
 
-                                BMSEvent ev = {};
-                                ev.Channel = channel;
-                                ev.Measure = measure;
-                                ev.Position = position;
-                                ev.Value = static_cast<double>(Base36_Decode(value));
+            BMSEvent ev = {};
+            ev.Channel = channel;
+            ev.Measure = measure;
+            ev.Position = position;
 
-                                m_events.push_back(ev);
-                            }
-                            break;
-                        }
+            switch (channel) {
+                case 3:
+                {
+                    int bpm = 0;
+                    if (!TextScanner::ParseHex(value, bpm)) {
+                        ::printf("[BMS] [ERROR] Failed to parse BPM, undefined behavior may occured!");
+                        continue;
+                    }
+
+                    ev.Value = bpm;
+                    break;
+                }
+
+                case 8:
+                {
+                    auto it = m_bpms.find(TextScanner::Base36Pair(value));
+                    if (it == m_bpms.end()) {
+                        continue;
+                    }
+
+                    ev.Value = it->second;
+                    break;
+                }
+
+                case 9:
+                {
+                    auto it = m_stops.find(TextScanner::Base36Pair(value));
+                    if (it == m_stops.end()) {
+                        continue;
                     }
 
-                    continue;
+                    ev.Value = it->second;
+                    break;
+                }
+
+                default:
+                {
+                    int index = TextScanner::Base36Pair(value);
+                    if (index < 0) {
+                        continue;
+                    }
+
+                    ev.Value = static_cast<double>(index);
+                    break;
                 }
             }
+
+            m_events.push_back(ev);
         }
     }
 
     void BMSFile::CompileNoteData()
     {
-        const std::vector<int> PlayfieldChannel = { 11, 12, 13, 14, 15, 18, 19 };
-        const std::vector<int> PlayfieldHoldChannel = { 51, 52, 53, 54, 55, 58, 59 };
-        const std::vector<int> ScratchChannel = { 16, 56 };
+        static const std::vector<int> PlayfieldChannel = { 11, 12, 13, 14, 15, 18, 19 };
+        static const std::vector<int> PlayfieldHoldChannel = { 51, 52, 53, 54, 55, 58, 59 };
+        static const std::vector<int> ScratchChannel = { 16, 56 };
 
         constexpr auto IsExist = [](const std::vector<int> &vec, int value, int *index) {
             auto it = std::find(vec.begin(), vec.end(), value);
@@ -272,6 +253,7 @@ namespace BMS {
         };
 
         Measures.push_back(0);
+        Notes.reserve(m_events.size());
 
         BMSTiming startTiming = {};
         startTiming.StartTime = 0;
@@ -325,7 +307,7 @@ namespace BMS {
                 case 1:
                 { // BGM
                     BMSAutoSample sample = {};
-                    sample.SampleIndex = GetSampleIndex(Base36_Encode(static_cast<int>(event.Value)));
+                    sample.SampleIndex = GetSampleIndex(static_cast<int>(event.Value));
                     sample.StartTime = timer;
 
                     AutoSamples.push_back(sample);
@@ -382,7 +364,7 @@ namespace BMS {
                         note.StartTime = timer;
                         note.EndTime = -1;
                         note.Lane = laneIndex;
-                        note.SampleIndex = GetSampleIndex(Base36_Encode(static_cast<int>(event.Value)));
+                        note.SampleIndex = GetSampleIndex(static_cast<int>(event.Value));
 
                         Notes.push_back(note);
                         break;
@@ -396,7 +378,7 @@ namespace BMS {
                             note.StartTime = holdNotes[laneIndex];
                             note.EndTime = timer;
                             note.Lane = laneIndex;
-                            note.SampleIndex = GetSampleIndex(Base36_Encode(static_cast<int>(event.Value)));
+                            note.SampleIndex = GetSampleIndex(static_cast<int>(event.Value));
 
                             holdNotes[laneIndex] = -1;
                             Notes.push_back(note);
@@ -407,7 +389,7 @@ namespace BMS {
 
                     if (IsExist(ScratchChannel, event.Channel, &laneIndex)) {
                         BMSAutoSample sample = {};
-                        sample.SampleIndex = GetSampleIndex(Base36_Encode(static_cast<int>(event.Value)));
+                        sample.SampleIndex = GetSampleIndex(static_cast<int>(event.Value));
                         sample.StartTime = timer;
 
                         if (sample.SampleIndex != -1) {
@@ -462,14 +444,13 @@ namespace BMS {
             Samples[i] = wav.second;
         }
     }
-    int BMSFile::GetSampleIndex(std::string msg)
+
+    int BMSFile::GetSampleIndex(int value)
     {
-        for (int i = 0; i < m_wavs.size(); i++) {
-            if (m_wavs[i].first == msg) {
-                return i;
-            }
+        if (value <= 0 || value >= static_cast<int>(m_sampleLookup.size())) {
+            return -1;
         }
 
-        return -1;
+        return m_sampleLookup[value];
     }
 } // namespace BMS
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
+#include <array>
 #include <filesystem>
 #include <map>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -73,19 +75,21 @@ namespace BMS {
         std::map<int, std::string> Samples;
 
     private:
-        void CompileData(std::vector<std::string> &lines);
+        void CompileData(std::string_view buffer);
+        void CompileFieldData(int measure, int channel, std::string_view data);
         void CompileNoteData();
         void VerifyNote();
-        int  GetSampleIndex(std::string msg);
+        int  GetSampleIndex(int value);
 
         bool        m_valid = false;
         std::string m_lnObj;
         int         m_lnType;
 
-        std::map<int, std::vector<BMSNote>>              m_perLaneNotes;
-        std::vector<std::pair<std::string, std::string>> m_wavs;
-        std::unordered_map<std::string, double>          m_bpms;
-        std::unordered_map<std::string, double>          m_stops;
-        std::vector<BMSEvent>                            m_events;
+        std::map<int, std::vector<BMSNote>>      m_perLaneNotes;
+        std::vector<std::pair<int, std::string>> m_wavs; // Base 36 index, -1 when the index is malformed
+        std::array<int, 36 * 36>                 m_sampleLookup;
+        std::unordered_map<int, double>          m_bpms;
+        std::unordered_map<int, double>          m_stops;
+        std::vector<BMSEvent>                    m_events;
     };
 } // namespace BMS
\ No newline at end of file
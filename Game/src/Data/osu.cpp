@@ -1,285 +1,353 @@
 #include "osu.hpp"
+#include "Util/TextScanner.hpp"
 #include <Logs.h>
+#include <Misc/MappedFile.h>
+#include <algorithm>
 #include <filesystem>
-#include <fstream>
-#include <sstream>
+
+namespace {
+    enum class Section {
+        None,
+        General,
+        Editor,
+        Metadata,
+        Difficulty,
+        Events,
+        TimingPoints,
+        Colours,
+        HitObjects,
+        Unknown
+    };
+
+    Section GetSection(std::string_view name)
+    {
+        switch (name.empty() ? '\0' : name.front()) {
+            case 'G':
+                return name == "General" ? Section::General : Section::Unknown;
+
+            case 'E':
+                if (name == "Events") {
+                    return Section::Events;
+                }
+
+                return name == "Editor" ? Section::Editor : Section::Unknown;
+
+            case 'M':
+                return name == "Metadata" ? Section::Metadata : Section::Unknown;
+
+            case 'D':
+                return name == "Difficulty" ? Section::Difficulty : Section::Unknown;
+
+            case 'T':
+                return name == "TimingPoints" ? Section::TimingPoints : Section::Unknown;
+
+            case 'C':
+                return name == "Colours" ? Section::Colours : Section::Unknown;
+
+            case 'H':
+                return name == "HitObjects" ? Section::HitObjects : Section::Unknown;
+        }
+
+        return Section::Unknown;
+    }
+
+    // Splits up to N fields off the line, returns how many were found
+    template <size_t N>
+    size_t SplitFields(std::string_view line, char delimiter, std::string_view (&fields)[N])
+    {
+        size_t count = 0;
+        while (!line.empty() && count < N) {
+            fields[count++] = TextScanner::NextToken(line, delimiter);
+        }
+
+        return count;
+    }
+} // namespace
 
 Osu::Beatmap::Beatmap(std::filesystem::path &file)
 {
-    std::fstream      fs(file, std::ios::in);
-    std::stringstream ss;
-
-    ss << fs.rdbuf();
-    fs.close();
+    bIsValid = false;
 
     // get directory info
     CurrentDir = file.parent_path();
-    ParseString(ss);
+
+    MappedFile mapping;
+    if (!mapping.Open(file)) {
+        Logs::Write(LogLevel::Error, "osu", "Failed to open %s", file.string().c_str());
+        return;
+    }
+
+    Parse(std::string_view(reinterpret_cast<const char *>(mapping.Data()), mapping.Size()));
 }
 
-void Osu::Beatmap::ParseString(std::stringstream &ss)
+void Osu::Beatmap::Parse(std::string_view buffer)
 {
-    std::string lineraw;
-    std::string currentSection;
+    Section          section = Section::None;
+    std::string_view lineraw;
 
-    while (std::getline(ss, lineraw)) {
+    buffer = TextScanner::SkipBOM(buffer);
+
+    while (TextScanner::NextLine(buffer, lineraw)) {
         if (lineraw.empty() || lineraw.starts_with("//") || lineraw.starts_with(" ") || lineraw.starts_with("_")) {
             continue;
         }
 
-        std::string line;
-        {
-            // remove comment from line
-            size_t commentpos = lineraw.find("//");
-            if (commentpos != std::string::npos) {
-                line = lineraw.substr(0, commentpos);
-            } else {
-                line = lineraw;
-            }
-
-            // trim line
-            line.erase(0, line.find_first_not_of(" "));
-            line.erase(line.find_last_not_of(" ") + 1);
-        }
-
-        if (line.starts_with("osu file format")) {
-            PeppyFormat = line.substr(line.find("v") + 1);
+        std::string_view line = TextScanner::Trim(TextScanner::StripComment(lineraw));
+        if (line.empty()) {
             continue;
         }
 
-        if (line.starts_with("[") && line.ends_with("]")) {
-            currentSection = line.substr(1, line.length() - 2);
-            continue;
-        }
+        if (line.front() == '[' && line.back() == ']') {
+            section = GetSection(line.substr(1, line.size() - 2));
 
-        if (currentSection == "General") {
-            if (line.starts_with("AudioFilename")) {
-                AudioFilename = line.substr(line.find(":") + 1);
-                AudioFilename.erase(0, AudioFilename.find_first_not_of(" "));
-            } else if (line.starts_with("AudioLeadIn")) {
-                AudioLeadIn = std::stoi(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("PreviewTime")) {
-                PreviewTime = std::stoi(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("Countdown")) {
-                Countdown = std::stoi(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("SampleSet")) {
-                SampleSet = line.substr(line.find(":") + 1);
-            } else if (line.starts_with("StackLeniency")) {
-                StackLeniency = std::stof(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("Mode")) {
-                Mode = std::stoi(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("LetterboxInBreaks")) {
-                LetterboxInBreaks = line.substr(line.find(":") + 1) == "1";
-            } else if (line.starts_with("WidescreenStoryboard")) {
-                WidescreenStoryboard = line.substr(line.find(":") + 1) == "1";
-            } else if (line.starts_with("SpecialStyle")) {
-                SpecialStyle = line.substr(line.find(":") + 1) == "1";
+            // Hit objects are the bulk of the file and always the last section, a mania line is ~30 bytes
+            if (section == Section::HitObjects) {
+                HitObjects.reserve(HitObjects.size() + buffer.size() / 24);
             }
-
             continue;
         }
 
-        if (currentSection == "Metadata") {
-            if (line.starts_with("Title")) {
-                Title = line.substr(line.find(":") + 1);
-            } else if (line.starts_with("TitleUnicode")) {
-                TitleUnicode = line.substr(line.find(":") + 1);
-            } else if (line.starts_with("Artist")) {
-                Artist = line.substr(line.find(":") + 1);
-            } else if (line.starts_with("ArtistUnicode")) {
-                ArtistUnicode = line.substr(line.find(":") + 1);
-            } else if (line.starts_with("Creator")) {
-                Creator = line.substr(line.find(":") + 1);
-            } else if (line.starts_with("Version")) {
-                Version = line.substr(line.find(":") + 1);
-            } else if (line.starts_with("Source")) {
-                Source = line.substr(line.find(":") + 1);
-            } else if (line.starts_with("Tags")) {
-                Tags = line.substr(line.find(":") + 1);
-            } else if (line.starts_with("BeatmapID")) {
-                BeatmapID = std::stoi(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("BeatmapSetID")) {
-                BeatmapSetID = std::stoi(line.substr(line.find(":") + 1));
+        switch (section) {
+            case Section::None:
+            {
+                if (line.starts_with("osu file format")) {
+                    size_t pos = line.find('v');
+                    PeppyFormat = std::string(line.substr(pos != line.npos ? pos + 1 : line.size()));
+                }
+                break;
             }
 
-            continue;
-        }
-
-        if (currentSection == "Difficulty") {
-            if (line.starts_with("HPDrainRate")) {
-                HPDrainRate = std::stof(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("CircleSize")) {
-                CircleSize = std::stof(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("OverallDifficulty")) {
-                OverallDifficulty = std::stof(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("ApproachRate")) {
-                ApproachRate = std::stof(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("SliderMultiplier")) {
-                SliderMultiplier = std::stof(line.substr(line.find(":") + 1));
-            } else if (line.starts_with("SliderTickRate")) {
-                SliderTickRate = std::stof(line.substr(line.find(":") + 1));
+            case Section::General:
+            {
+                std::string_view value = line;
+                std::string_view key = TextScanner::Trim(TextScanner::NextToken(value, ':'));
+                value = TextScanner::Trim(value);
+
+                if (key == "AudioFilename") {
+                    AudioFilename = std::string(value);
+                } else if (key == "AudioLeadIn") {
+                    TextScanner::Parse(value, AudioLeadIn);
+                } else if (key == "PreviewTime") {
+                    TextScanner::Parse(value, PreviewTime);
+                } else if (key == "Countdown") {
+                    TextScanner::Parse(value, Countdown);
+                } else if (key == "SampleSet") {
+                    SampleSet = std::string(value);
+                } else if (key == "StackLeniency") {
+                    TextScanner::Parse(value, StackLeniency);
+                } else if (key == "Mode") {
+                    TextScanner::Parse(value, Mode);
+                } else if (key == "LetterboxInBreaks") {
+                    LetterboxInBreaks = value == "1";
+                } else if (key == "WidescreenStoryboard") {
+                    WidescreenStoryboard = value == "1";
+                } else if (key == "SpecialStyle") {
+                    SpecialStyle = value == "1";
+                }
+                break;
             }
 
-            continue;
-        }
-
-        if (currentSection == "Events") {
-            std::vector<std::string> event;
+            case Section::Metadata:
             {
-                std::string_view view = line;
-                while (!view.empty()) {
-                    auto pos = view.find(',');
-                    event.push_back(std::string(view.substr(0, pos)));
-                    view.remove_prefix(pos != view.npos ? pos + 1 : view.size());
+                std::string_view value = line;
+                std::string_view key = TextScanner::Trim(TextScanner::NextToken(value, ':'));
+                value = TextScanner::Trim(value);
+
+                if (key == "Title") {
+                    Title = std::string(value);
+                } else if (key == "TitleUnicode") {
+                    TitleUnicode = std::string(value);
+                } else if (key == "Artist") {
+                    Artist = std::string(value);
+                } else if (key == "ArtistUnicode") {
+                    ArtistUnicode = std::string(value);
+                } else if (key == "Creator") {
+                    Creator = std::string(value);
+                } else if (key == "Version") {
+                    Version = std::string(value);
+                } else if (key == "Source") {
+                    Source = std::string(value);
+                } else if (key == "Tags") {
+                    Tags = std::string(value);
+                } else if (key == "BeatmapID") {
+                    TextScanner::Parse(value, BeatmapID);
+                } else if (key == "BeatmapSetID") {
+                    TextScanner::Parse(value, BeatmapSetID);
                 }
+                break;
             }
 
-            OsuEvent ev = {};
-            try {
-                ev.StartTime = std::stof(event[1]);
-            } catch (const std::invalid_argument &) {
-                ev.StartTime = 0; // WHY TF people set invalid things on invalid row
+            case Section::Difficulty:
+            {
+                std::string_view value = line;
+                std::string_view key = TextScanner::Trim(TextScanner::NextToken(value, ':'));
+                value = TextScanner::Trim(value);
+
+                if (key == "HPDrainRate") {
+                    TextScanner::Parse(value, HPDrainRate);
+                } else if (key == "CircleSize") {
+                    TextScanner::Parse(value, CircleSize);
+                } else if (key == "OverallDifficulty") {
+                    TextScanner::Parse(value, OverallDifficulty);
+                } else if (key == "ApproachRate") {
+                    TextScanner::Parse(value, ApproachRate);
+                } else if (key == "SliderMultiplier") {
+                    TextScanner::Parse(value, SliderMultiplier);
+                } else if (key == "SliderTickRate") {
+                    TextScanner::Parse(value, SliderTickRate);
+                }
+                break;
             }
 
-            // background
-            if (event[0] == "0") {
-                ev.Type = OsuEventType::Background;
+            case Section::Events:
+            {
+                ParseEvent(line);
+                break;
             }
 
-            // video
-            else if (event[0] == "Video" || event[0] == "1") {
-                ev.Type = OsuEventType::Videos;
+            case Section::TimingPoints:
+            {
+                ParseTimingPoint(line);
+                break;
             }
 
-            // break
-            else if (event[0] == "Break" || event[0] == "2") {
-                ev.Type = OsuEventType::Break;
+            case Section::HitObjects:
+            {
+                ParseHitObject(line);
+                break;
             }
 
-            // sample
-            else if (event[0] == "Sample" || event[0] == "5") {
-                ev.Type = OsuEventType::Sample;
+            default:
+            {
+                break;
             }
+        }
+    }
 
-            for (int i = 2; i < event.size(); i++) {
-                std::string copy = event[i];
-                if (copy.starts_with("\"") && copy.ends_with("\"")) {
-                    copy = copy.substr(1, copy.size() - 2);
-                }
+    bIsValid = true;
+}
 
-                ev.params.push_back(copy);
-            }
+void Osu::Beatmap::ParseEvent(std::string_view line)
+{
+    std::string_view type = TextScanner::NextToken(line, ',');
+
+    OsuEvent ev = {};
+    if (type == "0") {
+        ev.Type = OsuEventType::Background;
+    } else if (type == "Video" || type == "1") {
+        ev.Type = OsuEventType::Videos;
+    } else if (type == "Break" || type == "2") {
+        ev.Type = OsuEventType::Break;
+    } else if (type == "Sample" || type == "5") {
+        ev.Type = OsuEventType::Sample;
+    } else {
+        // Storyboard commands (Sprite, Animation, ...) are not used by the game
+        return;
+    }
 
-            Events.push_back(ev);
+    // WHY TF people set invalid things on invalid row, leave it at 0
+    TextScanner::Parse(TextScanner::NextToken(line, ','), ev.StartTime);
+
+    while (!line.empty()) {
+        std::string_view param = TextScanner::NextToken(line, ',');
+        if (param.size() >= 2 && param.front() == '"' && param.back() == '"') {
+            param = param.substr(1, param.size() - 2);
         }
 
-        if (currentSection == "TimingPoints") {
-            std::vector<std::string> timingPoint;
-            {
-                std::string_view view = line;
-                while (!view.empty()) {
-                    auto pos = view.find(',');
-                    timingPoint.push_back(std::string(view.substr(0, pos)));
-                    view.remove_prefix(pos != view.npos ? pos + 1 : view.size());
-                }
-            }
+        ev.params.emplace_back(param);
+    }
 
-            if (timingPoint.size() < 8) {
-                Logs::Puts("[osu::TimingPoints] Syntax error: %s", line.c_str());
-                continue;
-            }
+    Events.push_back(std::move(ev));
+}
 
-            OsuTimingPoint tp = {};
-            try {
-                tp.Offset = std::stof(timingPoint[0]);
-                tp.BeatLength = std::stof(timingPoint[1]);
-                tp.TimeSignature = std::stof(timingPoint[2]);
-                tp.SampleSet = std::stoi(timingPoint[3]);
-                tp.SampleIndex = std::stoi(timingPoint[4]);
-                tp.Volume = std::stoi(timingPoint[5]);
-                tp.Inherited = std::stoi(timingPoint[6]) == 1;
-                tp.KiaiMode = std::stoi(timingPoint[7]);
-            } catch (const std::invalid_argument &) {
-                Logs::Puts("[osu::TimingPoints] Syntax error: %s", line.c_str());
-                continue;
-            }
+void Osu::Beatmap::ParseTimingPoint(std::string_view line)
+{
+    std::string_view timingPoint[8];
+    if (SplitFields(line, ',', timingPoint) < 8) {
+        Logs::Write(LogLevel::Warning, "osu::TimingPoints", "Syntax error: %.*s", static_cast<int>(line.size()), line.data());
+        return;
+    }
 
-            TimingPoints.push_back(tp);
-            continue;
-        }
+    OsuTimingPoint tp = {};
+    int            inherited = 0, effects = 0;
+
+    bool ok = TextScanner::Parse(timingPoint[0], tp.Offset)
+              && TextScanner::Parse(timingPoint[1], tp.BeatLength)
+              && TextScanner::Parse(timingPoint[2], tp.TimeSignature)
+              && TextScanner::Parse(timingPoint[3], tp.SampleSet)
+              && TextScanner::Parse(timingPoint[4], tp.SampleIndex)
+              && TextScanner::Parse(timingPoint[5], tp.Volume)
+              && TextScanner::Parse(timingPoint[6], inherited)
+              && TextScanner::Parse(timingPoint[7], effects);
+
+    if (!ok) {
+        Logs::Write(LogLevel::Warning, "osu::TimingPoints", "Syntax error: %.*s", static_cast<int>(line.size()), line.data());
+        return;
+    }
 
-        if (currentSection == "HitObjects") {
-            std::vector<std::string> hitObject;
-            {
-                std::string_view view = line;
-                while (!view.empty()) {
-                    auto pos = view.find(',');
-                    hitObject.push_back(std::string(view.substr(0, pos)));
-                    view.remove_prefix(pos != view.npos ? pos + 1 : view.size());
-                }
-            }
+    tp.Inherited = inherited == 1;
+    tp.KiaiMode = effects != 0;
 
-            if (hitObject.size() < 4) {
-                Logs::Puts("[osu::HitObjects] Syntax error: %s", line.c_str());
-                continue;
-            }
+    TimingPoints.push_back(tp);
+}
 
-            OsuHitObject ho;
-            ho.X = std::stof(hitObject[0]);
-            ho.Y = std::stof(hitObject[1]);
-            ho.StartTime = std::stoi(hitObject[2]);
-            ho.Type = std::stoi(hitObject[3]);
-            ho.HitSound = std::stoi(hitObject[4]);
-            ho.Additions = "0:0:0:0:";
-            ho.KeysoundIndex = -1;
-
-            if (ho.Type == 128) {
-                std::string value = hitObject[5].substr(0, hitObject[5].find(":"));
-                ho.EndTime = std::stoi(value);
-            } else {
-                ho.EndTime = -1;
-            }
+void Osu::Beatmap::ParseHitObject(std::string_view line)
+{
+    std::string_view hitObject[6];
+    size_t           count = SplitFields(line, ',', hitObject);
+
+    OsuHitObject ho = {};
+    bool         ok = count >= 5
+              && TextScanner::Parse(hitObject[0], ho.X)
+              && TextScanner::Parse(hitObject[1], ho.Y)
+              && TextScanner::Parse(hitObject[2], ho.StartTime)
+              && TextScanner::Parse(hitObject[3], ho.Type)
+              && TextScanner::Parse(hitObject[4], ho.HitSound);
+
+    if (!ok) {
+        Logs::Write(LogLevel::Warning, "osu::HitObjects", "Syntax error: %.*s", static_cast<int>(line.size()), line.data());
+        return;
+    }
 
-            if (hitObject.size() > 5) {
-                std::vector<std::string> additions;
-                {
-                    std::string_view view = hitObject[5];
-                    while (!view.empty()) {
-                        auto pos = view.find(':');
-                        additions.push_back(std::string(view.substr(0, pos)));
-                        view.remove_prefix(pos != view.npos ? pos + 1 : view.size());
-                    }
-                }
+    ho.Additions = "0:0:0:0:";
+    ho.KeysoundIndex = -1;
+    ho.EndTime = -1;
 
-                auto volumeField = ho.Type & 128 ? 4 : 3;
-                if (additions.size() > volumeField) {
-                    ho.Volume = std::max(0, std::stoi(additions[volumeField]));
-                }
+    if (count > 5) {
+        // Hold notes carry their end time in front of the hit sample: endTime:normalSet:additionSet:index:volume:filename
+        std::string_view additions[6];
+        size_t           additionCount = SplitFields(hitObject[5], ':', additions);
 
-                auto keysoundField = volumeField + 1;
-                if (additions.size() > keysoundField && additions[keysoundField].size() > 0) {
-                    ho.KeysoundIndex = GetCustomSampleIndex(additions[keysoundField]);
-                }
-            }
+        if (ho.Type & 128) {
+            TextScanner::Parse(additions[0], ho.EndTime);
+        }
 
-            HitObjects.push_back(ho);
-            continue;
+        size_t volumeField = ho.Type & 128 ? 4 : 3;
+        if (additionCount > volumeField && TextScanner::Parse(additions[volumeField], ho.Volume)) {
+            ho.Volume = std::max(0, ho.Volume);
+        }
+
+        size_t keysoundField = volumeField + 1;
+        if (additionCount > keysoundField && additions[keysoundField].size() > 0) {
+            ho.KeysoundIndex = GetCustomSampleIndex(std::string(additions[keysoundField]));
         }
     }
 
-    bIsValid = true;
+    HitObjects.push_back(std::move(ho));
 }
 
 int Osu::Beatmap::GetCustomSampleIndex(std::string path)
 {
-    for (int i = 0; i < HitSamples.size(); i++) {
-        if (HitSamples[i] == path) {
-            return i;
-        }
+    auto it = m_sampleLookup.find(path);
+    if (it != m_sampleLookup.end()) {
+        return it->second;
     }
 
-    HitSamples.push_back(path);
-    return (int)HitSamples.size() - 1;
+    int index = static_cast<int>(HitSamples.size());
+    m_sampleLookup.emplace(path, index);
+    HitSamples.push_back(std::move(path));
+
+    return index;
 }
 
 bool Osu::Beatmap::IsValid()
@@ -3,6 +3,8 @@
 
 #include <filesystem>
 #include <iostream>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace Osu {
@@ -107,9 +109,14 @@ namespace Osu {
         int GetCustomSampleIndex(std::string);
 
     private:
-        void ParseString(std::stringstream &ss);
+        void Parse(std::string_view buffer);
+        void ParseEvent(std::string_view line);
+        void ParseTimingPoint(std::string_view line);
+        void ParseHitObject(std::string_view line);
 
         bool bIsValid;
+
+        std::unordered_map<std::string, int> m_sampleLookup;
     };
 } // namespace Osu
 
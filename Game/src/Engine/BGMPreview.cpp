@@ -3,6 +3,7 @@
 #include "../EnvironmentSetup.hpp"
 #include "Configuration.h"
 #include "GameAudioSampleCache.hpp"
+#include "Rendering/Threading/JobSystem.h"
 #include <Logs.h>
 #include <cmath>
 #include <future>
@@ -36,7 +37,8 @@ void BGMPreview::Load()
 
     std::string Key = EnvironmentSetup::Get("Key");
 
-    auto tr = std::thread([&] {
+    // Holds m_mutex while it decodes, must never be picked up by a Wait on a thread already holding it
+    JobSystem::GetInstance()->Schedule([this] {
         int state = ++m_currentState;
 
         std::lock_guard<std::mutex> lock(*m_mutex);
@@ -64,7 +66,7 @@ void BGMPreview::Load()
                 m_currentFilePath = file.string();
                 m_currentChart = new Chart(o2jamFile, 2);
             } catch (std::exception &e) {
-                Logs::Puts("[BGMPreview] Failed to load the audio chart: %s", e.what());
+                Logs::Write(LogLevel::Error, "BGMPreview", "Failed to load the audio chart: %s", e.what());
                 return;
             }
 
@@ -102,9 +104,9 @@ void BGMPreview::Load()
         }
 
         Ready = true;
-    });
-
-    tr.detach();
+    },
+                                       nullptr,
+                                       JobAffinity::LONG_RUNNING);
 }
 
 void BGMPreview::Update(double delta)
@@ -118,7 +120,7 @@ void BGMPreview::Update(double delta)
         auto &sample = m_autoSamples[i];
         if (m_currentAudioPosition >= sample.StartTime) {
             if (sample.StartTime - m_currentAudioPosition < 5) {
-                GameAudioSampleCache::Play(sample.Index, (int)::round(sample.Volume * 50.0f), (int)::round(sample.Pan * 100.0f));
+                GameAudioSampleCache::Play(sample.Index, (int)::round(sample.Volume * 50.0f), (int)::round(sample.Pan * 100.0f), m_currentAudioPosition - sample.StartTime);
             }
 
             m_currentSampleIndex++;
@@ -1,20 +1,14 @@
 #include "DrawableNote.hpp"
 #include "../Resources/GameResources.hpp"
-#include "Rendering/Renderer.h"
 #include "Texture/Texture2D.h"
+#include "Texture/TextureAtlas.h"
 
 DrawableNote::DrawableNote(NoteImage *frame) : FrameTimer::FrameTimer()
 {
     m_frames = std::vector<Texture2D *>();
 
-    if (Renderer::GetInstance()->IsVulkan()) {
-        for (auto &frame : frame->VulkanTexture) {
-            m_frames.push_back(new Texture2D(frame));
-        }
-    } else {
-        for (auto &frame : frame->Texture) {
-            m_frames.push_back(new Texture2D(frame));
-        }
+    for (auto &id : frame->Frames) {
+        m_frames.push_back(frame->Atlas->CreateTexture(id));
     }
 
     AnchorPoint = { 0.0, 1.0 };
@@ -1,6 +1,7 @@
 #include "FrameTimer.hpp"
 #include "Rendering/Renderer.h"
 #include "Texture/Texture2D.h"
+#include "Texture/TextureAtlas.h"
 
 FrameTimer::FrameTimer()
 {
@@ -11,6 +12,7 @@ FrameTimer::FrameTimer()
     AlphaBlend = false;
     Size = UDim2::fromScale(1, 1);
     TintColor = { 1.0f, 1.0f, 1.0f };
+    m_atlas = nullptr;
 }
 
 FrameTimer::FrameTimer(std::vector<Texture2D *> frames) : FrameTimer::FrameTimer()
@@ -20,18 +22,21 @@ FrameTimer::FrameTimer(std::vector<Texture2D *> frames) : FrameTimer::FrameTimer
 
 FrameTimer::FrameTimer(std::vector<std::string> frames) : FrameTimer::FrameTimer()
 {
-    m_frames = std::vector<Texture2D *>();
+    std::vector<std::filesystem::path> paths;
     for (auto frame : frames) {
-        m_frames.push_back(new Texture2D(frame));
+        if (!std::filesystem::exists(frame)) {
+            frame = std::filesystem::current_path().string() + frame;
+        }
+
+        paths.push_back(frame);
     }
+
+    LoadAtlas(paths);
 }
 
 FrameTimer::FrameTimer(std::vector<std::filesystem::path> frames) : FrameTimer::FrameTimer()
 {
-    m_frames = std::vector<Texture2D *>();
-    for (auto frame : frames) {
-        m_frames.push_back(new Texture2D(frame));
-    }
+    LoadAtlas(frames);
 }
 
 FrameTimer::FrameTimer(std::vector<SDL_Texture *> frames) : FrameTimer::FrameTimer()
@@ -55,6 +60,29 @@ FrameTimer::~FrameTimer()
     for (auto &f : m_frames) {
         delete f;
     }
+
+    delete m_atlas;
+}
+
+void FrameTimer::LoadAtlas(std::vector<std::filesystem::path> &frames)
+{
+    m_atlas = new TextureAtlas();
+
+    std::vector<int> ids;
+    for (auto &frame : frames) {
+        if (!std::filesystem::exists(frame)) {
+            throw std::runtime_error(frame.string() + " not found!");
+        }
+
+        ids.push_back(m_atlas->Add(frame));
+    }
+
+    m_atlas->Build();
+
+    m_frames = std::vector<Texture2D *>();
+    for (auto &id : ids) {
+        m_frames.push_back(m_atlas->CreateTexture(id));
+    }
 }
 
 void FrameTimer::Draw(double delta)
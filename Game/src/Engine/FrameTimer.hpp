@@ -10,6 +10,7 @@
 #include <vector>
 
 class Texture2D;
+class TextureAtlas;
 class Color3;
 
 class FrameTimer
@@ -44,7 +45,10 @@ public:
     void CalculateSize();
 
 protected:
+    void LoadAtlas(std::vector<std::filesystem::path> &frames);
+
     std::vector<Texture2D *> m_frames;
+    TextureAtlas            *m_atlas; // Owns the pages behind m_frames when loaded from files
     int                      m_currentFrame;
     double                   m_frameTime;
     double                   m_currentTime;
@@ -1,6 +1,8 @@
 #include "GameAudioSampleCache.hpp"
 #include <Logs.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -12,21 +14,26 @@
 #include "../Data/Chart.hpp"
 #include "Audio/AudioManager.h"
 #include "Audio/BassFXSampleEncoding.h"
+#include "Rendering/Threading/JobSystem.h"
+#include "../Resources/KeysoundCache.hpp"
 
 struct NoteAudioSample
 {
     std::string  FilePath;
     AudioSample *Sample;
+    Audio       *Stream = nullptr;
 };
 
 namespace GameAudioSampleCache {
     std::unordered_map<int, NoteAudioSample>                     samples;
     std::unordered_map<int, std::unique_ptr<AudioSampleChannel>> sampleIndex;
+    std::vector<std::string>                                     streamIds;
 
     std::string currentHash;
     double      m_rate = 1.0;
 
     std::mutex m_lock;
+    std::mutex m_loadLock;
 } // namespace GameAudioSampleCache
 
 int LastIndexOf(std::string &str, char c)
@@ -52,11 +59,175 @@ bool GameAudioSampleCache::IsEmpty()
     return currentHash == "";
 }
 
+namespace {
+    // Samples above these limits (usually the BGM of osu! or BMS charts) are decoded while playing
+    const size_t kStreamSizeThreshold = 1024 * 1024;
+    const size_t kStreamProbeThreshold = 128 * 1024;
+    const double kStreamDurationThreshold = 20.0;
+    const double kStreamLateThreshold = 20.0;
+
+    bool IsLongStream(HSTREAM stream)
+    {
+        if (!stream) {
+            return false;
+        }
+
+        double length = BASS_ChannelBytes2Seconds(stream, BASS_ChannelGetLength(stream, BASS_POS_BYTE));
+        BASS_StreamFree(stream);
+
+        return length >= kStreamDurationThreshold;
+    }
+
+    bool ShouldStream(void *buffer, size_t size)
+    {
+        if (size >= kStreamSizeThreshold) {
+            return true;
+        }
+
+        if (size < kStreamProbeThreshold) {
+            return false;
+        }
+
+        return IsLongStream(BASS_StreamCreateFile(TRUE, buffer, 0, size, BASS_STREAM_DECODE));
+    }
+
+    bool ShouldStream(std::filesystem::path path, uint64_t size)
+    {
+        if (size >= kStreamSizeThreshold) {
+            return true;
+        }
+
+        if (size < kStreamProbeThreshold) {
+            return false;
+        }
+
+#if _WIN32
+        return IsLongStream(BASS_StreamCreateFile(FALSE, path.wstring().c_str(), 0, 0, BASS_STREAM_DECODE | BASS_UNICODE));
+#else
+        return IsLongStream(BASS_StreamCreateFile(FALSE, path.string().c_str(), 0, 0, BASS_STREAM_DECODE));
+#endif
+    }
+
+    void SetupStream(Audio *stream, bool pitch, double rate)
+    {
+        stream->SetPitch(pitch);
+        stream->SetRate((float)rate);
+    }
+
+    struct CacheContext
+    {
+        bool                                       Enabled = false;
+        bool                                       Dirty = false;
+        KeysoundCache::Encoding                    Encoding = KeysoundCache::Encoding::PCM16;
+        KeysoundCache::Reader                      Reader;
+        KeysoundCache::Writer                      Writer;
+        std::vector<const KeysoundCache::Entry *> Hits;
+        std::vector<int16_t>                       Scratch;
+    };
+
+    bool CreateFromCache(CacheContext &cache, std::string id, int index, uint64_t sourceSize, uint64_t sourceStamp, AudioSample **out)
+    {
+        if (!cache.Enabled) {
+            return false;
+        }
+
+        auto entry = cache.Reader.Find(index, sourceSize, sourceStamp);
+        if (!entry) {
+            return false;
+        }
+
+        const void *pcm = cache.Reader.GetPCM(entry, cache.Scratch);
+        if (!pcm) {
+            return false;
+        }
+
+        if (!AudioManager::GetInstance()->CreateSampleFromData(id, 0, entry->SampleRate, entry->Channels, entry->PcmLength, const_cast<void *>(pcm), out)) {
+            return false;
+        }
+
+        cache.Hits.push_back(entry);
+        return true;
+    }
+
+    struct PendingDecode
+    {
+        std::string           Id;
+        std::string           Name;
+        NoteAudioSample       Sample;
+        int                   Index;
+        const uint8_t        *Buffer = nullptr; // Embedded sample data, owned by the chart
+        size_t                Size = 0;
+        uint64_t              Stamp = 0; // KeysoundCache::GetStamp of the source
+        std::filesystem::path Path;      // External sample, read by the decode worker
+
+        BASS_FX_SampleEncoding::FXEncoding Result;
+    };
+
+    std::vector<char> ReadFile(std::filesystem::path path)
+    {
+        std::fstream fs(path, std::ios::binary | std::ios::in);
+        if (!fs.is_open()) {
+            return {};
+        }
+
+        fs.seekg(0, std::ios::end);
+        size_t size = fs.tellg();
+        fs.seekg(0, std::ios::beg);
+
+        std::vector<char> buffer(size);
+        fs.read(buffer.data(), size);
+        fs.close();
+
+        return buffer;
+    }
+
+    void DecodeParallel(std::vector<PendingDecode> &pending, bool stretch, double rate, GameAudioSampleCache::LoadProgress *progress)
+    {
+        if (pending.empty()) {
+            return;
+        }
+
+        JobSystem::GetInstance()->ParallelFor(pending.size(), [&](size_t i) {
+            if (progress && progress->Cancel) {
+                return;
+            }
+
+            auto &item = pending[i];
+
+            std::vector<char> fileBuffer;
+            void             *buffer = (void *)item.Buffer;
+            if (!item.Path.empty()) {
+                fileBuffer = ReadFile(item.Path);
+
+                buffer = fileBuffer.data();
+                item.Size = fileBuffer.size();
+            }
+
+            if (item.Size > 0) {
+                item.Result = stretch
+                                  ? BASS_FX_SampleEncoding::Encode(buffer, item.Size, (float)rate)
+                                  : BASS_FX_SampleEncoding::Decode(buffer, item.Size);
+            }
+
+            if (progress) {
+                progress->Loaded++;
+            }
+        });
+    }
+} // namespace
+
 void GameAudioSampleCache::Load(Chart *chart, bool pitch)
 {
+    Load(chart, pitch, nullptr);
+}
+
+bool GameAudioSampleCache::Load(Chart *chart, bool pitch, LoadProgress *progress)
+{
+    std::lock_guard<std::mutex> loadLock(m_loadLock);
+
     auto audioManager = AudioManager::GetInstance();
     if (currentHash == chart->MD5Hash) {
-        return;
+        return true;
     }
 
     Dispose();
@@ -64,35 +235,72 @@ void GameAudioSampleCache::Load(Chart *chart, bool pitch)
 
     std::array<std::string, 3> ext = { ".wav", ".ogg", ".mp3" };
 
+    bool stretch = !pitch && m_rate != 1.0f;
+
+    CacheContext cache = {};
+    cache.Enabled = KeysoundCache::IsEnabled() && !chart->MD5Hash.empty();
+
+    auto cachePath = KeysoundCache::GetPath(chart->MD5Hash, stretch ? m_rate : 1.0);
+    if (cache.Enabled) {
+        cache.Encoding = KeysoundCache::GetPreferredEncoding();
+        cache.Reader.Open(cachePath);
+    }
+
+    if (progress) {
+        progress->Total = (int)chart->m_samples.size();
+        progress->Loaded = 0;
+    }
+
+    // First pass: everything that does not need a codec, the rest is collected for the decode workers
+    std::vector<PendingDecode> pending;
+
     for (auto &it : chart->m_samples) {
+        if (progress && progress->Cancel) {
+            currentHash = "";
+            return false;
+        }
+
         NoteAudioSample sample = {};
 
         if (it.Type == 2) {
             sample.FilePath = "Internal" + std::to_string(it.Index);
 
-            if (audioManager->GetSample(sample.FilePath) == nullptr) {
-                if (!pitch && m_rate != 1.0f) {
-                    auto data = BASS_FX_SampleEncoding::Encode(it.FileBuffer.data(), it.FileBuffer.size(), (float)m_rate);
-                    if (data.sampleFlags == 0) {
-                        Logs::Puts("[BASSFxSampleEncoding] Failed to pre-process time-stretch sample: %s", it.FileName.c_str());
-                        continue;
-                    }
+            if (ShouldStream(it.FileBuffer.data(), it.FileBuffer.size())) {
+                std::string id = "Stream" + sample.FilePath;
 
-                    if (!audioManager->CreateSampleFromData(
-                            sample.FilePath,
-                            data.sampleFlags,
-                            data.sampleRate,
-                            data.sampleChannels,
-                            data.sampleLength,
-                            data.sampleData.data(),
-                            &sample.Sample)) {
+                if (audioManager->Get(id) == nullptr && audioManager->CreateStream(id, it.FileBuffer.data(), it.FileBuffer.size(), &sample.Stream)) {
+                    SetupStream(sample.Stream, pitch, m_rate);
 
-                        Logs::Puts("[AudioSampleManager] Failed to load sample: %s", it.FileName.c_str());
-                        continue;
+                    streamIds.push_back(id);
+                    samples[it.Index] = sample;
+
+                    if (progress) {
+                        progress->Loaded++;
                     }
+                    continue;
+                }
+            }
+
+            if (audioManager->GetSample(sample.FilePath) == nullptr) {
+                uint64_t stamp = cache.Enabled ? KeysoundCache::GetStamp(it.FileBuffer.data(), it.FileBuffer.size()) : 0;
+
+                if (CreateFromCache(cache, sample.FilePath, it.Index, it.FileBuffer.size(), stamp, &sample.Sample)) {
+                    sample.Sample->SetRate(stretch ? 1.0 : m_rate);
+                } else if (stretch || cache.Enabled) {
+                    PendingDecode decode = {};
+                    decode.Id = sample.FilePath;
+                    decode.Name = it.FileName.string();
+                    decode.Sample = sample;
+                    decode.Index = it.Index;
+                    decode.Buffer = it.FileBuffer.data();
+                    decode.Size = it.FileBuffer.size();
+                    decode.Stamp = stamp;
+
+                    pending.push_back(std::move(decode));
+                    continue;
                 } else {
                     if (!audioManager->CreateSample(sample.FilePath, it.FileBuffer.data(), it.FileBuffer.size(), &sample.Sample)) {
-                        Logs::Puts("[AudioSampleManager] Failed to load sample: %s", it.FileName.c_str());
+                        Logs::Write(LogLevel::Error, "AudioSampleManager", "Failed to load sample: %s", it.FileName.string().c_str());
                         continue;
                     }
 
@@ -127,60 +335,62 @@ void GameAudioSampleCache::Load(Chart *chart, bool pitch)
             if (found) {
                 sample.FilePath = path.string();
 
-                if (!pitch && m_rate != 1.0f) {
-                    std::fstream fs(path, std::ios::binary | std::ios::in);
-                    if (!fs.is_open()) {
-                        Logs::Puts("[AudioSampleManager] Failed to load sample: %s", it.FileName.c_str());
-                        continue;
-                    }
+                std::string id = path.string() + std::to_string(it.Index);
+                if (!stretch && audioManager->GetSample(id) != nullptr) {
+                    continue;
+                }
 
-                    fs.seekg(0, std::ios::end);
-                    size_t size = fs.tellg();
-                    fs.seekg(0, std::ios::beg);
+                std::error_code ec;
+                uint64_t        fileSize = std::filesystem::file_size(path, ec);
 
-                    std::vector<char> buffer(size);
-                    fs.read(buffer.data(), size);
-                    fs.close();
+                if (!ec && ShouldStream(path, fileSize)) {
+                    std::string streamId = "Stream" + id;
 
-                    auto data = BASS_FX_SampleEncoding::Encode(buffer.data(), size, (float)m_rate);
+                    if (audioManager->Get(streamId) == nullptr && audioManager->CreateStream(streamId, path, &sample.Stream)) {
+                        SetupStream(sample.Stream, pitch, m_rate);
 
-                    if (data.sampleFlags == 0) {
-                        Logs::Puts("[BASSFxSampleEncoding] Failed to pre-process time-stretch sample: %s", it.FileName.c_str());
+                        streamIds.push_back(streamId);
+                        samples[it.Index] = sample;
+
+                        if (progress) {
+                            progress->Loaded++;
+                        }
                         continue;
                     }
+                }
 
-                    if (!audioManager->CreateSampleFromData(
-                            sample.FilePath + std::to_string(it.Index),
-                            data.sampleFlags,
-                            data.sampleRate,
-                            data.sampleChannels,
-                            data.sampleLength,
-                            data.sampleData.data(),
-                            &sample.Sample)) {
+                uint64_t stamp = cache.Enabled ? KeysoundCache::GetStamp(path) : 0;
 
-                        Logs::Puts("[AudioSampleManager] Failed to load sample: %s", it.FileName.c_str());
+                if (!ec && CreateFromCache(cache, id, it.Index, fileSize, stamp, &sample.Sample)) {
+                    sample.Sample->SetRate(stretch ? 1.0 : m_rate);
+                    samples[it.Index] = sample;
+                } else if (stretch || cache.Enabled) {
+                    PendingDecode decode = {};
+                    decode.Id = id;
+                    decode.Name = it.FileName.string();
+                    decode.Sample = sample;
+                    decode.Index = it.Index;
+                    decode.Path = path;
+                    decode.Stamp = stamp;
+
+                    pending.push_back(std::move(decode));
+                    continue;
+                } else {
+                    if (!audioManager->CreateSample(id, path, &sample.Sample)) {
+                        Logs::Write(LogLevel::Error, "AudioSampleManager", "Failed to load sample: %s", it.FileName.string().c_str());
                         continue;
                     }
 
+                    sample.Sample->SetRate(m_rate);
                     samples[it.Index] = sample;
-                } else {
-                    if (audioManager->GetSample(path.string() + std::to_string(it.Index)) == nullptr) {
-                        if (!audioManager->CreateSample(path.string() + std::to_string(it.Index), path, &sample.Sample)) {
-                            Logs::Puts("[AudioSampleManager] Failed to load sample: %s", it.FileName.c_str());
-                            continue;
-                        }
-
-                        sample.Sample->SetRate(m_rate);
-                        samples[it.Index] = sample;
-                    }
                 }
             } else {
                 sample.FilePath = path.string();
-                Logs::Puts("[AudioSampleManager] Cannot find audio: %s, at index: %d, Creating a silent audio", path.string().c_str(), it.Index);
+                Logs::Write(LogLevel::Warning, "AudioSampleManager", "Cannot find audio: %s, at index: %d, Creating a silent audio", path.string().c_str(), it.Index);
 
                 if (audioManager->GetSample(path.string() + std::to_string(it.Index)) == nullptr) {
                     if (!audioManager->CreateSample(path.string() + std::to_string(it.Index), "", &sample.Sample)) {
-                        Logs::Puts("[AudioSampleManager] Failed to load sample: %s", it.FileName.c_str());
+                        Logs::Write(LogLevel::Error, "AudioSampleManager", "Failed to load sample: %s", it.FileName.string().c_str());
                         continue;
                     }
 
@@ -188,10 +398,83 @@ void GameAudioSampleCache::Load(Chart *chart, bool pitch)
                 }
             }
         }
+
+        if (progress) {
+            progress->Loaded++;
+        }
+    }
+
+    // Second pass: run the codecs on worker threads, BASS decoding channels are independent of each other
+    DecodeParallel(pending, stretch, m_rate, progress);
+
+    if (progress && progress->Cancel) {
+        currentHash = "";
+        return false;
+    }
+
+    // Third pass: BASS sample creation and the cache index are not thread safe, so finish serially
+    for (auto &item : pending) {
+        if (progress && progress->Cancel) {
+            currentHash = "";
+            return false;
+        }
+
+        auto &data = item.Result;
+        auto &sample = item.Sample;
+
+        if (data.sampleFlags != 0 && audioManager->CreateSampleFromData(
+                                         item.Id,
+                                         data.sampleFlags,
+                                         data.sampleRate,
+                                         data.sampleChannels,
+                                         data.sampleLength,
+                                         data.sampleData.data(),
+                                         &sample.Sample)) {
+
+            // Only 16-bit PCM output is stored, other formats will be decoded every time
+            if (cache.Enabled && (data.sampleFlags & (BASS_SAMPLE_FLOAT | BASS_SAMPLE_8BITS)) == 0) {
+                cache.Writer.Add(item.Index, item.Size, item.Stamp, data.sampleRate, data.sampleChannels, data.sampleData.data(), data.sampleLength, cache.Encoding);
+                cache.Dirty = true;
+            }
+        } else if (stretch) {
+            Logs::Write(LogLevel::Error, "BASSFxSampleEncoding", "Failed to pre-process time-stretch sample: %s", item.Name.c_str());
+            continue;
+        } else {
+            // Let BASS try its own sample loader before giving up
+            bool result = item.Path.empty()
+                              ? audioManager->CreateSample(item.Id, (uint8_t *)item.Buffer, item.Size, &sample.Sample)
+                              : audioManager->CreateSample(item.Id, item.Path, &sample.Sample);
+
+            if (!result) {
+                Logs::Write(LogLevel::Error, "AudioSampleManager", "Failed to load sample: %s", item.Name.c_str());
+                continue;
+            }
+        }
+
+        if (!stretch) {
+            sample.Sample->SetRate(m_rate);
+        }
+
+        samples[item.Index] = sample;
+    }
+
+    if (cache.Enabled && cache.Dirty) {
+        for (auto entry : cache.Hits) {
+            cache.Writer.AddRaw(*entry, cache.Reader.GetData(entry));
+        }
+
+        // Release the mapping before replacing the file
+        cache.Reader.Close();
+
+        if (!cache.Writer.Save(cachePath)) {
+            Logs::Write(LogLevel::Warning, "AudioSampleManager", "Failed to save keysound cache for: %s", chart->MD5Hash.c_str());
+        }
     }
+
+    return true;
 }
 
-void GameAudioSampleCache::Play(int index, int volume, int pan)
+void GameAudioSampleCache::Play(int index, int volume, int pan, double offset)
 {
     if (index == -1) {
         return;
@@ -201,6 +484,20 @@ void GameAudioSampleCache::Play(int index, int volume, int pan)
         return;
     }
 
+    auto stream = samples[index].Stream;
+    if (stream) {
+        stream->SetVolume(volume);
+        stream->SetPan(pan);
+
+        // Keysounds are short enough to ignore the offset, but a late BGM has to catch up
+        uint32_t position = offset > kStreamLateThreshold ? static_cast<uint32_t>(offset) : 0;
+        if (!stream->Play(position)) {
+            Logs::Write(LogLevel::Warning, "AudioSampleManager", "Failed to play stream index %d", index);
+        }
+
+        return;
+    }
+
     Stop(index);
 
     auto channel = samples[index].Sample->CreateChannel();
@@ -219,6 +516,12 @@ void GameAudioSampleCache::Stop(int index)
 {
     std::lock_guard<std::mutex> lock(m_lock);
 
+    auto sample = samples.find(index);
+    if (sample != samples.end() && sample->second.Stream) {
+        sample->second.Stream->Stop();
+        return;
+    }
+
     if (sampleIndex.find(index) != sampleIndex.end()) {
         auto &it = sampleIndex[index];
 
@@ -230,6 +533,22 @@ void GameAudioSampleCache::Stop(int index)
     }
 }
 
+void GameAudioSampleCache::Seek(int index, double position)
+{
+    auto sample = samples.find(index);
+    if (sample == samples.end() || !sample->second.Stream) {
+        return;
+    }
+
+    sample->second.Stream->SetPosition(position);
+}
+
+bool GameAudioSampleCache::IsStream(int index)
+{
+    auto sample = samples.find(index);
+    return sample != samples.end() && sample->second.Stream != nullptr;
+}
+
 void GameAudioSampleCache::SetRate(double rate)
 {
     if (m_rate != rate) {
@@ -251,12 +570,24 @@ void GameAudioSampleCache::ResumeAll()
     for (auto &kv : sampleIndex) {
         kv.second->Play();
     }
+
+    for (auto &kv : samples) {
+        if (kv.second.Stream) {
+            kv.second.Stream->Resume();
+        }
+    }
 }
 
 void GameAudioSampleCache::PauseAll()
 {
     std::lock_guard<std::mutex> lock(m_lock);
 
+    for (auto &kv : samples) {
+        if (kv.second.Stream && kv.second.Stream->IsPlaying()) {
+            kv.second.Stream->Pause();
+        }
+    }
+
     for (auto &kv : sampleIndex) {
         if (kv.second->IsPlaying()) {
             kv.second->Pause();
@@ -279,6 +610,12 @@ void GameAudioSampleCache::StopAll()
     }
 
     sampleIndex.clear();
+
+    for (auto &kv : samples) {
+        if (kv.second.Stream && kv.second.Stream->IsPlaying()) {
+            kv.second.Stream->Stop();
+        }
+    }
 }
 
 std::vector<float> GameAudioSampleCache::QueryMixerData()
@@ -291,6 +628,12 @@ void GameAudioSampleCache::Dispose()
     StopAll();
 
     samples.clear();
+
+    for (auto &id : streamIds) {
+        AudioManager::GetInstance()->Remove(id);
+    }
+
+    streamIds.clear();
     AudioManager::GetInstance()->RemoveAll();
 
     currentHash = "";
@@ -1,17 +1,30 @@
 #pragma once
+#include <atomic>
 #include <vector>
 
 class Chart;
 class AudioSampleChannel;
 
 namespace GameAudioSampleCache {
+    struct LoadProgress
+    {
+        std::atomic<bool> Cancel = false;
+        std::atomic<int>  Loaded = 0;
+        std::atomic<int>  Total = 0;
+    };
+
     void Load(Chart *chart, bool pitch);
     void Load(Chart *chart, bool pitch, bool force);
 
+    // Returns false when cancelled, the cache is left empty so the next Load starts over
+    bool Load(Chart *chart, bool pitch, LoadProgress *progress);
+
     bool IsEmpty();
 
-    void   Play(int index, int volume = 100, int pan = 0);
+    void   Play(int index, int volume = 100, int pan = 0, double offset = 0);
     void   Stop(int index);
+    void   Seek(int index, double position);
+    bool   IsStream(int index);
     void   SetRate(double rate);
     double SetRate();
     void   ResumeAll();
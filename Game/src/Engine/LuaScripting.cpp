@@ -1,5 +1,5 @@
 #include "LuaScripting.h"
-#include "../Data/Util/Util.hpp"
+#include "../Data/Util/TextScanner.hpp"
 #include "../EnvironmentSetup.hpp"
 #include "SkinManager.hpp" // wtf recursive
 
@@ -12,41 +12,47 @@ struct IGame
 
     int GetHitPosition()
     {
-        auto instance = SkinManager::GetInstance();
-        if (!instance) {
-            return -1;
-        }
-
-        auto value = instance->GetSkinProp("Game", "HitPos", "480");
-        return std::stoi(value);
+        LoadSkinProps();
+        return m_hitPosition;
     }
 
     int GetLaneOffset()
     {
-        auto instance = SkinManager::GetInstance();
-        if (!instance) {
-            return -1;
-        }
-
-        auto value = instance->GetSkinProp("Game", "LaneOffset", "5");
-        return std::stoi(value);
+        LoadSkinProps();
+        return m_laneOffset;
     }
 
     std::tuple<int, int> GetResolution()
     {
-        auto instance = SkinManager::GetInstance();
-        if (!instance) {
-            return std::make_tuple(-1, -1);
+        LoadSkinProps();
+        return std::make_tuple(m_width, m_height);
+    }
+
+private:
+    // Skin props only change on a skin reload, which recreates every script state and with it this object
+    void LoadSkinProps()
+    {
+        if (m_loaded) {
+            return;
         }
 
-        auto value = instance->GetSkinProp("Window", "NativeSize", "800x600");
-        auto split = splitString(value, 'x');
+        auto instance = SkinManager::GetInstance();
+        TextScanner::Parse(instance->GetSkinProp("Game", "HitPos", "480"), m_hitPosition);
+        TextScanner::Parse(instance->GetSkinProp("Game", "LaneOffset", "5"), m_laneOffset);
 
-        auto width = std::stoi(split[0]);
-        auto height = std::stoi(split[1]);
+        std::string      resolution = instance->GetSkinProp("Window", "NativeSize", "800x600");
+        std::string_view view = resolution;
+        TextScanner::Parse(TextScanner::NextToken(view, 'x'), m_width);
+        TextScanner::Parse(view, m_height);
 
-        return std::make_tuple(width, height);
+        m_loaded = true;
     }
+
+    bool m_loaded = false;
+    int  m_hitPosition = 480;
+    int  m_laneOffset = 5;
+    int  m_width = 800;
+    int  m_height = 600;
 };
 
 LuaScripting::LuaScripting()
@@ -194,14 +200,46 @@ void LuaScripting::Update(double delta)
     }
 }
 
-std::vector<NumericValue> LuaScripting::GetNumeric(SkinGroup group, std::string key)
+sol::table &LuaScripting::GetResult(ScriptState &state)
 {
-    try {
-        if (m_states[group].init.lua_state() == NULL) {
+    if (!state.result.valid()) {
+        if (state.init.lua_state() == NULL) {
             throw std::runtime_error("Lua state is null");
         }
 
-        sol::table result_table = m_states[group].init();
+        sol::table result = state.init();
+        state.result = result;
+    }
+
+    return state.result;
+}
+
+void LuaScripting::InvalidateCache()
+{
+    for (auto &[group, state] : m_states) {
+        state.result = sol::table();
+        state.cache = {};
+    }
+
+    if (m_arena_states) {
+        m_arena_states->result = sol::table();
+        m_arena_states->cache = {};
+    }
+}
+
+std::vector<NumericValue> LuaScripting::GetNumeric(SkinGroup group, std::string key)
+{
+    if (m_states.find(group) == m_states.end()) {
+        TryLoadGroup(group);
+    }
+
+    auto &state = m_states[group];
+    if (auto it = state.cache.Numeric.find(key); it != state.cache.Numeric.end()) {
+        return it->second;
+    }
+
+    try {
+        sol::table &result_table = GetResult(state);
         sol::table key_array = result_table[SkinDataType::Numeric][key];
 
         std::vector<NumericValue> result;
@@ -226,6 +264,7 @@ std::vector<NumericValue> LuaScripting::GetNumeric(SkinGroup group, std::string
             result.push_back(numeric_value);
         }
 
+        state.cache.Numeric[key] = result;
         return result;
     } catch (const sol::error &err) {
         throw std::runtime_error(err.what());
@@ -238,12 +277,13 @@ std::vector<PositionValue> LuaScripting::GetPosition(SkinGroup group, std::strin
         TryLoadGroup(group);
     }
 
-    try {
-        if (m_states[group].init.lua_state() == NULL) {
-            throw std::runtime_error("Lua state is null");
-        }
+    auto &state = m_states[group];
+    if (auto it = state.cache.Position.find({ KeyCount, key }); it != state.cache.Position.end()) {
+        return it->second;
+    }
 
-        sol::table result_table = m_states[group].init();
+    try {
+        sol::table &result_table = GetResult(state);
         sol::table key_array = result_table[SkinDataType::Position][KeyCount][key];
 
         std::vector<PositionValue> result;
@@ -262,6 +302,7 @@ std::vector<PositionValue> LuaScripting::GetPosition(SkinGroup group, std::strin
             result.push_back(position_value);
         }
 
+        state.cache.Position[{ KeyCount, key }] = result;
         return result;
     } catch (const sol::error &err) {
         throw std::runtime_error(err.what());
@@ -274,14 +315,15 @@ std::vector<RectInfo> LuaScripting::GetRect(SkinGroup group, std::string key)
         TryLoadGroup(group);
     }
 
-    try {
-        if (m_states[group].init.lua_state() == NULL) {
-            throw std::runtime_error("Lua state is null");
-        }
+    auto &state = m_states[group];
+    if (auto it = state.cache.Rect.find(key); it != state.cache.Rect.end()) {
+        return it->second;
+    }
 
+    try {
         std::vector<RectInfo> result;
 
-        sol::table result_table = m_states[group].init();
+        sol::table &result_table = GetResult(state);
         sol::table key_array = result_table[SkinDataType::Rect][key];
 
         for (auto &value : key_array) {
@@ -296,6 +338,7 @@ std::vector<RectInfo> LuaScripting::GetRect(SkinGroup group, std::string key)
             result.push_back(rect_info);
         }
 
+        state.cache.Rect[key] = result;
         return result;
     } catch (const sol::error &err) {
         throw std::runtime_error(err.what());
@@ -308,18 +351,20 @@ NoteValue LuaScripting::GetNote(SkinGroup group, std::string key, int KeyCount)
         TryLoadGroup(group);
     }
 
-    try {
-        if (m_states[group].init.lua_state() == NULL) {
-            throw std::runtime_error("Lua state is null");
-        }
+    auto &state = m_states[group];
+    if (auto it = state.cache.Note.find({ KeyCount, key }); it != state.cache.Note.end()) {
+        return it->second;
+    }
 
-        sol::table result_table = m_states[group].init();
+    try {
+        sol::table &result_table = GetResult(state);
         sol::table key_array = result_table[SkinDataType::Note][KeyCount][key];
 
         NoteValue note_value = {};
         note_value.numOfFiles = key_array[1];
         note_value.fileName = key_array[2];
 
+        state.cache.Note[{ KeyCount, key }] = note_value;
         return note_value;
     } catch (const sol::error &err) {
         throw std::runtime_error(err.what());
@@ -332,12 +377,13 @@ SpriteValue LuaScripting::GetSprite(SkinGroup group, std::string key)
         TryLoadGroup(group);
     }
 
-    try {
-        if (m_states[group].init.lua_state() == NULL) {
-            throw std::runtime_error("Lua state is null");
-        }
+    auto &state = m_states[group];
+    if (auto it = state.cache.Sprite.find(key); it != state.cache.Sprite.end()) {
+        return it->second;
+    }
 
-        sol::table result_table = m_states[group].init();
+    try {
+        sol::table &result_table = GetResult(state);
         sol::table key_array = result_table[SkinDataType::Sprite][key];
 
         SpriteValue sprite_value = {};
@@ -348,6 +394,7 @@ SpriteValue LuaScripting::GetSprite(SkinGroup group, std::string key)
         sprite_value.AnchorPointY = key_array[5];
         sprite_value.FrameTime = key_array[6];
 
+        state.cache.Sprite[key] = sprite_value;
         return sprite_value;
     } catch (const sol::error &err) {
         throw std::runtime_error(err.what());
@@ -356,8 +403,10 @@ SpriteValue LuaScripting::GetSprite(SkinGroup group, std::string key)
 
 void LuaScripting::Arena_SetIndex(int index)
 {
+    // Group scripts may read Game:GetArenaIndex() in init(), so their results are stale too
     if (m_arena != index) {
         m_arena_states.reset();
+        InvalidateCache();
     }
 
     m_arena = index;
@@ -369,8 +418,13 @@ std::vector<NumericValue> LuaScripting::Arena_GetNumeric(std::string key)
         TryLoadArena();
     }
 
+    auto &cache = m_arena_states->cache.Numeric;
+    if (auto it = cache.find(key); it != cache.end()) {
+        return it->second;
+    }
+
     try {
-        sol::table result_table = m_arena_states->init();
+        sol::table &result_table = GetResult(*m_arena_states);
         if (sol::type::table != result_table.get_type()) {
             throw std::runtime_error("expected returned function is table!");
         }
@@ -448,6 +502,7 @@ std::vector<NumericValue> LuaScripting::Arena_GetNumeric(std::string key)
             result.push_back(numeric_value);
         }
 
+        cache[key] = result;
         return result;
     } catch (const sol::error &err) {
         throw std::runtime_error(err.what());
@@ -461,7 +516,12 @@ std::vector<PositionValue> LuaScripting::Arena_GetPosition(std::string key, int
             TryLoadArena();
         }
 
-        sol::table result_table = m_arena_states->init();
+        auto &cache = m_arena_states->cache.Position;
+        if (auto it = cache.find({ KeyCount, key }); it != cache.end()) {
+            return it->second;
+        }
+
+        sol::table &result_table = GetResult(*m_arena_states);
         if (sol::type::table != result_table.get_type()) {
             throw std::runtime_error("expected returned function is table, but got other than table");
         }
@@ -548,6 +608,7 @@ std::vector<PositionValue> LuaScripting::Arena_GetPosition(std::string key, int
             result.push_back(position_value);
         }
 
+        cache[{ KeyCount, key }] = result;
         return result;
     } catch (const sol::error &err) {
         throw std::runtime_error(err.what());
@@ -561,7 +622,12 @@ std::vector<RectInfo> LuaScripting::Arena_GetRect(std::string key)
             TryLoadArena();
         }
 
-        sol::table result_table = m_arena_states->init();
+        auto &cache = m_arena_states->cache.Rect;
+        if (auto it = cache.find(key); it != cache.end()) {
+            return it->second;
+        }
+
+        sol::table &result_table = GetResult(*m_arena_states);
         if (sol::type::table != result_table.get_type()) {
             throw std::runtime_error("expected returned function is table!");
         }
@@ -618,6 +684,7 @@ std::vector<RectInfo> LuaScripting::Arena_GetRect(std::string key)
             result.push_back(rect_info);
         }
 
+        cache[key] = result;
         return result;
     } catch (const sol::error &err) {
         throw std::runtime_error(err.what());
@@ -631,7 +698,12 @@ SpriteValue LuaScripting::Arena_GetSprite(std::string key)
             TryLoadArena();
         }
 
-        sol::table result_table = m_arena_states->init();
+        auto &cache = m_arena_states->cache.Sprite;
+        if (auto it = cache.find(key); it != cache.end()) {
+            return it->second;
+        }
+
+        sol::table &result_table = GetResult(*m_arena_states);
         if (sol::type::table != result_table.get_type()) {
             throw std::runtime_error("expected returned function is table!");
         }
@@ -689,6 +761,7 @@ SpriteValue LuaScripting::Arena_GetSprite(std::string key)
         }
         sprite_value.FrameTime = item6;
 
+        cache[key] = sprite_value;
         return sprite_value;
     } catch (const sol::error &err) {
         throw std::runtime_error(err.what());
@@ -1,6 +1,7 @@
 #pragma once
 #include <filesystem>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 #include "../Resources/SkinStructs.hpp"
@@ -9,6 +10,17 @@
 #include <sol/sol.hpp>
 
 struct IGame;
+
+/* Typed copies of the init() table, converted per key on first lookup */
+struct ScriptCache
+{
+    std::unordered_map<std::string, std::vector<NumericValue>>        Numeric;
+    std::map<std::pair<int, std::string>, std::vector<PositionValue>> Position;
+    std::unordered_map<std::string, std::vector<RectInfo>>            Rect;
+    std::map<std::pair<int, std::string>, NoteValue>                  Note;
+    std::unordered_map<std::string, SpriteValue>                      Sprite;
+};
+
 struct ScriptState
 {
     IGame        *game_state;
@@ -16,6 +28,8 @@ struct ScriptState
     SkinGroup     type;
     sol::function init;
     sol::function update;
+    sol::table    result; // What init() returned, evaluated once until the cache is invalidated
+    ScriptCache   cache;
 };
 
 class LuaScripting
@@ -42,9 +56,11 @@ public:
     void Update(double delta);
 
 private:
-    sol::table LoadLua(sol::state &state, std::filesystem::path path);
-    void       TryLoadGroup(SkinGroup group);
-    void       TryLoadArena();
+    sol::table  LoadLua(sol::state &state, std::filesystem::path path);
+    void        TryLoadGroup(SkinGroup group);
+    void        TryLoadArena();
+    sol::table &GetResult(ScriptState &state);
+    void        InvalidateCache();
 
     std::map<SkinGroup, ScriptState> m_states;
     std::unique_ptr<ScriptState>     m_arena_states;
@@ -1,217 +1,108 @@
 #include "O2Texture.hpp"
-#include "Misc/Lodepng.h"
-
-struct CBITMAPFILEHEADER
-{
-    uint16_t bfType;
-    uint32_t bfSize;
-    uint16_t bfReserved1;
-    uint16_t bfReserved2;
-    uint32_t bfOffBits;
-};
-
-struct CBITMAPINFOHEADER
-{
-    uint32_t biSize;
-    int32_t  biWidth;
-    int32_t  biHeight;
-    uint16_t biPlanes;
-    uint16_t biBitCount;
-    uint32_t biCompression;
-    uint32_t biSizeImage;
-    int32_t  biXPelsPerMeter;
-    int32_t  biYPelsPerMeter;
-    uint32_t biClrUsed;
-    uint32_t biClrImportant;
-};
-
-enum BIT_COMPRESSION {
-    BIT_RGB = 0,
-    BIT_RLE8 = 1,
-    BIT_RLE4 = 2,
-    BIT_BITFIELDS = 3,
-    BIT_JPEG = 4,
-    BIT_PNG = 5,
-    BIT_ALPHABITFIELDS = 6,
-    BIT_CMYK = 11,
-    BIT_CMYKRLE8 = 12,
-    BIT_CMYKRLE4 = 13
-};
-
-struct rgba_t
-{
-    uint8_t R;
-    uint8_t G;
-    uint8_t B;
-    uint8_t A;
-
-    rgba_t(uint16_t value)
+#include <algorithm>
+#include <stdexcept>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define O2TEXTURE_SSE2 1
+#endif
+
+namespace {
+    // OJS pixels are 16-bit X1R5G5B5, the 5-bit channels are widened with bit replication
+    inline uint32_t ConvertPixel(uint16_t value, uint16_t key, bool useKey)
     {
-        B = value & 31;
-        B <<= 3;
+        if (useKey && (value & 0x7FFF) == key) {
+            return 0;
+        }
 
-        value >>= 5;
-        G = value & 31;
-        G <<= 3;
+        uint32_t b = value & 31;
+        uint32_t g = (value >> 5) & 31;
+        uint32_t r = (value >> 10) & 31;
 
-        value >>= 5;
-        R = value & 31;
-        R <<= 3;
+        b = (b << 3) | (b >> 2);
+        g = (g << 3) | (g >> 2);
+        r = (r << 3) | (r >> 2);
 
-        A = 255;
+        return 0xFF000000u | (b << 16) | (g << 8) | r;
     }
 
-    int value()
+    /* Writes count RGBA8 pixels, pixels matching the colour key become fully transparent */
+    void ConvertFrame(const uint8_t *src, size_t count, uint16_t transparencyColor, uint32_t *dst)
     {
-        return (A << 24) | (B << 16) | (G << 8) | R;
-    }
-};
-
-O2Texture::O2Texture()
-{
-}
-
-O2Texture::O2Texture(OJSFrame *frame) : O2Texture()
-{
-    if (frame->FrameSize == 0) {
-        throw std::invalid_argument("Invalid frame buffer size!");
-    }
-
-    if (frame->Buffer == nullptr) {
-        throw std::invalid_argument("Invalid buffer pointer!");
-    }
+        bool     useKey = transparencyColor != 0;
+        uint16_t key = transparencyColor & 0x7FFF;
+        size_t   i = 0;
 
-    int frameSize = frame->FrameSize;
-    if (frameSize % 2 != 0) {
-        frameSize += 1;
-    }
-
-    int biStride = (frame->Width * 32 + 31) / 32 * 4;
-    int biSizeImage = abs(biStride) * frame->Height;
+#if O2TEXTURE_SSE2
+        const __m128i mask5 = _mm_set1_epi16(31);
+        const __m128i mask15 = _mm_set1_epi16(0x7FFF);
+        const __m128i alpha = _mm_set1_epi16((short)0xFF00);
+        const __m128i keyVec = _mm_set1_epi16((short)key);
+        const __m128i useKeyVec = _mm_set1_epi16(useKey ? -1 : 0);
 
-    std::vector<uint8_t> raw_data(frameSize);
+        for (; i + 8 <= count; i += 8) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(src + i * 2));
 
-    memcpy(raw_data.data(), frame->Buffer, frame->FrameSize);
+            __m128i b = _mm_and_si128(v, mask5);
+            __m128i g = _mm_and_si128(_mm_srli_epi16(v, 5), mask5);
+            __m128i r = _mm_and_si128(_mm_srli_epi16(v, 10), mask5);
 
-    uint8_t *m_pBuffer;
-    size_t   m_bufferSize;
+            b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+            g = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
+            r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
 
-    if (frame->TransparencyColor != 0) {
-        std::vector<uint8_t> image_data(biSizeImage);
-        rgba_t               trans(frame->TransparencyColor);
+            // Per 16-bit lane: low byte R | high byte G, and low byte B | high byte A
+            __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+            __m128i ba = _mm_or_si128(b, alpha);
 
-        int offset16 = 0;
-        int offset32 = 0;
-        while (offset16 + 2 <= frameSize) {
-            uint16_t tmp16 = *(uint16_t *)(raw_data.data() + offset16);
-            offset16 += 2;
+            __m128i keyed = _mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(v, mask15), keyVec), useKeyVec);
 
-            rgba_t pixel(tmp16);
-            if (frame->TransparencyColor != 0 && pixel.R == trans.R && pixel.G == trans.G && pixel.B == trans.B) {
+            __m128i lo = _mm_unpacklo_epi16(rg, ba);
+            __m128i hi = _mm_unpackhi_epi16(rg, ba);
 
-                pixel.R = 0;
-                pixel.G = 0;
-                pixel.B = 0;
-                pixel.A = 0;
-            }
+            lo = _mm_andnot_si128(_mm_unpacklo_epi16(keyed, keyed), lo);
+            hi = _mm_andnot_si128(_mm_unpackhi_epi16(keyed, keyed), hi);
 
-            *(uint32_t *)(&image_data[0] + offset32) = pixel.value();
-            offset32 += 4;
+            _mm_storeu_si128((__m128i *)(dst + i), lo);
+            _mm_storeu_si128((__m128i *)(dst + i + 4), hi);
         }
+#endif
 
-        std::vector<uint8_t> result_buffer;
-        uint32_t             error = lodepng::encode(result_buffer, image_data, frame->Width, frame->Height, LCT_RGBA, 8);
-        if (error != 0) {
-            throw std::runtime_error("Failed to encode the image");
-        }
+        for (; i < count; i++) {
+            uint16_t value;
+            memcpy(&value, src + i * 2, sizeof(value));
 
-        m_pBuffer = new uint8_t[result_buffer.size()];
-        if (!m_pBuffer) {
-            throw std::runtime_error("Out of memory");
+            dst[i] = ConvertPixel(value, key, useKey);
         }
+    }
+} // namespace
 
-        memcpy(m_pBuffer, result_buffer.data(), result_buffer.size());
-        m_bufferSize = result_buffer.size();
-    } else {
-        CBITMAPFILEHEADER bmfHeader = { 0 };
-        CBITMAPINFOHEADER bi = { 0 };
-
-        bi.biSize = sizeof(BITMAPINFOHEADER);
-        bi.biWidth = frame->Width;
-        bi.biHeight = frame->Height;
-        bi.biPlanes = 1;
-        bi.biBitCount = 16;
-        bi.biCompression = BIT_COMPRESSION::BIT_RGB;
-        bi.biSizeImage = frame->Width * frame->Height * 2;
-        bi.biXPelsPerMeter = 0;
-        bi.biYPelsPerMeter = 0;
-        bi.biClrUsed = 0;
-        bi.biClrImportant = 0;
-
-        bmfHeader.bfType = 0x4D42;
-        bmfHeader.bfSize = sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER) + bi.biSizeImage;
-        bmfHeader.bfReserved1 = 0;
-        bmfHeader.bfReserved2 = 0;
-
-        int biStride = (frame->Width * bi.biBitCount + 31) / 32 * 4;
-        int biSizeImage = abs(biStride) * frame->Height;
-
-        bmfHeader.bfOffBits = (uint32_t)sizeof(BITMAPFILEHEADER) + (uint32_t)sizeof(BITMAPINFOHEADER);
-
-        uint8_t *data;
-        int      totalSize = 0;
-
-        int strideDiff = biStride / bi.biWidth * bi.biWidth;
-        if (strideDiff == biStride) {
-            data = new uint8_t[bi.biSizeImage];
-            if (!data) {
-                throw std::bad_alloc();
-            }
-
-            totalSize = bi.biSizeImage;
-
-            memcpy(data, frame->Buffer, bi.biSizeImage);
-        } else {
-            data = new uint8_t[biSizeImage];
-            if (!data) {
-                throw std::bad_alloc();
-            }
-
-            totalSize = biSizeImage;
-            memset(data, 0, biSizeImage);
-
-            for (int y = 0; y < bi.biHeight; y++) {
-                memcpy(data + y * biStride, frame->Buffer + y * strideDiff, strideDiff);
-            }
-        }
+O2Texture::O2Texture()
+{
+}
 
-        uint8_t *tmp = new uint8_t[totalSize];
-        if (!tmp) {
-            throw std::bad_alloc();
-        }
+O2Texture::O2Texture(OJSFrame *frame) : O2Texture()
+{
+    if (frame->FrameSize == 0) {
+        throw std::invalid_argument("Invalid frame buffer size!");
+    }
 
-        if (biStride > 0) {
-            for (int y = 0; y < bi.biHeight; y++) {
-                memcpy(tmp + y * biStride, data + (bi.biHeight - y - 1) * biStride, biStride);
-            }
-        } else {
-            memcpy(tmp, data, totalSize);
-        }
+    if (frame->Buffer == nullptr) {
+        throw std::invalid_argument("Invalid buffer pointer!");
+    }
 
-        int size = sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER) + totalSize;
-        m_pBuffer = new uint8_t[size];
-        if (!m_pBuffer) {
-            throw std::bad_alloc();
-        }
+    if (frame->Width <= 0 || frame->Height <= 0) {
+        throw std::invalid_argument("Invalid frame dimension!");
+    }
 
-        memcpy(m_pBuffer, &bmfHeader, sizeof(BITMAPFILEHEADER));
-        memcpy(m_pBuffer + sizeof(BITMAPFILEHEADER), &bi, sizeof(BITMAPINFOHEADER));
-        memcpy(m_pBuffer + sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER), tmp, totalSize);
+    // Frames are stored top-down with tightly packed rows, so they map 1:1 onto an RGBA texture
+    size_t               pixelCount = (size_t)frame->Width * frame->Height;
+    std::vector<uint32_t> pixels(pixelCount, 0);
 
-        m_bufferSize = size;
-    }
+    ConvertFrame(frame->Buffer, std::min(pixelCount, (size_t)frame->FrameSize / 2), frame->TransparencyColor, pixels.data());
 
-    Texture2D::LoadImageResources(m_pBuffer, m_bufferSize);
+    LoadRawResources((const uint8_t *)pixels.data(), frame->Width, frame->Height);
     LoadImageResources(frame);
 
     m_bDisposeTexture = true;
@@ -1,11 +1,13 @@
 #include "RhythmEngine.hpp"
 #include <Logs.h>
+#include <algorithm>
 #include <filesystem>
 #include <numeric>
 #include <unordered_map>
 
 #include "../EnvironmentSetup.hpp"
 #include "Configuration.h"
+#include "Inputs/InputManager.h"
 #include "Rendering/Window.h"
 
 #include "GameAudioSampleCache.hpp"
@@ -16,18 +18,13 @@
 
 #include "Judgements/BeatBasedJudge.h"
 #include "Judgements/MsBasedJudge.h"
+#include "Misc/Profiler.h"
 
 #include <chrono>
 #include <codecvt>
 
 #define MAX_BUFFER_TXT_SIZE 256
 
-struct ManiaKeyState
-{
-    Keys key;
-    bool isPressed;
-};
-
 namespace {
     std::vector<NoteImageType> Key2Type = {
         NoteImageType::LANE_1,
@@ -49,17 +46,12 @@ namespace {
         NoteImageType::HOLD_LANE_7,
     };
 
-    std::unordered_map<int, ManiaKeyState> KeyMapping = {
-        { 0, { Keys::A, false } },
-        { 1, { Keys::S, false } },
-        { 2, { Keys::D, false } },
-        { 3, { Keys::Space, false } },
-        { 4, { Keys::J, false } },
-        { 5, { Keys::K, false } },
-        { 6, { Keys::L, false } },
-    };
+    const Keys kDefaultKeys[7] = { Keys::A, Keys::S, Keys::D, Keys::Space, Keys::J, Keys::K, Keys::L };
 
     int trackOffset[] = { 5, 33, 55, 82, 114, 142, 164 };
+
+    // A stall longer than this is not worth judging retroactively, notes before it were already missed
+    const double kMaxInputLateness = 100.0;
 } // namespace
 
 RhythmEngine::RhythmEngine()
@@ -72,6 +64,8 @@ RhythmEngine::RhythmEngine()
     m_scrollSpeed = 180;
 
     m_timingPositionMarkers = std::vector<double>();
+
+    SetKeys(kDefaultKeys);
 }
 
 RhythmEngine::~RhythmEngine()
@@ -173,7 +167,7 @@ bool RhythmEngine::Load(Chart *chart)
         try {
             m_audioVolume = std::stoi(audioVolume);
         } catch (const std::invalid_argument &) {
-            Logs::Puts("[Gameplay] Invalid volume: %s reverting to 100 value", audioVolume.c_str());
+            Logs::Write(LogLevel::Warning, "Gameplay", "Invalid volume: %s reverting to 100 value", audioVolume.c_str());
             m_audioVolume = 100;
         }
     }
@@ -185,7 +179,7 @@ bool RhythmEngine::Load(Chart *chart)
         }
 
         catch (const std::invalid_argument &) {
-            Logs::Puts("[Gameplay] Invalid offset: %s reverting to 0 value", audioOffset.c_str());
+            Logs::Write(LogLevel::Warning, "Gameplay", "Invalid offset: %s reverting to 0 value", audioOffset.c_str());
             m_audioOffset = 0;
         }
     }
@@ -198,7 +192,7 @@ bool RhythmEngine::Load(Chart *chart)
         }
 
         catch (const std::invalid_argument &) {
-            Logs::Puts("[Gameplay] Invalid auto sound: %s reverting to 0 value", autoSound.c_str());
+            Logs::Write(LogLevel::Warning, "Gameplay", "Invalid auto sound: %s reverting to 0 value", autoSound.c_str());
             IsAutoSound = false;
         }
     }
@@ -208,7 +202,7 @@ bool RhythmEngine::Load(Chart *chart)
         try {
             m_scrollSpeed = std::stoi(noteSpeed);
         } catch (const std::invalid_argument &) {
-            Logs::Puts("[Gameplay] Invalid notespeed: %s reverting to 210 value", noteSpeed.c_str());
+            Logs::Write(LogLevel::Warning, "Gameplay", "Invalid notespeed: %s reverting to 210 value", noteSpeed.c_str());
             m_scrollSpeed = 210;
         }
     }
@@ -303,10 +297,14 @@ bool RhythmEngine::Load(Chart *chart)
     return true;
 }
 
-void RhythmEngine::SetKeys(Keys *keys)
+void RhythmEngine::SetKeys(const Keys *keys)
 {
+    std::fill(std::begin(m_keyLanes), std::end(m_keyLanes), 0);
+
     for (int i = 0; i < 7; i++) {
-        KeyMapping[i].key = keys[i];
+        if (keys[i] != Keys::INVALID_KEY) {
+            m_keyLanes[static_cast<uint8_t>(keys[i])] |= 1 << i;
+        }
     }
 }
 
@@ -315,6 +313,10 @@ bool RhythmEngine::Start()
     m_currentAudioPosition -= 3000;
     m_state = GameState::Playing;
 
+    // Whatever was pressed before the song started must not reach the tracks
+    InputManager::GetInstance()->FlushKeyEvents();
+    m_heldLanes = 0;
+
     m_startClock = std::chrono::system_clock::now();
     return true;
 }
@@ -332,6 +334,8 @@ bool RhythmEngine::Ready()
 
 void RhythmEngine::Update(double delta)
 {
+    PROFILE_SCOPE("RhythmEngine::Update");
+
     if (m_state == GameState::NotGame || m_state == GameState::PosGame)
         return;
 
@@ -362,6 +366,27 @@ void RhythmEngine::Update(double delta)
 
     m_timingLineManager->Update(delta);
 
+    // Judge every key at the time it changed instead of when this tick got around to it
+    double   gamePosition = m_currentAudioGamePosition;
+    uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    KeyState state;
+    while (InputManager::GetInstance()->PollKeyEvent(state)) {
+        if (!m_is_autoplay) {
+            double lateness = state.time < now ? (now - state.time) / 1000000.0 : 0.0;
+
+            m_currentAudioGamePosition = gamePosition - std::min(lateness, kMaxInputLateness) * m_rate;
+            ProcessKeyEvent(state);
+        }
+    }
+
+    m_currentAudioGamePosition = gamePosition;
+
+    // The ring filled up during a stall and dropped transitions, a lost release would leave a hold stuck
+    if (InputManager::GetInstance()->TakeKeyEventOverflow() && !m_is_autoplay) {
+        ResyncKeys();
+    }
+
     for (auto &it : m_tracks) {
         it->Update(delta);
     }
@@ -371,7 +396,7 @@ void RhythmEngine::Update(double delta)
         auto &sample = m_autoSamples[i];
         if (m_currentAudioPosition >= sample.StartTime) {
             if (sample.StartTime - m_currentAudioPosition < 5) {
-                GameAudioSampleCache::Play(sample.Index, (int)round(sample.Volume * m_audioVolume), (int)round(sample.Pan * 100));
+                GameAudioSampleCache::Play(sample.Index, (int)round(sample.Volume * m_audioVolume), (int)round(sample.Pan * 100), m_currentAudioPosition - sample.StartTime);
             }
 
             m_currentSampleIndex++;
@@ -415,6 +440,7 @@ void RhythmEngine::Input(double delta)
         return;
 }
 
+/* Only the scroll speed hotkeys, lane input is read from the InputManager key ring in Update */
 void RhythmEngine::OnKeyDown(const KeyState &state)
 {
     if (m_state == GameState::NotGame || m_state == GameState::PosGame)
@@ -425,34 +451,58 @@ void RhythmEngine::OnKeyDown(const KeyState &state)
     } else if (state.key == Keys::F4) {
         m_scrollSpeed += 10;
     }
+}
 
-    if (!m_is_autoplay) {
-        for (auto &key : KeyMapping) {
-            if (key.second.key == state.key) {
-                key.second.isPressed = true;
+void RhythmEngine::ProcessKeyEvent(const KeyState &state)
+{
+    uint8_t lanes = m_keyLanes[static_cast<uint8_t>(state.key)];
 
-                if (key.first < m_tracks.size()) {
-                    m_tracks[key.first]->OnKeyDown();
-                }
-            }
+    for (int lane = 0; lanes; lane++, lanes >>= 1) {
+        if (!(lanes & 1) || lane >= m_tracks.size()) {
+            continue;
+        }
+
+        bool    down = state.type == KeyEventType::KEY_DOWN;
+        uint8_t bit = static_cast<uint8_t>(1 << lane);
+
+        // Already in that state after a resync
+        if (((m_heldLanes & bit) != 0) == down) {
+            continue;
+        }
+
+        m_heldLanes ^= bit;
+
+        if (down) {
+            m_tracks[lane]->OnKeyDown();
+        } else {
+            m_tracks[lane]->OnKeyUp();
         }
     }
 }
 
-void RhythmEngine::OnKeyUp(const KeyState &state)
+void RhythmEngine::ResyncKeys()
 {
-    if (m_state == GameState::NotGame || m_state == GameState::PosGame)
-        return;
+    auto input = InputManager::GetInstance();
 
-    if (!m_is_autoplay) {
-        for (auto &key : KeyMapping) {
-            if (key.second.key == state.key) {
-                key.second.isPressed = false;
+    uint8_t held = 0;
+    for (int key = 0; key < 256; key++) {
+        if (m_keyLanes[key] && input->IsKeyDown(static_cast<Keys>(key))) {
+            held |= m_keyLanes[key];
+        }
+    }
 
-                if (key.first < m_tracks.size()) {
-                    m_tracks[key.first]->OnKeyUp();
-                }
-            }
+    uint8_t changed = held ^ m_heldLanes;
+    m_heldLanes = held;
+
+    for (int lane = 0; changed; lane++, changed >>= 1) {
+        if (!(changed & 1) || lane >= m_tracks.size()) {
+            continue;
+        }
+
+        if (held & (1 << lane)) {
+            m_tracks[lane]->OnKeyDown();
+        } else {
+            m_tracks[lane]->OnKeyUp();
         }
     }
 }
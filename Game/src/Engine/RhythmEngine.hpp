@@ -32,7 +32,7 @@ public:
     ~RhythmEngine();
 
     bool Load(Chart *chart);
-    void SetKeys(Keys *keys);
+    void SetKeys(const Keys *keys);
 
     bool Start();
     bool Stop();
@@ -43,7 +43,6 @@ public:
     void Input(double delta);
 
     void OnKeyDown(const KeyState &key);
-    void OnKeyUp(const KeyState &key);
 
     void ListenKeyEvent(std::function<void(GameTrackEvent)> callback);
 
@@ -89,6 +88,8 @@ private:
     void            UpdateVirtualResolution();
     void            CreateTimingMarkers();
     ReplayFrameData GetAutoplayAtThisFrame(double offset);
+    void            ProcessKeyEvent(const KeyState &state);
+    void            ResyncKeys();
 
     void Release();
 
@@ -127,6 +128,10 @@ private:
     float m_laneSize[7];
     float m_lanePos[7];
 
+    /* Lane bitmask for every Keys value, so a key event never searches the mapping */
+    uint8_t m_keyLanes[256] = {};
+    uint8_t m_heldLanes = 0; // Lanes the tracks last saw pressed
+
     std::filesystem::path                                         m_audioPath = "";
     Chart                                                        *m_currentChart;
     Vector2                                                       m_virtualResolution = { 0, 0 };
@@ -5,6 +5,7 @@
 
 #include "../Data/Util/Util.hpp"
 #include "Misc/mINI.h"
+#include "SkinManager.hpp"
 
 SkinConfig::SkinConfig(std::string filePath, int keyCount)
 {
@@ -29,9 +30,8 @@ void SkinConfig::Load(std::filesystem::path path, int keyCount)
         throw std::runtime_error("File does not exist");
     }
 
-    mINI::INIFile      f(path);
     mINI::INIStructure ini;
-    f.read(ini);
+    SkinManager::GetInstance()->ReadIni(path, ini);
 
     for (auto const &[key, value] : ini["Numerics"]) {
         auto rows = splitString(value, '|');
@@ -81,7 +81,7 @@ void SkinConfig::Load(std::filesystem::path path, int keyCount)
                 e.FillWithZero = false;
             }
 
-            m_numericValues[key].push_back(std::move(e));
+            m_numericValues[SkinKeys::Intern(key)].push_back(std::move(e));
         }
     }
 
@@ -114,7 +114,7 @@ void SkinConfig::Load(std::filesystem::path path, int keyCount)
                 e.RGB[2] = std::stoi(splitRGB[2]);
             }
 
-            m_positionValues[key].push_back(std::move(e));
+            m_positionValues[SkinKeys::Intern(key)].push_back(std::move(e));
         }
     }
 
@@ -130,7 +130,7 @@ void SkinConfig::Load(std::filesystem::path path, int keyCount)
         e.numOfFiles = std::stoi(split[0]);
         e.fileName = split[1];
 
-        m_noteValues[key] = std::move(e);
+        m_noteValues[SkinKeys::Intern(key)] = std::move(e);
     }
 
     for (auto const &[key, value] : ini["Sprites"]) {
@@ -153,7 +153,7 @@ void SkinConfig::Load(std::filesystem::path path, int keyCount)
             e.FrameTime = std::stof(split[5]);
         }
 
-        m_spriteValues[key] = std::move(e);
+        m_spriteValues[SkinKeys::Intern(key)] = std::move(e);
     }
 
     for (auto const &[key, value] : ini["rects"]) {
@@ -167,68 +167,106 @@ void SkinConfig::Load(std::filesystem::path path, int keyCount)
             e.Width = std::stoi(split[2]);
             e.Height = std::stoi(split[3]);
 
-            m_rectValues[key].push_back(std::move(e));
+            m_rectValues[SkinKeys::Intern(key)].push_back(std::move(e));
         }
     }
 }
 
 SkinConfig::~SkinConfig()
 {
-    m_positionValues.clear();
-    m_numericValues.clear();
+    m_positionValues.Clear();
+    m_numericValues.Clear();
 }
 
-std::vector<PositionValue> &SkinConfig::GetPosition(std::string key)
+std::vector<PositionValue> &SkinConfig::GetPosition(SkinKey key)
 {
-    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
-
-    if (m_positionValues.find(key) == m_positionValues.end()) {
-        throw std::runtime_error("Position key not found: " + key);
+    auto value = m_positionValues.Find(key);
+    if (!value) {
+        throw std::runtime_error("Position key not found: " + SkinKeys::Name(key));
     }
 
-    return m_positionValues[key];
+    return *value;
 }
 
-std::vector<RectInfo> &SkinConfig::GetRect(std::string key)
+std::vector<RectInfo> &SkinConfig::GetRect(SkinKey key)
 {
-    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    auto value = m_rectValues.Find(key);
+    if (!value) {
+        throw std::runtime_error("Rect key not found: " + SkinKeys::Name(key));
+    }
 
-    if (m_rectValues.find(key) == m_rectValues.end()) {
-        throw std::runtime_error("Rect key not found: " + key);
+    return *value;
+}
+
+NoteValue &SkinConfig::GetNote(SkinKey key)
+{
+    auto value = m_noteValues.Find(key);
+    if (!value) {
+        throw std::runtime_error("Note key not found: " + SkinKeys::Name(key));
     }
 
-    return m_rectValues[key];
+    return *value;
 }
 
-NoteValue &SkinConfig::GetNote(std::string key)
+std::vector<NumericValue> &SkinConfig::GetNumeric(SkinKey key)
 {
-    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    auto value = m_numericValues.Find(key);
+    if (!value) {
+        throw std::runtime_error("Numeric key not found: " + SkinKeys::Name(key));
+    }
+
+    return *value;
+}
 
-    if (m_noteValues.find(key) == m_noteValues.end()) {
-        throw std::runtime_error("Sprite key not found: " + key);
+SpriteValue &SkinConfig::GetSprite(SkinKey key)
+{
+    auto value = m_spriteValues.Find(key);
+    if (!value) {
+        throw std::runtime_error("Sprite key not found: " + SkinKeys::Name(key));
     }
 
-    return m_noteValues[key];
+    return *value;
 }
 
-std::vector<NumericValue> &SkinConfig::GetNumeric(std::string key)
+std::vector<PositionValue> &SkinConfig::GetPosition(std::string key)
 {
-    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    return GetPosition(SkinKeys::Intern(key));
+}
 
-    if (m_numericValues.find(key) == m_numericValues.end()) {
-        throw std::runtime_error("Numeric key not found: " + key);
-    }
+std::vector<RectInfo> &SkinConfig::GetRect(std::string key)
+{
+    return GetRect(SkinKeys::Intern(key));
+}
 
-    return m_numericValues[key];
+NoteValue &SkinConfig::GetNote(std::string key)
+{
+    return GetNote(SkinKeys::Intern(key));
+}
+
+std::vector<NumericValue> &SkinConfig::GetNumeric(std::string key)
+{
+    return GetNumeric(SkinKeys::Intern(key));
 }
 
 SpriteValue &SkinConfig::GetSprite(std::string key)
 {
-    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    return GetSprite(SkinKeys::Intern(key));
+}
 
-    if (m_spriteValues.find(key) == m_spriteValues.end()) {
-        throw std::runtime_error("Sprite key not found: " + key);
+bool SkinConfig::Contains(SkinDataType type, SkinKey key) const
+{
+    switch (type) {
+        case SkinDataType::Numeric:
+            return m_numericValues.Contains(key);
+        case SkinDataType::Position:
+            return m_positionValues.Contains(key);
+        case SkinDataType::Rect:
+            return m_rectValues.Contains(key);
+        case SkinDataType::Note:
+            return m_noteValues.Contains(key);
+        case SkinDataType::Sprite:
+            return m_spriteValues.Contains(key);
     }
 
-    return m_spriteValues[key];
+    return false;
 }
@@ -1,10 +1,10 @@
 #pragma once
 #include <filesystem>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "../Resources/SkinStructs.hpp"
+#include "SkinKeys.hpp"
 
 class SkinConfig
 {
@@ -14,18 +14,26 @@ public:
     SkinConfig(std::filesystem::path path, int keyCount);
     ~SkinConfig();
 
+    std::vector<NumericValue>  &GetNumeric(SkinKey key);
+    std::vector<PositionValue> &GetPosition(SkinKey key);
+    std::vector<RectInfo>      &GetRect(SkinKey key);
+    NoteValue                  &GetNote(SkinKey key);
+    SpriteValue                &GetSprite(SkinKey key);
+
     std::vector<NumericValue>  &GetNumeric(std::string key);
     std::vector<PositionValue> &GetPosition(std::string key);
     std::vector<RectInfo>      &GetRect(std::string key);
     NoteValue                  &GetNote(std::string key);
     SpriteValue                &GetSprite(std::string key);
 
+    bool Contains(SkinDataType type, SkinKey key) const;
+
 private:
     void Load(std::filesystem::path path, int keyCount);
 
-    std::unordered_map<std::string, std::vector<NumericValue>>  m_numericValues;
-    std::unordered_map<std::string, std::vector<PositionValue>> m_positionValues;
-    std::unordered_map<std::string, SpriteValue>                m_spriteValues;
-    std::unordered_map<std::string, std::vector<RectInfo>>      m_rectValues;
-    std::unordered_map<std::string, NoteValue>                  m_noteValues;
+    SkinTable<std::vector<NumericValue>>  m_numericValues;
+    SkinTable<std::vector<PositionValue>> m_positionValues;
+    SkinTable<SpriteValue>                m_spriteValues;
+    SkinTable<std::vector<RectInfo>>      m_rectValues;
+    SkinTable<NoteValue>                  m_noteValues;
 };
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "SkinKeys.hpp"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    using KeyTable = std::map<SkinGroup, std::vector<std::pair<SkinDataType, SkinKey>>>;
+
+    struct Registry
+    {
+        std::mutex                               Lock;
+        std::unordered_map<std::string, SkinKey> Lookup;
+        std::vector<std::string>                 Names; // Spelling from Require(), else the first seen
+        KeyTable                                 Requirements;
+        KeyTable                                 Optionals;
+    };
+
+    // Function local so scenes can intern their keys during static initialization
+    Registry &GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    std::string Lower(std::string_view name)
+    {
+        std::string result(name);
+        std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+        return result;
+    }
+
+    SkinKey Register(KeyTable Registry::*table, SkinGroup group, SkinDataType type, std::string_view name)
+    {
+        SkinKey key = SkinKeys::Intern(name);
+        auto   &registry = GetRegistry();
+
+        std::lock_guard<std::mutex> lock(registry.Lock);
+
+        // Code spelling wins over whatever an INI file interned first
+        registry.Names[key] = std::string(name);
+
+        auto &entries = (registry.*table)[group];
+        if (std::find(entries.begin(), entries.end(), std::make_pair(type, key)) == entries.end()) {
+            entries.push_back({ type, key });
+        }
+
+        return key;
+    }
+
+    std::vector<std::pair<SkinDataType, SkinKey>> Collect(KeyTable Registry::*table, SkinGroup group)
+    {
+        auto &registry = GetRegistry();
+
+        std::lock_guard<std::mutex> lock(registry.Lock);
+
+        auto it = (registry.*table).find(group);
+        return it != (registry.*table).end() ? it->second : std::vector<std::pair<SkinDataType, SkinKey>>();
+    }
+} // namespace
+
+SkinKey SkinKeys::Intern(std::string_view name)
+{
+    auto &registry = GetRegistry();
+    auto  lower = Lower(name);
+
+    std::lock_guard<std::mutex> lock(registry.Lock);
+
+    auto it = registry.Lookup.find(lower);
+    if (it != registry.Lookup.end()) {
+        return it->second;
+    }
+
+    SkinKey key = static_cast<SkinKey>(registry.Names.size());
+    registry.Names.emplace_back(name);
+    registry.Lookup.emplace(std::move(lower), key);
+
+    return key;
+}
+
+SkinKey SkinKeys::Find(std::string_view name)
+{
+    auto &registry = GetRegistry();
+    auto  lower = Lower(name);
+
+    std::lock_guard<std::mutex> lock(registry.Lock);
+
+    auto it = registry.Lookup.find(lower);
+    return it != registry.Lookup.end() ? it->second : Invalid;
+}
+
+std::string SkinKeys::Name(SkinKey key)
+{
+    auto &registry = GetRegistry();
+
+    std::lock_guard<std::mutex> lock(registry.Lock);
+    return key < registry.Names.size() ? registry.Names[key] : std::string();
+}
+
+SkinKey SkinKeys::Require(SkinGroup group, SkinDataType type, std::string_view name)
+{
+    return Register(&Registry::Requirements, group, type, name);
+}
+
+SkinKey SkinKeys::Optional(SkinGroup group, SkinDataType type, std::string_view name)
+{
+    return Register(&Registry::Optionals, group, type, name);
+}
+
+std::vector<std::pair<SkinDataType, SkinKey>> SkinKeys::GetRequirements(SkinGroup group)
+{
+    return Collect(&Registry::Requirements, group);
+}
+
+std::vector<std::pair<SkinDataType, SkinKey>> SkinKeys::GetOptionals(SkinGroup group)
+{
+    return Collect(&Registry::Optionals, group);
+}
+
+const char *SkinKeys::TypeName(SkinDataType type)
+{
+    switch (type) {
+        case SkinDataType::Numeric:
+            return "Numerics";
+        case SkinDataType::Position:
+            return "Positions";
+        case SkinDataType::Rect:
+            return "Rects";
+        case SkinDataType::Note:
+            return "Notes";
+        case SkinDataType::Sprite:
+            return "Sprites";
+    }
+
+    return "Unknown";
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../Resources/SkinStructs.hpp"
+
+/*
+ * Skin keys are interned into small integer handles, case-insensitively
+ * like the INI reader, so a loaded skin answers lookups by array index.
+ * Handles stay valid for the lifetime of the process.
+ */
+using SkinKey = uint32_t;
+
+namespace SkinKeys {
+    constexpr SkinKey Invalid = UINT32_MAX;
+
+    SkinKey Intern(std::string_view name);
+
+    /* Invalid when the name was never interned, does not grow the table */
+    SkinKey Find(std::string_view name);
+
+    /* Spelling the key was registered with, Lua tables are case-sensitive */
+    std::string Name(SkinKey key);
+
+    /* Interns the key and records that scenes read it from the group, checked when the group's INI is loaded */
+    SkinKey Require(SkinGroup group, SkinDataType type, std::string_view name);
+
+    /* Same as Require for a key the scene can do without, a missing one is only reported */
+    SkinKey Optional(SkinGroup group, SkinDataType type, std::string_view name);
+
+    std::vector<std::pair<SkinDataType, SkinKey>> GetRequirements(SkinGroup group);
+    std::vector<std::pair<SkinDataType, SkinKey>> GetOptionals(SkinGroup group);
+
+    const char *TypeName(SkinDataType type);
+} // namespace SkinKeys
+
+/* Sparse SkinKey -> T map backed by a slot array, values are stored densely */
+template <typename T>
+class SkinTable
+{
+public:
+    T *Find(SkinKey key)
+    {
+        if (key >= m_slots.size() || m_slots[key] < 0) {
+            return nullptr;
+        }
+
+        return &m_values[m_slots[key]];
+    }
+
+    bool Contains(SkinKey key) const
+    {
+        return key < m_slots.size() && m_slots[key] >= 0;
+    }
+
+    T &operator[](SkinKey key)
+    {
+        if (key >= m_slots.size()) {
+            m_slots.resize(key + 1, -1);
+        }
+
+        if (m_slots[key] < 0) {
+            m_slots[key] = static_cast<int32_t>(m_values.size());
+            m_values.emplace_back();
+        }
+
+        return m_values[m_slots[key]];
+    }
+
+    void Clear()
+    {
+        m_slots.clear();
+        m_values.clear();
+    }
+
+private:
+    std::vector<int32_t> m_slots;
+    std::vector<T>       m_values;
+};
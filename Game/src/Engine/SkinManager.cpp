@@ -1,4 +1,12 @@
 #include "SkinManager.hpp"
+#include "Texture/TextureCache.h"
+#include "Texture/TexturePack.h"
+#include <Logs.h>
+#include <algorithm>
+
+namespace {
+    const char *kSkinPackName = "Skin.pack";
+}
 
 SkinManager *SkinManager::m_instance = nullptr;
 
@@ -15,9 +23,25 @@ void SkinManager::LoadSkin(std::string skinName)
     auto skinPath = std::filesystem::current_path() / "Skins";
     auto selectedSkin = skinPath / skinName;
 
-    mINI::INIFile f(selectedSkin / "GameSkin.ini");
+    // Reopened on every load, a rebuilt pack or edited source files are picked up by ReloadSkin
+    m_pack = std::make_shared<TexturePack>();
+    if (!m_pack->Open(selectedSkin / kSkinPackName, selectedSkin)) {
+        m_pack.reset();
+    }
+
+    TextureCache::GetInstance()->SetPack(m_pack);
+
     ini = {};
-    f.read(ini);
+    ReadIni(selectedSkin / "GameSkin.ini", ini);
+
+    m_props.Clear();
+    for (auto const &[section, values] : ini) {
+        for (auto const &[key, value] : values) {
+            m_props[PropKey(section, key)] = value;
+        }
+    }
+
+    m_skinConfigs.clear();
 
     m_expected_directory = {
         { SkinGroup::Playing, "Playing" },
@@ -44,13 +68,20 @@ void SkinManager::LoadSkin(std::string skinName)
 
     if (m_useLua) {
         m_luaScripting = std::make_unique<LuaScripting>(selectedSkin / "Scripts");
+        return;
+    }
+
+    // Report broken skins as soon as they load, scenes call Validate() again before building their layout
+    for (auto group : { SkinGroup::Notes, SkinGroup::Playing, SkinGroup::MainMenu, SkinGroup::SongSelect }) {
+        std::string error;
+        if (!Validate(group, error)) {
+            Logs::Write(LogLevel::Warning, "SkinManager", "%s", error.c_str());
+        }
     }
 }
 
 void SkinManager::ReloadSkin()
 {
-    m_skinConfigs.clear();
-
     LoadSkin(m_currentSkin);
 }
 
@@ -59,8 +90,8 @@ LaneInfo SkinManager::GetLaneInfo()
     LaneInfo info = {};
 
     try {
-        info.HitPosition = std::stoi(ini["Game"]["HitPos"]);
-        info.LaneOffset = std::stoi(ini["Game"]["LaneOffset"]);
+        info.HitPosition = std::stoi(GetSkinProp(PropKey("Game", "HitPos")));
+        info.LaneOffset = std::stoi(GetSkinProp(PropKey("Game", "LaneOffset")));
     } catch (const std::invalid_argument &) {
         std::cout << "Invalid argument for HitPos or LaneOffset" << std::endl;
     }
@@ -70,9 +101,93 @@ LaneInfo SkinManager::GetLaneInfo()
 
 std::string SkinManager::GetSkinProp(std::string group, std::string key, std::string defaultValue)
 {
-    auto value = ini[group][key];
+    SkinKey prop = SkinKeys::Find(group + "." + key);
+    if (prop == SkinKeys::Invalid) {
+        return defaultValue;
+    }
+
+    return GetSkinProp(prop, defaultValue);
+}
+
+std::string SkinManager::GetSkinProp(SkinKey prop, std::string defaultValue)
+{
+    auto value = m_props.Find(prop);
+
+    return value && value->size() ? *value : defaultValue;
+}
+
+SkinKey SkinManager::PropKey(std::string_view group, std::string_view key)
+{
+    std::string name;
+    name.reserve(group.size() + key.size() + 1);
+    name.append(group).append(".").append(key);
+
+    return SkinKeys::Intern(name);
+}
+
+bool SkinManager::Validate(SkinGroup group, std::string &error)
+{
+    // Lua skins build their tables in init(), there is nothing to check before a lookup runs it
+    if (m_luaScripting) {
+        return true;
+    }
+
+    auto requirements = SkinKeys::GetRequirements(group);
+    auto optionals = SkinKeys::GetOptionals(group);
+    if (requirements.empty() && optionals.empty()) {
+        return true;
+    }
+
+    SkinConfig *config = nullptr;
+    try {
+        config = GetConfig(group);
+    } catch (const std::runtime_error &e) {
+        error = m_expected_skin_config[group] + ": " + e.what();
+        return false;
+    } catch (const std::logic_error &e) {
+        // std::stoi on a malformed or out of range value, one bad number must not take the whole game down
+        error = m_expected_skin_config[group] + ": malformed number (" + e.what() + ")";
+        return false;
+    }
+
+    auto describe = [config](const std::vector<std::pair<SkinDataType, SkinKey>> &keys) {
+        std::string missing;
+        for (auto &[type, key] : keys) {
+            if (!config->Contains(type, key)) {
+                missing += (missing.empty() ? "" : ", ") + std::string(SkinKeys::TypeName(type)) + "::" + SkinKeys::Name(key);
+            }
+        }
+
+        return missing;
+    };
+
+    // Older skins predate some elements, the scene leaves those out instead of refusing the skin
+    std::string skipped = describe(optionals);
+    if (!skipped.empty()) {
+        Logs::Write(LogLevel::Warning, "SkinManager", "%s does not define %s, leaving them out", m_expected_skin_config[group].c_str(), skipped.c_str());
+    }
+
+    std::string missing = describe(requirements);
+    if (!missing.empty()) {
+        error = m_expected_skin_config[group] + " is missing " + missing;
+        return false;
+    }
+
+    return true;
+}
+
+bool SkinManager::Contains(SkinGroup group, SkinDataType type, SkinKey key)
+{
+    // Lua tables only exist once a lookup runs them, let that lookup decide
+    if (m_luaScripting) {
+        return true;
+    }
 
-    return value.size() ? value : defaultValue;
+    try {
+        return GetConfig(group)->Contains(type, key);
+    } catch (const std::exception &) {
+        return false;
+    }
 }
 
 std::filesystem::path SkinManager::GetPath()
@@ -80,6 +195,43 @@ std::filesystem::path SkinManager::GetPath()
     return std::filesystem::current_path() / "Skins" / m_currentSkin;
 }
 
+bool SkinManager::ReadIni(std::filesystem::path path, mINI::INIStructure &ini)
+{
+    if (m_pack && m_pack->ReadIni(path, ini)) {
+        return true;
+    }
+
+    mINI::INIFile f(path);
+    return f.read(ini);
+}
+
+bool SkinManager::BuildPack(std::string skinName)
+{
+    auto root = std::filesystem::current_path() / "Skins" / skinName;
+    if (!std::filesystem::is_directory(root)) {
+        Logs::Write(LogLevel::Error, "SkinManager", "Skin %s not found", skinName.c_str());
+        return false;
+    }
+
+    std::vector<std::filesystem::path> images, inis;
+    for (auto &entry : std::filesystem::recursive_directory_iterator(root)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+
+        auto extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+        if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp") {
+            images.push_back(entry.path());
+        } else if (extension == ".ini") {
+            inis.push_back(entry.path());
+        }
+    }
+
+    return TexturePack::Write(root / kSkinPackName, root, images, inis);
+}
+
 void SkinManager::SetKeyCount(int key)
 {
     m_keyCount = key;
@@ -90,11 +242,16 @@ std::vector<NumericValue> SkinManager::GetNumeric(SkinGroup group, std::string k
     if (m_luaScripting) {
         return m_luaScripting->GetNumeric(group, key);
     } else {
-        if (m_skinConfigs.find(group) == m_skinConfigs.end()) {
-            TryLoadGroup(group);
-        }
+        return GetConfig(group)->GetNumeric(SkinKeys::Intern(key));
+    }
+}
 
-        return m_skinConfigs[group]->GetNumeric(key);
+std::vector<NumericValue> SkinManager::GetNumeric(SkinGroup group, SkinKey key)
+{
+    if (m_luaScripting) {
+        return m_luaScripting->GetNumeric(group, SkinKeys::Name(key));
+    } else {
+        return GetConfig(group)->GetNumeric(key);
     }
 }
 
@@ -103,11 +260,16 @@ std::vector<PositionValue> SkinManager::GetPosition(SkinGroup group, std::string
     if (m_luaScripting) {
         return m_luaScripting->GetPosition(group, key, m_keyCount);
     } else {
-        if (m_skinConfigs.find(group) == m_skinConfigs.end()) {
-            TryLoadGroup(group);
-        }
+        return GetConfig(group)->GetPosition(SkinKeys::Intern(key));
+    }
+}
 
-        return m_skinConfigs[group]->GetPosition(key);
+std::vector<PositionValue> SkinManager::GetPosition(SkinGroup group, SkinKey key)
+{
+    if (m_luaScripting) {
+        return m_luaScripting->GetPosition(group, SkinKeys::Name(key), m_keyCount);
+    } else {
+        return GetConfig(group)->GetPosition(key);
     }
 }
 
@@ -116,11 +278,16 @@ std::vector<RectInfo> SkinManager::GetRect(SkinGroup group, std::string key)
     if (m_luaScripting) {
         return m_luaScripting->GetRect(group, key);
     } else {
-        if (m_skinConfigs.find(group) == m_skinConfigs.end()) {
-            TryLoadGroup(group);
-        }
+        return GetConfig(group)->GetRect(SkinKeys::Intern(key));
+    }
+}
 
-        return m_skinConfigs[group]->GetRect(key);
+std::vector<RectInfo> SkinManager::GetRect(SkinGroup group, SkinKey key)
+{
+    if (m_luaScripting) {
+        return m_luaScripting->GetRect(group, SkinKeys::Name(key));
+    } else {
+        return GetConfig(group)->GetRect(key);
     }
 }
 
@@ -129,11 +296,16 @@ NoteValue SkinManager::GetNote(SkinGroup group, std::string key)
     if (m_luaScripting) {
         return m_luaScripting->GetNote(group, key, m_keyCount);
     } else {
-        if (m_skinConfigs.find(group) == m_skinConfigs.end()) {
-            TryLoadGroup(group);
-        }
+        return GetConfig(group)->GetNote(SkinKeys::Intern(key));
+    }
+}
 
-        return m_skinConfigs[group]->GetNote(key);
+NoteValue SkinManager::GetNote(SkinGroup group, SkinKey key)
+{
+    if (m_luaScripting) {
+        return m_luaScripting->GetNote(group, SkinKeys::Name(key), m_keyCount);
+    } else {
+        return GetConfig(group)->GetNote(key);
     }
 }
 
@@ -142,11 +314,16 @@ SpriteValue SkinManager::GetSprite(SkinGroup group, std::string key)
     if (m_luaScripting) {
         return m_luaScripting->GetSprite(group, key);
     } else {
-        if (m_skinConfigs.find(group) == m_skinConfigs.end()) {
-            TryLoadGroup(group);
-        }
+        return GetConfig(group)->GetSprite(SkinKeys::Intern(key));
+    }
+}
 
-        return m_skinConfigs[group]->GetSprite(key);
+SpriteValue SkinManager::GetSprite(SkinGroup group, SkinKey key)
+{
+    if (m_luaScripting) {
+        return m_luaScripting->GetSprite(group, SkinKeys::Name(key));
+    } else {
+        return GetConfig(group)->GetSprite(key);
     }
 }
 
@@ -217,6 +394,11 @@ void SkinManager::Release()
 
 SkinManager::SkinManager()
 {
+    // Only 7K is supported, groups can be validated at skin load before a scene sets it
+    m_keyCount = 7;
+    m_previousKeyCount = 7;
+    m_arena = 0;
+    m_useLua = false;
 }
 
 SkinManager::~SkinManager()
@@ -229,6 +411,17 @@ void SkinManager::TryLoadGroup(SkinGroup group)
         GetPath() / m_expected_directory[group] / m_expected_skin_config[group], m_keyCount);
 }
 
+SkinConfig *SkinManager::GetConfig(SkinGroup group)
+{
+    auto it = m_skinConfigs.find(group);
+    if (it == m_skinConfigs.end()) {
+        TryLoadGroup(group);
+        it = m_skinConfigs.find(group);
+    }
+
+    return it->second.get();
+}
+
 void SkinManager::Update(double delta)
 {
     if (m_luaScripting) {
@@ -3,11 +3,14 @@
 #include <filesystem>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include "LuaScripting.h"
 #include "SkinConfig.hpp"
 
+class TexturePack;
+
 class SkinManager
 {
 public:
@@ -17,9 +20,31 @@ public:
     LaneInfo GetLaneInfo();
 
     std::string           GetSkinProp(std::string group, std::string key, std::string defaultValue = "");
+    std::string           GetSkinProp(SkinKey prop, std::string defaultValue = "");
     std::filesystem::path GetPath();
 
+    /* Reads from the skin's pack when it has an up to date copy of the file, from disk otherwise */
+    bool ReadIni(std::filesystem::path path, mINI::INIStructure &ini);
+
+    /* Packs every image and INI file of Skins/<skinName> into its Skin.pack */
+    static bool BuildPack(std::string skinName);
+
+    /* GameSkin.ini property handle, e.g. PropKey("Game", "HitPos") */
+    static SkinKey PropKey(std::string_view group, std::string_view key);
+
+    /* Checks every key registered with SkinKeys::Require for the group, the error lists all that are missing; missing optional keys are only logged */
+    bool Validate(SkinGroup group, std::string &error);
+
+    /* Whether the group's INI defines the key, for reading SkinKeys::Optional ones */
+    bool Contains(SkinGroup group, SkinDataType type, SkinKey key);
+
     void                       SetKeyCount(int key);
+    std::vector<NumericValue>  GetNumeric(SkinGroup group, SkinKey key);
+    std::vector<PositionValue> GetPosition(SkinGroup group, SkinKey key);
+    std::vector<RectInfo>      GetRect(SkinGroup group, SkinKey key);
+    NoteValue                  GetNote(SkinGroup group, SkinKey key);
+    SpriteValue                GetSprite(SkinGroup group, SkinKey key);
+
     std::vector<NumericValue>  GetNumeric(SkinGroup group, std::string key);
     std::vector<PositionValue> GetPosition(SkinGroup group, std::string key);
     std::vector<RectInfo>      GetRect(SkinGroup group, std::string key);
@@ -41,7 +66,8 @@ private:
     SkinManager();
     ~SkinManager();
 
-    void TryLoadGroup(SkinGroup group);
+    void        TryLoadGroup(SkinGroup group);
+    SkinConfig *GetConfig(SkinGroup group);
 
     static SkinManager *m_instance;
 
@@ -53,8 +79,11 @@ private:
 
     std::string                 m_currentSkin;
     mINI::INIStructure          ini;
+    SkinTable<std::string>      m_props;
     std::unique_ptr<SkinConfig> m_arenaConfig;
 
+    std::shared_ptr<TexturePack> m_pack;
+
     int  m_keyCount, m_previousKeyCount;
     int  m_arena;
     bool m_useLua;
@@ -7,6 +7,7 @@
 
 #include "Configuration.h"
 #include "Fonts/FontResources.h"
+#include "Logs.h"
 
 #include "./Data/Util/Util.hpp"
 #include "./Engine/SkinManager.hpp"
@@ -28,6 +29,9 @@
 /* Overlays */
 #include "./Scenes/Overlays/Settings.h"
 
+// Benchmark frames always advance by this much, so every run renders the same frames
+constexpr double kBenchmarkDelta = 1.0 / 240.0;
+
 MyGame::~MyGame()
 {
     GameDatabase::Release();
@@ -46,10 +50,22 @@ bool MyGame::Init()
         return result;
     }
 
+    bool benchmark = EnvironmentSetup::GetInt("Benchmark") == 1;
+    if (benchmark) {
+        SetRenderMode(RendererMode::HEADLESS);
+        SetThreadMode(ThreadMode::SINGLE_THREAD);
+        SetFixedDelta(kBenchmarkDelta);
+    }
+
     result = Game::Init();
     if (result) {
         m_window->SetScaleOutput(true);
 
+        auto frameDump = EnvironmentSetup::GetPath("FrameDump");
+        if (benchmark && !frameDump.empty()) {
+            m_renderer->SetFrameDump(frameDump);
+        }
+
         EnvironmentSetup::SetInt("Key", -1);
 
         /* Screen */
@@ -97,6 +113,33 @@ void MyGame::SelectSkin(std::string name)
 
 bool MyGame::LoadConfiguration()
 {
+    {
+        // Game.ini [Game] LogFile = path, mirrors the console into a rotating log file
+        auto value = Configuration::Load("Game", "LogFile");
+        if (value.size() && !Logs::SetFileSink(value)) {
+            Logs::Write(LogLevel::Warning, "Game", "Failed to open log file: %s", value.c_str());
+        }
+    }
+
+    {
+        // Game.ini [Game] LogQuiet = Audio,KeysoundCache, those categories only log warnings and errors
+        auto value = Configuration::Load("Game", "LogQuiet");
+        for (auto &category : splitString(value, ',')) {
+            category.erase(0, category.find_first_not_of(" "));
+            category.erase(category.find_last_not_of(" ") + 1);
+
+            if (category.size()) {
+                Logs::SetCategoryLevel(category.c_str(), LogLevel::Warning);
+            }
+        }
+    }
+
+    {
+        // Game.ini [Game] RawInput = 1, reads keyboards from /dev/input on Linux for lower latency
+        auto value = Configuration::Load("Game", "RawInput");
+        SetRawInput(value == "1");
+    }
+
     {
         auto value = Configuration::Load("Game", "Renderer");
         if (value.size()) {
@@ -8,6 +8,8 @@ std::string defaultConfiguration = "[game]\n"
 	"audiooffset = 0\n"
 	"audiovolume = 100\n"
 	"autosound = 1\n"
+	"audiocache = 1\n"
+	"audiocacheadpcm = 0\n"
 	"resolution = 1280x720\n" // Fix for most monitor
 	"renderer = 0\n"
 	"guideline = 1\n\n"
@@ -4,6 +4,7 @@
 #include "Configuration.h"
 #include "Exception/SDLException.h"
 #include "Rendering/Renderer.h"
+#include "Texture/TextureAtlas.h"
 
 #include "MsgBox.h"
 #include <SDL2/SDL_image.h>
@@ -23,9 +24,30 @@
 #endif
 
 #include "../Engine/SkinConfig.hpp"
+#include "../Engine/SkinKeys.hpp"
 
 #pragma warning(disable : 26451)
 
+namespace NotesSkin {
+    SkinKey RequireLane(const char *prefix, int lane)
+    {
+        return SkinKeys::Require(SkinGroup::Notes, SkinDataType::Note, prefix + std::to_string(lane));
+    }
+
+    const SkinKey LaneHit[7] = {
+        RequireLane("LaneHit", 0), RequireLane("LaneHit", 1), RequireLane("LaneHit", 2), RequireLane("LaneHit", 3),
+        RequireLane("LaneHit", 4), RequireLane("LaneHit", 5), RequireLane("LaneHit", 6)
+    };
+
+    const SkinKey LaneHold[7] = {
+        RequireLane("LaneHold", 0), RequireLane("LaneHold", 1), RequireLane("LaneHold", 2), RequireLane("LaneHold", 3),
+        RequireLane("LaneHold", 4), RequireLane("LaneHold", 5), RequireLane("LaneHold", 6)
+    };
+
+    const SkinKey NoteTrailUp = SkinKeys::Require(SkinGroup::Notes, SkinDataType::Note, "NoteTrailUp");
+    const SkinKey NoteTrailDown = SkinKeys::Require(SkinGroup::Notes, SkinDataType::Note, "NoteTrailDown");
+} // namespace NotesSkin
+
 uint8_t OPI_MAGIC_FILE[] = { 0x02, 0x00, 0x00, 0x00 };
 uint8_t OPI_FILES_MAGIC[] = { 0x01, 0x00, 0x00, 0x00 };
 uint8_t OJS_MAGIC_FILE[] = { 0x01, 0x00, 0x55, 0x05 };
@@ -384,261 +406,83 @@ namespace GamePlayingResource {
 
 namespace GameNoteResource {
     std::unordered_map<NoteImageType, NoteImage *> noteTextures;
+    TextureAtlas                                  *atlas = nullptr;
     bool                                           Loaded = false;
 
+    NoteImage *LoadFrames(std::filesystem::path directory, NoteValue &note)
+    {
+        NoteImage *image = new NoteImage();
+        image->Atlas = atlas;
+        image->MaxFrames = note.numOfFiles;
+
+        for (int i = 0; i < note.numOfFiles; i++) {
+            auto path = directory / (note.fileName + std::to_string(i) + ".png");
+            if (!std::filesystem::exists(path)) {
+                throw std::runtime_error("File: " + path.string() + " is not found!");
+            }
+
+            image->Frames.push_back(atlas->Add(path));
+        }
+
+        return image;
+    }
+
     bool Load()
     {
         if (Loaded) {
             throw std::runtime_error("NoteResource already loaded");
         }
 
-        bool IsVulkan = Renderer::GetInstance()->IsVulkan();
-
         auto skinPath = SkinManager::GetInstance()->GetPath();
         auto skinNotePath = skinPath / "Notes";
 
         auto manager = SkinManager::GetInstance();
 
-        for (int i = 0; i < 7; i++) {
-            NoteValue note = manager->GetNote(SkinGroup::Notes, "LaneHit" + std::to_string(i));
-            NoteValue hold = manager->GetNote(SkinGroup::Notes, "LaneHold" + std::to_string(i));
-
-            NoteImage *noteImage = new NoteImage();
-            NoteImage *holdImage = new NoteImage();
-
-            noteImage->MaxFrames = note.numOfFiles;
-            holdImage->MaxFrames = hold.numOfFiles;
-
-            noteImage->Surface.resize(note.numOfFiles);
-            holdImage->Surface.resize(hold.numOfFiles);
-
-            noteImage->Texture.resize(note.numOfFiles);
-            holdImage->Texture.resize(hold.numOfFiles);
-
-            noteImage->VulkanTexture.resize(note.numOfFiles);
-            holdImage->VulkanTexture.resize(hold.numOfFiles);
-
-            for (int j = 0; j < note.numOfFiles; j++) {
-                auto path = skinNotePath / (note.fileName + std::to_string(j) + ".png");
-                if (!std::filesystem::exists(path)) {
-                    throw std::runtime_error("File: " + path.string() + " is not found!");
-                }
-
-                if (IsVulkan) {
-                    auto tex_data = vkTexture::TexLoadImage(path);
-                    if (tex_data == nullptr) {
-                        throw std::runtime_error("Failed to load image: " + path.string() + "!");
-                    }
-
-                    noteImage->VulkanTexture[j] = tex_data;
-
-                    if (j == 0) {
-                        auto &rect = noteImage->TextureRect;
-                        rect.left = 0;
-                        rect.top = 0;
-
-                        vkTexture::QueryTexture(tex_data, rect.right, rect.bottom);
-                    }
-                } else {
-                    noteImage->Surface[j] = IMG_Load(path.string().c_str());
-                    if (noteImage->Surface[j] == nullptr) {
-                        throw std::runtime_error("Failed to load image: " + path.string() + "!");
-                    }
-
-                    noteImage->Texture[j] = SDL_CreateTextureFromSurface(Renderer::GetInstance()->GetSDLRenderer(), noteImage->Surface[j]);
-                    if (noteImage->Texture[j] == nullptr) {
-                        throw std::runtime_error("Failed to create texture from image: " + path.string() + "!");
-                    }
-
-                    if (j == 0) {
-                        // query texture size
-                        auto &rect = noteImage->TextureRect;
-                        rect.left = 0;
-                        rect.top = 0;
-
-                        SDL_QueryTexture(noteImage->Texture[j], NULL, NULL, (int *)&rect.right, (int *)&rect.bottom);
-                    }
-                }
-            }
-
-            for (int j = 0; j < hold.numOfFiles; j++) {
-                auto path = skinNotePath / (hold.fileName + std::to_string(j) + ".png");
-                if (!std::filesystem::exists(path)) {
-                    throw std::runtime_error("File: " + path.string() + " is not found!");
-                }
-
-                if (IsVulkan) {
-                    auto tex_data = vkTexture::TexLoadImage(path);
-                    if (tex_data == nullptr) {
-                        throw std::runtime_error("Failed to load image: " + path.string() + "!");
-                    }
-
-                    holdImage->VulkanTexture[j] = tex_data;
-
-                    if (j == 0) {
-                        auto &rect = holdImage->TextureRect;
-                        rect.left = 0;
-                        rect.top = 0;
-
-                        vkTexture::QueryTexture(tex_data, rect.right, rect.bottom);
-                    }
-                } else {
-                    holdImage->Surface[j] = IMG_Load((const char *)path.u8string().c_str());
-                    if (holdImage->Surface[j] == nullptr) {
-                        throw std::runtime_error("Failed to load image: " + path.string() + "!");
-                    }
-
-                    holdImage->Texture[j] = SDL_CreateTextureFromSurface(Renderer::GetInstance()->GetSDLRenderer(), holdImage->Surface[j]);
-                    if (holdImage->Texture[j] == nullptr) {
-                        throw std::runtime_error("Failed to create texture from image: " + path.string() + "!");
-                    }
-
-                    if (j == 0) {
-                        // query texture size
-                        auto &rect = holdImage->TextureRect;
-                        rect.left = 0;
-                        rect.top = 0;
-
-                        SDL_QueryTexture(holdImage->Texture[j], NULL, NULL, (int *)&rect.right, (int *)&rect.bottom);
-                    }
-                }
-            }
-
-            noteTextures[(NoteImageType)i] = noteImage;
-            noteTextures[(NoteImageType)(i + 7)] = holdImage;
+        std::string skinError;
+        if (!manager->Validate(SkinGroup::Notes, skinError)) {
+            throw std::runtime_error(skinError);
         }
 
-        NoteValue trailUp = manager->GetNote(SkinGroup::Notes, "NoteTrailUp");
-        NoteValue trailDown = manager->GetNote(SkinGroup::Notes, "NoteTrailDown");
+        // Every note, hold and trail frame goes into one atlas, so the whole
+        // playfield is drawn from a single page in the common case
+        atlas = new TextureAtlas();
 
-        NoteImage *trailUpImg = new NoteImage();
-        trailUpImg->Texture.resize(trailUp.numOfFiles);
-        trailUpImg->Surface.resize(trailUp.numOfFiles);
-        trailUpImg->VulkanTexture.resize(trailUp.numOfFiles);
+        for (int i = 0; i < 7; i++) {
+            NoteValue note = manager->GetNote(SkinGroup::Notes, NotesSkin::LaneHit[i]);
+            NoteValue hold = manager->GetNote(SkinGroup::Notes, NotesSkin::LaneHold[i]);
 
-        NoteImage *trailDownImg = new NoteImage();
-        trailDownImg->Texture.resize(trailDown.numOfFiles);
-        trailDownImg->Surface.resize(trailDown.numOfFiles);
-        trailDownImg->VulkanTexture.resize(trailUp.numOfFiles);
+            noteTextures[(NoteImageType)i] = LoadFrames(skinNotePath, note);
+            noteTextures[(NoteImageType)(i + 7)] = LoadFrames(skinNotePath, hold);
+        }
 
-        for (int i = 0; i < trailUp.numOfFiles; i++) {
-            auto path = skinNotePath / (trailUp.fileName + std::to_string(i) + ".png");
-            if (!std::filesystem::exists(path)) {
-                throw std::runtime_error("File: " + path.string() + " is not found!");
-            }
+        NoteValue trailUp = manager->GetNote(SkinGroup::Notes, NotesSkin::NoteTrailUp);
+        NoteValue trailDown = manager->GetNote(SkinGroup::Notes, NotesSkin::NoteTrailDown);
 
-            if (IsVulkan) {
-                auto tex_data = vkTexture::TexLoadImage(path);
-                if (tex_data == nullptr) {
-                    throw std::runtime_error("Failed to load image: " + path.string() + "!");
-                }
-
-                trailUpImg->VulkanTexture[i] = tex_data;
-
-                if (i == 0) {
-                    auto &rect = trailUpImg->TextureRect;
-                    rect.left = 0;
-                    rect.top = 0;
-
-                    vkTexture::QueryTexture(tex_data, rect.right, rect.bottom);
-                }
-            } else {
-                trailUpImg->Surface[i] = IMG_Load((const char *)path.u8string().c_str());
-                if (trailUpImg->Surface[i] == nullptr) {
-                    throw std::runtime_error("Failed to load image: " + path.string() + "!");
-                }
-
-                trailUpImg->Texture[i] = SDL_CreateTextureFromSurface(Renderer::GetInstance()->GetSDLRenderer(), trailUpImg->Surface[i]);
-                if (trailUpImg->Texture[i] == nullptr) {
-                    throw std::runtime_error("Failed to create texture from image: " + path.string() + "!");
-                }
-
-                if (i == 0) {
-                    // query texture size
-                    auto &rect = trailUpImg->TextureRect;
-                    rect.left = 0;
-                    rect.top = 0;
-
-                    SDL_QueryTexture(trailUpImg->Texture[i], NULL, NULL, (int *)&rect.right, (int *)&rect.bottom);
-                }
-            }
-        }
+        noteTextures[NoteImageType::TRAIL_UP] = LoadFrames(skinNotePath, trailUp);
+        noteTextures[NoteImageType::TRAIL_DOWN] = LoadFrames(skinNotePath, trailDown);
 
-        for (int i = 0; i < trailDown.numOfFiles; i++) {
-            auto path = skinNotePath / (trailDown.fileName + std::to_string(i) + ".png");
-            if (!std::filesystem::exists(path)) {
-                throw std::runtime_error("File: " + path.string() + " is not found!");
-            }
+        atlas->Build();
 
-            if (IsVulkan) {
-                auto tex_data = vkTexture::TexLoadImage(path);
-                if (tex_data == nullptr) {
-                    throw std::runtime_error("Failed to load image: " + path.string() + "!");
-                }
-
-                trailDownImg->VulkanTexture[i] = tex_data;
-
-                if (i == 0) {
-                    auto &rect = trailDownImg->TextureRect;
-                    rect.left = 0;
-                    rect.top = 0;
-
-                    vkTexture::QueryTexture(tex_data, rect.right, rect.bottom);
-                }
-            } else {
-                trailDownImg->Surface[i] = IMG_Load((const char *)path.u8string().c_str());
-                if (trailDownImg->Surface[i] == nullptr) {
-                    throw std::runtime_error("Failed to load image: " + path.string() + "!");
-                }
-
-                trailDownImg->Texture[i] = SDL_CreateTextureFromSurface(Renderer::GetInstance()->GetSDLRenderer(), trailDownImg->Surface[i]);
-                if (trailDownImg->Texture[i] == nullptr) {
-                    throw std::runtime_error("Failed to create texture from image: " + path.string() + "!");
-                }
-
-                if (i == 0) {
-                    // query texture size
-                    auto &rect = trailDownImg->TextureRect;
-                    rect.left = 0;
-                    rect.top = 0;
-
-                    SDL_QueryTexture(trailDownImg->Texture[i], NULL, NULL, (int *)&rect.right, (int *)&rect.bottom);
-                }
+        for (auto &it : noteTextures) {
+            auto image = it.second;
+            if (image->Frames.size()) {
+                image->TextureRect = atlas->GetRect(image->Frames[0]);
             }
         }
 
-        noteTextures[NoteImageType::TRAIL_UP] = trailUpImg;
-        noteTextures[NoteImageType::TRAIL_DOWN] = trailDownImg;
-
         Loaded = true;
         return true;
     }
 
     bool Dispose()
     {
-        bool IsVulkan = Renderer::GetInstance()->IsVulkan();
-
         for (auto &it : noteTextures) {
-            if (IsVulkan) {
-                for (auto &tex : it.second->VulkanTexture) {
-                    vkTexture::ReleaseTexture(tex);
-                    tex = nullptr;
-                }
-            } else {
-                for (auto &tex : it.second->Texture) {
-                    SDL_DestroyTexture(tex);
-                    tex = nullptr;
-                }
-
-                for (auto &sur : it.second->Surface) {
-                    SDL_FreeSurface(sur);
-                    sur = nullptr;
-                }
-            }
-
             delete it.second;
         }
 
+        delete atlas;
+        atlas = nullptr;
+
         noteTextures.clear();
         Loaded = false;
         return true;
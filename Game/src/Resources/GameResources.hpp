@@ -8,6 +8,8 @@
 #include "Rendering/Vulkan/Texture2DVulkan.h"
 #include "Rendering/WindowsTypes.h"
 
+class TextureAtlas;
+
 typedef void *ESTHANDLE;
 
 struct Boundary
@@ -81,12 +83,10 @@ enum class O2ResourceType {
 
 struct NoteImage
 {
-    std::vector<SDL_Texture *> Texture;
-    std::vector<SDL_Surface *> Surface;
-
-    std::vector<Texture2D_Vulkan *> VulkanTexture;
-    Rect                            TextureRect;
-    int                             MaxFrames;
+    TextureAtlas    *Atlas;
+    std::vector<int> Frames;
+    Rect             TextureRect;
+    int              MaxFrames;
 };
 
 namespace GameAvatarResource {
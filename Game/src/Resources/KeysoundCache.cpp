@@ -0,0 +1,434 @@
+#include "KeysoundCache.hpp"
+#include "Configuration.h"
+#include <Logs.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string.h>
+
+namespace {
+    const char     CACHE_SIGNATURE[4] = { 'O', '2', 'K', 'S' };
+    const uint32_t CACHE_VERSION = 2;
+    const size_t   CACHE_ALIGNMENT = 16;
+
+    // IMA ADPCM, frames per block for each channel
+    const int ADPCM_BLOCK_FRAMES = 1024;
+
+    const int ADPCM_INDEX_TABLE[16] = {
+        -1, -1, -1, -1, 2, 4, 6, 8,
+        -1, -1, -1, -1, 2, 4, 6, 8
+    };
+
+    const int ADPCM_STEP_TABLE[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+        19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+        50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+        130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+        337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+        876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+        2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+        5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+
+    size_t AlignUp(size_t value)
+    {
+        return (value + CACHE_ALIGNMENT - 1) & ~(CACHE_ALIGNMENT - 1);
+    }
+
+    uint8_t AdpcmEncodeNibble(int sample, int &predictor, int &index)
+    {
+        int step = ADPCM_STEP_TABLE[index];
+        int diff = sample - predictor;
+
+        uint8_t nibble = 0;
+        if (diff < 0) {
+            nibble = 8;
+            diff = -diff;
+        }
+
+        int delta = step >> 3;
+        if (diff >= step) {
+            nibble |= 4;
+            diff -= step;
+            delta += step;
+        }
+
+        step >>= 1;
+        if (diff >= step) {
+            nibble |= 2;
+            diff -= step;
+            delta += step;
+        }
+
+        step >>= 1;
+        if (diff >= step) {
+            nibble |= 1;
+            delta += step;
+        }
+
+        predictor = std::clamp(predictor + ((nibble & 8) ? -delta : delta), -32768, 32767);
+        index = std::clamp(index + ADPCM_INDEX_TABLE[nibble], 0, 88);
+
+        return nibble;
+    }
+
+    int16_t AdpcmDecodeNibble(uint8_t nibble, int &predictor, int &index)
+    {
+        int step = ADPCM_STEP_TABLE[index];
+
+        int delta = step >> 3;
+        if (nibble & 4)
+            delta += step;
+        if (nibble & 2)
+            delta += step >> 1;
+        if (nibble & 1)
+            delta += step >> 2;
+
+        predictor = std::clamp(predictor + ((nibble & 8) ? -delta : delta), -32768, 32767);
+        index = std::clamp(index + ADPCM_INDEX_TABLE[nibble], 0, 88);
+
+        return static_cast<int16_t>(predictor);
+    }
+
+    /*
+     * Block layout for each block of up to ADPCM_BLOCK_FRAMES frames:
+     *   per channel: int16 first sample, uint8 step index, uint8 reserved
+     *   per channel: (frames - 1) nibbles, padded to a full byte
+     */
+    std::vector<uint8_t> AdpcmEncode(const int16_t *pcm, size_t frames, int channels)
+    {
+        std::vector<uint8_t> result;
+        result.reserve(frames * channels / 2 + (frames / ADPCM_BLOCK_FRAMES + 1) * channels * 4);
+
+        std::vector<int> indices(channels, 0);
+
+        for (size_t start = 0; start < frames; start += ADPCM_BLOCK_FRAMES) {
+            size_t count = std::min<size_t>(ADPCM_BLOCK_FRAMES, frames - start);
+
+            for (int c = 0; c < channels; c++) {
+                int16_t first = pcm[start * channels + c];
+
+                result.push_back(static_cast<uint8_t>(first & 0xFF));
+                result.push_back(static_cast<uint8_t>((first >> 8) & 0xFF));
+                result.push_back(static_cast<uint8_t>(indices[c]));
+                result.push_back(0);
+            }
+
+            for (int c = 0; c < channels; c++) {
+                int predictor = pcm[start * channels + c];
+                int index = indices[c];
+
+                uint8_t packed = 0;
+                for (size_t i = 1; i < count; i++) {
+                    uint8_t nibble = AdpcmEncodeNibble(pcm[(start + i) * channels + c], predictor, index);
+
+                    if ((i - 1) & 1) {
+                        result.push_back(packed | static_cast<uint8_t>(nibble << 4));
+                        packed = 0;
+                    } else {
+                        packed = nibble;
+                    }
+                }
+
+                if ((count - 1) & 1) {
+                    result.push_back(packed);
+                }
+
+                indices[c] = index;
+            }
+        }
+
+        return result;
+    }
+
+    bool AdpcmDecode(const uint8_t *data, size_t size, size_t frames, int channels, int16_t *out)
+    {
+        size_t pos = 0;
+
+        for (size_t start = 0; start < frames; start += ADPCM_BLOCK_FRAMES) {
+            size_t count = std::min<size_t>(ADPCM_BLOCK_FRAMES, frames - start);
+            size_t nibbleBytes = count / 2;
+
+            if (pos + channels * (4 + nibbleBytes) > size) {
+                return false;
+            }
+
+            std::vector<int> predictors(channels), indices(channels);
+            for (int c = 0; c < channels; c++) {
+                predictors[c] = static_cast<int16_t>(data[pos] | (data[pos + 1] << 8));
+                indices[c] = std::clamp<int>(data[pos + 2], 0, 88);
+                out[start * channels + c] = static_cast<int16_t>(predictors[c]);
+
+                pos += 4;
+            }
+
+            for (int c = 0; c < channels; c++) {
+                for (size_t i = 1; i < count; i++) {
+                    uint8_t byte = data[pos + (i - 1) / 2];
+                    uint8_t nibble = ((i - 1) & 1) ? (byte >> 4) : (byte & 0x0F);
+
+                    out[(start + i) * channels + c] = AdpcmDecodeNibble(nibble, predictors[c], indices[c]);
+                }
+
+                pos += nibbleBytes;
+            }
+        }
+
+        return true;
+    }
+} // namespace
+
+bool KeysoundCache::Reader::Open(std::filesystem::path path)
+{
+    Close();
+
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+
+    if (!m_file.Open(path)) {
+        Logs::Write(LogLevel::Warning, "KeysoundCache", "Failed to map cache file: %s", path.string().c_str());
+        return false;
+    }
+
+    const uint8_t *data = m_file.Data();
+    size_t         size = m_file.Size();
+
+    if (size < sizeof(Header)) {
+        Close();
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+
+    if (memcmp(header.Signature, CACHE_SIGNATURE, 4) != 0 || header.Version != CACHE_VERSION) {
+        Logs::Puts("[KeysoundCache] Ignoring outdated cache file: %s", path.string().c_str());
+        Close();
+        return false;
+    }
+
+    if (sizeof(Header) + (size_t)header.Count * sizeof(Entry) > size) {
+        Close();
+        return false;
+    }
+
+    m_entries.resize(header.Count);
+    memcpy(m_entries.data(), data + sizeof(Header), header.Count * sizeof(Entry));
+
+    for (auto &entry : m_entries) {
+        if (entry.Offset + entry.StoredLength > size) {
+            Logs::Puts("[KeysoundCache] Corrupted cache file: %s", path.string().c_str());
+            Close();
+            return false;
+        }
+    }
+
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry &a, const Entry &b) {
+        return a.Index < b.Index;
+    });
+
+    return true;
+}
+
+void KeysoundCache::Reader::Close()
+{
+    m_entries.clear();
+    m_file.Close();
+}
+
+const KeysoundCache::Entry *KeysoundCache::Reader::Find(int index, uint64_t sourceSize, uint64_t sourceStamp) const
+{
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), index, [](const Entry &entry, int value) {
+        return entry.Index < value;
+    });
+
+    if (it == m_entries.end() || it->Index != index || it->SourceSize != sourceSize || it->SourceStamp != sourceStamp) {
+        return nullptr;
+    }
+
+    return &(*it);
+}
+
+const void *KeysoundCache::Reader::GetPCM(const Entry *entry, std::vector<int16_t> &scratch) const
+{
+    const uint8_t *data = GetData(entry);
+
+    switch (entry->Format) {
+        case Encoding::PCM16:
+            return data;
+
+        case Encoding::IMA_ADPCM:
+        {
+            if (entry->Channels == 0) {
+                return nullptr;
+            }
+
+            size_t frames = entry->PcmLength / (sizeof(int16_t) * entry->Channels);
+            scratch.resize(frames * entry->Channels);
+
+            if (!AdpcmDecode(data, entry->StoredLength, frames, entry->Channels, scratch.data())) {
+                return nullptr;
+            }
+
+            return scratch.data();
+        }
+
+        default:
+            return nullptr;
+    }
+}
+
+const std::vector<KeysoundCache::Entry> &KeysoundCache::Reader::GetEntries() const
+{
+    return m_entries;
+}
+
+const uint8_t *KeysoundCache::Reader::GetData(const Entry *entry) const
+{
+    return m_file.Data() + entry->Offset;
+}
+
+void KeysoundCache::Writer::Add(int index, uint64_t sourceSize, uint64_t sourceStamp, int sampleRate, int channels, const void *pcm, size_t pcmLength, Encoding format)
+{
+    Entry entry = {};
+    entry.Index = index;
+    entry.Format = format;
+    entry.SampleRate = static_cast<uint32_t>(sampleRate);
+    entry.Channels = static_cast<uint16_t>(channels);
+    entry.SourceSize = sourceSize;
+    entry.SourceStamp = sourceStamp;
+    entry.PcmLength = static_cast<uint32_t>(pcmLength);
+
+    std::vector<uint8_t> block;
+    if (format == Encoding::IMA_ADPCM && channels > 0) {
+        size_t frames = pcmLength / (sizeof(int16_t) * channels);
+        block = AdpcmEncode(reinterpret_cast<const int16_t *>(pcm), frames, channels);
+
+        // Keep the frame count exact, any trailing partial frame is dropped
+        entry.PcmLength = static_cast<uint32_t>(frames * sizeof(int16_t) * channels);
+    } else {
+        entry.Format = Encoding::PCM16;
+
+        const uint8_t *begin = reinterpret_cast<const uint8_t *>(pcm);
+        block.assign(begin, begin + pcmLength);
+    }
+
+    entry.StoredLength = static_cast<uint32_t>(block.size());
+
+    m_entries.push_back(entry);
+    m_blocks.push_back(std::move(block));
+}
+
+void KeysoundCache::Writer::AddRaw(const Entry &entry, const uint8_t *data)
+{
+    m_entries.push_back(entry);
+    m_blocks.emplace_back(data, data + entry.StoredLength);
+}
+
+bool KeysoundCache::Writer::Empty() const
+{
+    return m_entries.empty();
+}
+
+bool KeysoundCache::Writer::Save(std::filesystem::path path)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    Header header = {};
+    memcpy(header.Signature, CACHE_SIGNATURE, 4);
+    header.Version = CACHE_VERSION;
+    header.Count = static_cast<uint32_t>(m_entries.size());
+
+    size_t offset = AlignUp(sizeof(Header) + m_entries.size() * sizeof(Entry));
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        m_entries[i].Offset = offset;
+        offset = AlignUp(offset + m_blocks[i].size());
+    }
+
+    // Write to a temporary file first so a crash never leaves a half written cache
+    auto tempPath = path;
+    tempPath += ".tmp";
+
+    {
+        std::fstream fs(tempPath, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!fs.is_open()) {
+            Logs::Write(LogLevel::Error, "KeysoundCache", "Failed to write cache file: %s", path.string().c_str());
+            return false;
+        }
+
+        const char padding[CACHE_ALIGNMENT] = {};
+
+        fs.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+        fs.write(reinterpret_cast<const char *>(m_entries.data()), m_entries.size() * sizeof(Entry));
+
+        size_t position = sizeof(Header) + m_entries.size() * sizeof(Entry);
+        for (size_t i = 0; i < m_entries.size(); i++) {
+            fs.write(padding, m_entries[i].Offset - position);
+            fs.write(reinterpret_cast<const char *>(m_blocks[i].data()), m_blocks[i].size());
+
+            position = m_entries[i].Offset + m_blocks[i].size();
+        }
+
+        if (!fs.good()) {
+            fs.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        Logs::Write(LogLevel::Error, "KeysoundCache", "Failed to commit cache file: %s", path.string().c_str());
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    return true;
+}
+
+std::filesystem::path KeysoundCache::GetPath(const std::string &hash, double rate)
+{
+    std::stringstream ss;
+    ss << hash << "_" << std::setw(3) << std::setfill('0') << static_cast<int>(rate * 100.0 + 0.5) << ".ksc";
+
+    return std::filesystem::current_path() / "Cache" / "Keysounds" / ss.str();
+}
+
+uint64_t KeysoundCache::GetStamp(const std::filesystem::path &path)
+{
+    std::error_code ec;
+    auto            time = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(time.time_since_epoch().count());
+}
+
+uint64_t KeysoundCache::GetStamp(const void *data, size_t size)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+bool KeysoundCache::IsEnabled()
+{
+    auto value = Configuration::Load("Game", "AudioCache");
+    return value.empty() || value != "0";
+}
+
+KeysoundCache::Encoding KeysoundCache::GetPreferredEncoding()
+{
+    auto value = Configuration::Load("Game", "AudioCacheADPCM");
+    return value == "1" ? Encoding::IMA_ADPCM : Encoding::PCM16;
+}
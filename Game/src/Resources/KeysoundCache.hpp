@@ -0,0 +1,89 @@
+#pragma once
+#include <filesystem>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Misc/MappedFile.h"
+
+/*
+ * Persistent cache of decoded keysounds, one file per chart hash and rate.
+ *
+ * Layout: [Header][Entry * count][sample data...], every sample block is
+ * aligned to 16 bytes so PCM16 samples can be handed to BASS straight from
+ * the mapped view.
+ */
+namespace KeysoundCache {
+    enum class Encoding : uint32_t {
+        PCM16 = 0,
+        IMA_ADPCM = 1
+    };
+
+#pragma pack(push, 1)
+    struct Header
+    {
+        char     Signature[4];
+        uint32_t Version;
+        uint32_t Count;
+        uint32_t Reserved;
+    };
+
+    struct Entry
+    {
+        int32_t  Index;
+        Encoding Format;
+        uint32_t SampleRate;
+        uint16_t Channels;
+        uint16_t Reserved;
+        uint64_t SourceSize;  // Size of the original encoded file, used to validate the entry
+        uint64_t SourceStamp; // Write time of an external file or content hash of an embedded one, see GetStamp
+        uint64_t Offset;     // Offset of the sample data from the start of file
+        uint32_t StoredLength;
+        uint32_t PcmLength; // Length in bytes of the PCM16 data once decoded
+    };
+#pragma pack(pop)
+
+    class Reader
+    {
+    public:
+        bool Open(std::filesystem::path path);
+        void Close();
+
+        const Entry *Find(int index, uint64_t sourceSize, uint64_t sourceStamp) const;
+
+        /* Returns pointer to PCM16 data, decoding ADPCM entries into scratch if needed */
+        const void *GetPCM(const Entry *entry, std::vector<int16_t> &scratch) const;
+
+        const std::vector<Entry> &GetEntries() const;
+        const uint8_t            *GetData(const Entry *entry) const;
+
+    private:
+        MappedFile         m_file;
+        std::vector<Entry> m_entries;
+    };
+
+    class Writer
+    {
+    public:
+        void Add(int index, uint64_t sourceSize, uint64_t sourceStamp, int sampleRate, int channels, const void *pcm, size_t pcmLength, Encoding format);
+        void AddRaw(const Entry &entry, const uint8_t *data);
+
+        bool Empty() const;
+        bool Save(std::filesystem::path path);
+
+    private:
+        std::vector<Entry>                m_entries;
+        std::vector<std::vector<uint8_t>> m_blocks;
+    };
+
+    std::filesystem::path GetPath(const std::string &hash, double rate);
+
+    /* Entry stamp for an external sample, its last write time (0 when it cannot be queried) */
+    uint64_t GetStamp(const std::filesystem::path &path);
+
+    /* Entry stamp for a sample embedded in the chart, FNV-1a over its bytes */
+    uint64_t GetStamp(const void *data, size_t size);
+
+    bool     IsEnabled();
+    Encoding GetPreferredEncoding();
+} // namespace KeysoundCache
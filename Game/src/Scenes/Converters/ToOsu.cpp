@@ -1,114 +1,361 @@
 #include "ToOsu.hpp"
 #include "../../Data/Util/Util.hpp"
-#include "../../Data/osu.hpp"
+#include <Logs.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <fstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
-bool Converters::SaveTo(O2::OJN *ojn, const char *path)
-{
-    auto converterPath = std::filesystem::current_path() / "Converted";
-    if (!std::filesystem::exists(converterPath)) {
-        std::filesystem::create_directories(converterPath);
-    }
-
-    std::string              ojnFile = "o2ma" + std::to_string(ojn->Header.songid);
-    std::vector<std::string> fileName = {
-        ojnFile + "-EX.osu",
-        ojnFile + "-NX.osu",
-        ojnFile + "-HX.osu",
-    };
-
-    for (auto &[index, difficulty] : ojn->Difficulties) {
-        std::fstream fs(converterPath / fileName[index], std::ios::binary | std::ios::out);
+/*
+ * Each song is formatted into one reused string and written with a single
+ * call, the old per-field fstream writes were most of the conversion time.
+ * Keysounds are written straight out of the OJM, they are already complete
+ * OGG/WAV files in memory.
+ */
+namespace {
+    const char *kDifficultyNames[] = { "EX", "NX", "HX" };
 
-        if (!fs.is_open()) {
-            return false;
+    class OsuWriter
+    {
+    public:
+        OsuWriter(std::string &buffer) : m_buffer(buffer)
+        {
+            m_buffer.clear();
         }
 
-        fs << "osu file format v14\n\n";
+        OsuWriter &operator<<(std::string_view value)
+        {
+            m_buffer.append(value);
+            return *this;
+        }
 
-        fs << "[General]\n";
-        fs << "AudioFilename:\n";
-        fs << "Mode: 3\n";
-        fs << "AudioLeadIn: 0\n\n";
+        OsuWriter &operator<<(const std::u8string &value)
+        {
+            m_buffer.append(reinterpret_cast<const char *>(value.data()), value.size());
+            return *this;
+        }
 
-        fs << "[Metadata]\n";
-        fs << "Title: ";
+        OsuWriter &operator<<(char value)
+        {
+            m_buffer.push_back(value);
+            return *this;
+        }
 
-        auto title = CodepageToUtf8(ojn->Header.title, sizeof(ojn->Header.title), "euc-kr");
-        fs.write((char *)title.c_str(), title.size());
+        OsuWriter &operator<<(int value)
+        {
+            char text[16];
+            auto result = std::to_chars(text, text + sizeof(text), value);
+            m_buffer.append(text, result.ptr);
+            return *this;
+        }
 
-        fs << "\n";
+        OsuWriter &operator<<(double value)
+        {
+            char text[32];
+            auto result = std::to_chars(text, text + sizeof(text), value);
+            m_buffer.append(text, result.ptr);
+            return *this;
+        }
 
-        fs << "TitleUnicode: ";
-        fs.write((char *)title.c_str(), title.size());
+    private:
+        std::string &m_buffer;
+    };
 
-        fs << "\n";
+    /* osu! stores hit object times as integers, the parser rejects fractions */
+    int ToMillis(double time)
+    {
+        return static_cast<int>(std::lround(time));
+    }
 
-        fs << "Artist: ";
+    bool WriteFile(const std::filesystem::path &path, const void *data, size_t size)
+    {
+        std::ofstream fs(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!fs.is_open()) {
+            return false;
+        }
 
-        auto artist = CodepageToUtf8(ojn->Header.artist, sizeof(ojn->Header.artist), "euc-kr");
-        fs.write((char *)artist.c_str(), artist.size());
+        fs.write(static_cast<const char *>(data), size);
+        return fs.good();
+    }
 
-        fs << "\n";
+    std::string GetSampleFileName(const O2Sample &sample)
+    {
+        bool wave = sample.AudioData.size() >= 4 && memcmp(sample.AudioData.data(), "RIFF", 4) == 0;
+        return std::to_string(sample.RefValue) + (wave ? ".wav" : ".ogg");
+    }
 
-        fs << "ArtistUnicode: ";
-        fs.write((char *)artist.c_str(), artist.size());
+    void WriteDifficulty(std::string &buffer, O2::OJN *ojn, int index, OJNDifficulty &difficulty, const std::unordered_map<int, std::string> &samples, bool hasCover)
+    {
+        OsuWriter fs(buffer);
 
-        fs << "\n";
+        auto title = CodepageToUtf8(ojn->Header.title, sizeof(ojn->Header.title), "euc-kr");
+        auto artist = CodepageToUtf8(ojn->Header.artist, sizeof(ojn->Header.artist), "euc-kr");
+        auto creator = CodepageToUtf8(ojn->Header.noter, sizeof(ojn->Header.noter), "euc-kr");
 
-        fs << "Creator: ";
+        int keyCount = ojn->KeyCount > 0 ? ojn->KeyCount : 7;
 
-        auto creator = CodepageToUtf8(ojn->Header.noter, sizeof(ojn->Header.noter), "euc-kr");
-        fs.write((char *)creator.c_str(), creator.size());
+        fs << "osu file format v14\n\n";
 
-        fs << "\n";
+        fs << "[General]\n";
+        fs << "AudioFilename:\n";
+        fs << "Mode: 3\n";
+        fs << "AudioLeadIn: 0\n\n";
 
-        fs << "Version: 7K-" + std::to_string(index) + "\n";
+        fs << "[Metadata]\n";
+        fs << "Title: " << title << '\n';
+        fs << "TitleUnicode: " << title << '\n';
+        fs << "Artist: " << artist << '\n';
+        fs << "ArtistUnicode: " << artist << '\n';
+        fs << "Creator: " << creator << '\n';
+        fs << "Version: " << kDifficultyNames[index] << " Lv." << static_cast<int>(ojn->Header.level[index]) << '\n';
         fs << "Source: O2Jam\n";
-
-        fs << "Tags: o2jam o2ma" + std::to_string(ojn->Header.songid) + "\n";
+        fs << "Tags: o2jam o2ma" << ojn->Header.songid << '\n';
         fs << "BeatmapID: 0\n";
         fs << "BeatmapSetID: -1\n\n";
 
         fs << "[Difficulty]\n";
         fs << "HPDrainRate: 7\n";
-        fs << "CircleSize: 7\n";
+        fs << "CircleSize: " << keyCount << '\n';
         fs << "OverallDifficulty: 8\n";
         fs << "ApproachRate: 5\n";
         fs << "SliderMultiplier: 1.4\n";
         fs << "SliderTickRate: 1\n\n";
 
         fs << "[Events]\n";
-        fs << "0,0\"background.jpg\"\n";
+        if (hasCover) {
+            fs << "0,0,\"background.jpg\",0,0\n";
+        }
 
         for (auto &sample : difficulty.AutoSamples) {
-            fs << "5," << sample.StartTime << ",0,\"Sample-" << sample.SampleRefId << ".ogg\"\n";
+            auto it = samples.find(sample.SampleRefId);
+            if (it != samples.end()) {
+                fs << "5," << ToMillis(sample.StartTime) << ",0,\"" << it->second << "\"\n";
+            }
         }
 
-        fs << "\n";
+        fs << '\n';
 
         fs << "[TimingPoints]\n";
+        // A BPM of 0 has no beat length, osu! would read the inf as a broken timing point
+        bool hasTiming = false;
         for (auto &timing : difficulty.Timings) {
-            fs << timing.Time << "," << 60000.0 / timing.BPM << ",4,2,0,100,1,0\n";
+            if (!(timing.BPM > 0.0) || !std::isfinite(timing.BPM)) {
+                continue;
+            }
+
+            fs << timing.Time << ',' << 60000.0 / timing.BPM << ",4,2,0,100,1,0\n";
+            hasTiming = true;
         }
 
-        fs << "\n";
+        if (!hasTiming && ojn->Header.bpm > 0.0f) {
+            fs << "0," << 60000.0 / ojn->Header.bpm << ",4,2,0,100,1,0\n";
+        }
 
-        fs << "[HitObjects]\n";
+        fs << '\n';
 
+        fs << "[HitObjects]\n";
         for (auto &note : difficulty.Notes) {
-            if (!note.IsLN) {
-                if (note.SampleRefId != -1) {
-                    std::string sampleId = "Sample#" + std::to_string(note.SampleRefId) + ".ogg";
-                    fs << note.StartTime << ",192,0,128,0,0:0:0:0:" << sampleId << "\n";
-                }
+            int  x = (512 * note.LaneIndex + 256) / keyCount;
+            auto it = samples.find(note.SampleRefId);
+
+            fs << x << ",192," << ToMillis(note.StartTime);
+
+            if (note.IsLN) {
+                fs << ",128,0," << ToMillis(note.EndTime) << ":0:0:0:0:";
             } else {
-                fs << note.StartTime << ",192,0,128,0," << note.EndTime << ":0:0:0:\n";
+                fs << ",1,0,0:0:0:0:";
+            }
+
+            if (it != samples.end()) {
+                fs << it->second;
+            }
+
+            fs << '\n';
+        }
+    }
+
+    std::string FormatSeconds(double seconds)
+    {
+        char text[32];
+        snprintf(text, sizeof(text), "%d:%02d", static_cast<int>(seconds) / 60, static_cast<int>(seconds) % 60);
+        return text;
+    }
+} // namespace
+
+bool Converters::SaveTo(O2::OJN *ojn, const char *path)
+{
+    auto converterPath = path ? std::filesystem::path(path) : std::filesystem::current_path() / "Converted";
+
+    std::string ojnFile = "o2ma" + std::to_string(ojn->Header.songid);
+    auto        songPath = converterPath / ojnFile;
+
+    std::error_code ec;
+    std::filesystem::create_directories(songPath, ec);
+    if (ec) {
+        return false;
+    }
+
+    bool hasCover = !ojn->BackgroundImage.empty();
+    if (hasCover && !WriteFile(songPath / "background.jpg", ojn->BackgroundImage.data(), ojn->BackgroundImage.size())) {
+        return false;
+    }
+
+    // Every difficulty carries its own copy of the OJM samples, the first one is enough
+    std::unordered_map<int, std::string> samples;
+    if (!ojn->Difficulties.empty()) {
+        for (auto &sample : ojn->Difficulties.begin()->second.Samples) {
+            auto name = GetSampleFileName(sample);
+            if (!WriteFile(songPath / name, sample.AudioData.data(), sample.AudioData.size())) {
+                return false;
             }
+
+            samples[static_cast<int>(sample.RefValue)] = std::move(name);
+        }
+    }
+
+    thread_local std::string buffer;
+
+    for (auto &[index, difficulty] : ojn->Difficulties) {
+        if (index < 0 || index > 2 || difficulty.Notes.empty()) {
+            continue;
         }
 
-        fs.close();
+        WriteDifficulty(buffer, ojn, index, difficulty, samples, hasCover);
+
+        auto fileName = ojnFile + "-" + kDifficultyNames[index] + ".osu";
+        if (!WriteFile(songPath / fileName, buffer.data(), buffer.size())) {
+            return false;
+        }
     }
 
     return true;
 }
+
+int Converters::ConvertLibrary(const std::filesystem::path &input, const std::filesystem::path &output, int threads)
+{
+    if (!std::filesystem::is_directory(input)) {
+        Logs::Write(LogLevel::Error, "Converter", "%s is not a directory", input.string().c_str());
+        return -1;
+    }
+
+    std::vector<std::filesystem::path> files;
+
+    // error_code overloads throughout, one unreadable folder or a file removed mid-scan skips that entry instead of aborting
+    std::error_code                               ec;
+    std::filesystem::recursive_directory_iterator it(input, std::filesystem::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        auto &entry = *it;
+
+        std::error_code fileError;
+        if (!entry.is_regular_file(fileError)) {
+            continue;
+        }
+
+        auto extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+        if (extension == ".ojn") {
+            files.push_back(entry.path());
+        }
+    }
+
+    if (ec) {
+        Logs::Write(LogLevel::Warning, "Converter", "Stopped scanning %s: %s", input.string().c_str(), ec.message().c_str());
+    }
+
+    if (files.empty()) {
+        Logs::Write(LogLevel::Info, "Converter", "No .ojn files found in %s", input.string().c_str());
+        return 0;
+    }
+
+    if (threads <= 0) {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    threads = std::min(threads, static_cast<int>(files.size()));
+
+    std::string outputPath = output.string();
+
+    std::atomic<size_t>   next = 0;
+    std::atomic<size_t>   done = 0;
+    std::atomic<int>      failed = 0;
+    std::atomic<uint64_t> bytesRead = 0;
+
+    auto worker = [&]() {
+        for (size_t index = next++; index < files.size(); index = next++) {
+            auto &file = files[index];
+
+            try {
+                O2::OJN ojn;
+                ojn.Load(file, true);
+
+                std::error_code ec;
+                for (auto &path : { file, file.parent_path() / ojn.Header.ojm_file }) {
+                    uintmax_t size = std::filesystem::file_size(path, ec);
+                    if (!ec) {
+                        bytesRead += size;
+                    }
+                }
+
+                if (!Converters::SaveTo(&ojn, outputPath.c_str())) {
+                    Logs::Write(LogLevel::Error, "Converter", "Failed to write %s", file.string().c_str());
+                    failed++;
+                }
+            } catch (std::exception &e) {
+                Logs::Write(LogLevel::Error, "Converter", "Failed to convert %s: %s", file.string().c_str(), e.what());
+                failed++;
+            }
+
+            done++;
+        }
+    };
+
+    Logs::Write(LogLevel::Info, "Converter", "Converting %zu songs from %s to %s on %d threads", files.size(), input.string().c_str(), outputPath.c_str(), threads);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+
+    auto report = [&](size_t count) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double rate = seconds > 0 ? count / seconds : 0.0;
+        double remaining = rate > 0 ? (files.size() - count) / rate : 0.0;
+
+        Logs::Write(LogLevel::Info, "Converter", "%zu/%zu songs, %.1f songs/s, %.1f MB/s, elapsed %s, remaining %s",
+                    count,
+                    files.size(),
+                    rate,
+                    seconds > 0 ? bytesRead.load() / (1024.0 * 1024.0) / seconds : 0.0,
+                    FormatSeconds(seconds).c_str(),
+                    FormatSeconds(remaining).c_str());
+    };
+
+    auto lastReport = start;
+    while (done.load() < files.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastReport >= std::chrono::seconds(1)) {
+            report(done.load());
+            lastReport = now;
+        }
+    }
+
+    for (auto &thread : pool) {
+        thread.join();
+    }
+
+    report(done.load());
+    Logs::Write(failed.load() ? LogLevel::Warning : LogLevel::Info, "Converter", "Done, %d failed", failed.load());
+
+    return failed.load();
+}
@@ -3,5 +3,9 @@
 #include <filesystem>
 
 namespace Converters {
-    static bool SaveTo(O2::OJN *ojn, const char *path);
-}
\ No newline at end of file
+    /* Writes every difficulty with notes to [path]/o2ma[id]/, together with the cover and the OJM keysounds when they were loaded; null path means ./Converted */
+    bool SaveTo(O2::OJN *ojn, const char *path);
+
+    /* Converts every .ojn under input on all cores (or threads workers), logs progress and returns how many songs failed */
+    int ConvertLibrary(const std::filesystem::path &input, const std::filesystem::path &output, int threads = 0);
+} // namespace Converters
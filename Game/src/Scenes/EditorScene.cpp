@@ -17,6 +17,9 @@
 #include "../Resources/GameDatabase.h"
 
 constexpr int              noteSize = 12;
+constexpr double           kBeatPerSecs = 240000.0;
+constexpr double           kHitPosition = 720 * 0.8;
+constexpr int              kMinimumMeasures = 16;
 const std::vector<ImColor> laneColor = {
     ImColor(0, 0, 255),
     ImColor(0, 0, 255),
@@ -73,10 +76,35 @@ struct INote
 struct LineInfo
 {
     double Time;
+    int    Measure;
     bool   Major;
     bool   Minor;
 };
 
+/* Timing state right after a measure length (channel 0) or BPM (channel 1) note */
+struct TimingPoint
+{
+    double Position = 0;
+    double Time = 0;
+    double Beat = 0;
+    double BPM = 0;
+    double MeasureLength = 1.0;
+};
+
+namespace {
+    /* The fraction of a measure is scaled by the current measure length, whole measures always count as one */
+    double GetBeat(const TimingPoint &state, double position)
+    {
+        double measure = std::floor(position);
+        return measure + (position - measure) * state.MeasureLength;
+    }
+
+    double GetTimeAt(const TimingPoint &state, double position)
+    {
+        return state.Time + (kBeatPerSecs * (GetBeat(state, position) - state.Beat)) / state.BPM;
+    }
+} // namespace
+
 EditorScene::EditorScene()
 {
     m_exit = false;
@@ -218,11 +246,10 @@ void EditorScene::Render(double delta)
             ImGui::InputInt("###InputMeasureSeparator", &m_measureGridSeparator, 1, 2);
 
             if (m_last_var1 != m_measureGridSize || m_last_var2 != m_measureGridSeparator) {
-                m_lines.clear();
-                m_majorLines.clear();
-
                 m_measureGridSize = std::clamp(m_measureGridSize, 8, 192);
                 m_measureGridSeparator = std::clamp(m_measureGridSeparator, 1, 64);
+
+                RebuildLines(0);
             }
 
             ImGui::NewLine();
@@ -369,121 +396,31 @@ void EditorScene::Render(double delta)
             drawList->AddLine(Pos1, Pos2, ImColor(255, 255, 255));
         }
 
-        std::vector<double> m_time_stop_at;
-        double              audio_length = 0;
-
         { // Draw Notes Here
             if (m_autoscroll) {
                 m_currentTime += ((float)delta * 1000.0f);
             }
 
-            {
-                const double BeatPerSecs = 240000.0;
-                const double BPM = m_bpms[0].second;
-
-                double currentMeasure = 0;
-                int    in_currentMeasure = 0;
-                int    maxMeasure = 300;
-                double currentTimer = 0;
-                double currentMeasureLength = 1.0;
-
-                double currentBPM = BPM;
-                if (m_lines.empty()) {
-                    std::vector<INote> measureList;
-                    for (int i = 0; i < maxMeasure; i++) {
-                        for (float j = 0; j < static_cast<double>(m_measureGridSize); j++) {
-                            INote note = {};
-                            note.Channel = 4;
-                            note.Position = static_cast<double>(i + j / static_cast<double>(m_measureGridSize));
-
-                            measureList.push_back(note);
-                        }
-                    }
-
-                    for (auto &note : m_notes) {
-                        if (note.Channel == 0 || note.Channel == 1) {
-                            measureList.push_back(note);
-                        }
-                    }
-
-                    std::sort(measureList.begin(), measureList.end(), [](auto &noteA, auto &noteB) { return noteA.Position < noteB.Position; });
-
-                    int count = 0;
-                    for (auto &note : measureList) {
-                        double Measure = std::floor(note.Position);
-                        double Position = (note.Position - std::floor(note.Position)) * currentMeasureLength;
-
-                        currentTimer += (BeatPerSecs * ((Measure + Position) - currentMeasure)) / currentBPM;
-                        currentMeasure = Measure + Position;
-                        in_currentMeasure = static_cast<int>(std::floor(currentMeasure));
-
-                        if (note.Channel == 0) {
-                            currentMeasureLength = note.BPMValue;
-                        }
-                        if (note.Channel == 1) {
-                            currentBPM = note.BPMValue;
-                        } else {
-                            LineInfo info = {};
-                            info.Time = currentTimer;
-                            info.Major = note.Position == static_cast<double>(in_currentMeasure);
-                            info.Minor = count % m_measureGridSeparator == 0;
-
-                            count++;
-                            m_lines.push_back(info);
-
-                            if (info.Major) {
-                                m_majorLines.push_back(info);
-                            }
-                        }
-                    }
-                }
-
-                currentBPM = BPM;
-                currentTimer = 0;
-                currentMeasure = 0;
-                currentMeasureLength = 1.0;
-                for (auto &note : m_notes) {
-                    double Measure = std::floor(note.Position);
-                    double Position = (note.Position - std::floor(note.Position)) * currentMeasureLength;
+            UpdateTiming();
 
-                    currentTimer += (BeatPerSecs * ((Measure + Position) - currentMeasure)) / currentBPM;
-                    currentMeasure = Measure + Position;
-
-                    if (note.Channel == 0) {
-                        currentMeasureLength = note.BPMValue;
-                    }
-                    if (note.Channel == 1) {
-                        currentBPM = note.BPMValue;
-                    }
-
-                    note.Time = currentTimer;
-                }
-
-                audio_length = currentTimer + 1500;
-            }
+            // Only the slice of the timeline between the top and bottom of the playfield is walked
+            double viewStart = m_currentTime - (720 - kHitPosition + noteSize) / m_currentNotespeed;
+            double viewEnd = m_currentTime + (kHitPosition + noteSize) / m_currentNotespeed;
 
             // Draw measure line
-            int TimeCurrentMeasure = 0;
-
             if (!m_autoscroll) {
-                for (int i = 0; i < m_lines.size(); i++) {
-                    double time = m_lines[i].Time * 100.0;
-                    double nextTime = 0;
-                    if (i + 1 < m_lines.size()) {
-                        nextTime = m_lines[i + 1].Time * 100.0;
-                    }
-
-                    m_time_stop_at.push_back(time);
+                auto first = std::lower_bound(m_lines.begin(), m_lines.end(), viewStart, [](const LineInfo &line, double time) {
+                    return line.Time < time;
+                });
 
-                    // hitPosition + ((initialTrackPos - offset) * (upscroll ? noteSpeed : -noteSpeed) / 100);
-                    double yPos = (720 * 0.8) + ((time - (m_currentTime * 100)) * -m_currentNotespeed / 100);
-                    double yPos2 = (720 * 0.8) + ((nextTime - (m_currentTime * 100)) * -m_currentNotespeed / 100);
+                for (auto it = first; it != m_lines.end() && it->Time <= viewEnd; it++) {
+                    double yPos = GetLineY(it->Time);
 
                     ImVec2 hitPosVec1 = MathUtil::ScaleVec2(0, yPos) + ImVec2(cursorPosX, 0);
                     ImVec2 hitPosVec2 = MathUtil::ScaleVec2(lanePos.back(), yPos) + ImVec2(cursorPosX, 0);
 
                     // draw line
-                    if (m_lines[i].Minor) {
+                    if (it->Minor) {
                         drawList->AddLine(hitPosVec1, hitPosVec2, ImColor(138, 138, 138), 1.0f);
                     } else {
                         drawList->AddLine(hitPosVec1, hitPosVec2, ImColor(96, 96, 96), 1.0f);
@@ -491,99 +428,87 @@ void EditorScene::Render(double delta)
                 }
             }
 
-            for (int i = 0; i < m_majorLines.size(); i++) {
-                if ((i + 1) < m_majorLines.size()) {
-                    double current = m_majorLines[i].Time * 100;
-                    double next = m_majorLines[i + 1].Time * 100;
+            // A measure is drawn while any part of it is on screen, its label sits between its two lines
+            auto firstMajor = std::lower_bound(m_majorLines.begin(), m_majorLines.end(), viewStart, [](const LineInfo &line, double time) {
+                return line.Time < time;
+            });
 
-                    if (current < m_currentTime * 100 && next > m_currentTime * 100) {
-                        TimeCurrentMeasure = i;
-                    }
+            for (int i = std::max(0, (int)(firstMajor - m_majorLines.begin()) - 1); i + 1 < m_majorLines.size(); i++) {
+                double current = m_majorLines[i].Time;
+                double next = m_majorLines[i + 1].Time;
+
+                if (current > viewEnd) {
+                    break;
+                }
 
-                    double yPos = (720 * 0.8) + ((current - (m_currentTime * 100)) * -m_currentNotespeed / 100);
-                    double yPos2 = (720 * 0.8) + ((next - (m_currentTime * 100)) * -m_currentNotespeed / 100);
+                double yPos = GetLineY(current);
+                double yPos2 = GetLineY(next);
 
-                    ImVec2 middlePos = MathUtil::ScaleVec2(mid_x, (yPos + yPos2) / 2) + ImVec2(cursorPosX, 0);
+                ImVec2 middlePos = MathUtil::ScaleVec2(mid_x, (yPos + yPos2) / 2) + ImVec2(cursorPosX, 0);
 
-                    std::string text = "";
-                    if (i < 10) {
-                        text += "#00";
-                    } else if (i < 100) {
-                        text += "#0";
-                    } else {
-                        text += "#";
-                    }
+                std::string text = "";
+                if (i < 10) {
+                    text += "#00";
+                } else if (i < 100) {
+                    text += "#0";
+                } else {
+                    text += "#";
+                }
 
-                    ImVec2 hitPosVec1 = MathUtil::ScaleVec2(0, yPos) + ImVec2(cursorPosX, 0);
-                    ImVec2 hitPosVec2 = MathUtil::ScaleVec2(lanePos.back(), yPos) + ImVec2(cursorPosX, 0);
-                    drawList->AddLine(hitPosVec1, hitPosVec2, ImColor(255, 255, 0), 1.0f);
+                ImVec2 hitPosVec1 = MathUtil::ScaleVec2(0, yPos) + ImVec2(cursorPosX, 0);
+                ImVec2 hitPosVec2 = MathUtil::ScaleVec2(lanePos.back(), yPos) + ImVec2(cursorPosX, 0);
+                drawList->AddLine(hitPosVec1, hitPosVec2, ImColor(255, 255, 0), 1.0f);
 
-                    text += std::to_string(i);
+                text += std::to_string(i);
 
-                    ImVec2 textSize = FontResources::GetButtonFont()->CalcTextSizeA(75 * fontScale, FLT_MAX, 0, text.c_str());
-                    middlePos.x -= textSize.x / 2.0f;
-                    middlePos.y -= textSize.y / 2.0f;
+                ImVec2 textSize = FontResources::GetButtonFont()->CalcTextSizeA(75 * fontScale, FLT_MAX, 0, text.c_str());
+                middlePos.x -= textSize.x / 2.0f;
+                middlePos.y -= textSize.y / 2.0f;
 
-                    drawList->AddText(FontResources::GetButtonFont(), 75 * fontScale, middlePos, ImColor(128, 128, 128), text.c_str());
-                }
+                drawList->AddText(FontResources::GetButtonFont(), 75 * fontScale, middlePos, ImColor(128, 128, 128), text.c_str());
             }
 
-            std::vector<INote> toDraw;
-            {
-                double HoldTime[7] = { -1, -1, -1, -1, -1, -1, -1 };
-
-                for (INote note : m_notes) {
-                    if (note.IsLN) {
-                        if (HoldTime[note.Channel - 2] != -1) {
-                            note.EndTime = note.Time;
-                            note.Time = HoldTime[note.Channel - 2];
-                            HoldTime[note.Channel - 2] = -1;
-
-                            toDraw.push_back(note);
-                        } else {
-                            HoldTime[note.Channel - 2] = note.Time;
-                        }
-                    } else {
-                        toDraw.push_back(note);
+            // check if difference between time and m_currentTime is less than 25 ms
+            if (m_autoscroll) {
+                auto first = std::upper_bound(m_drawNotes.begin(), m_drawNotes.end(), m_currentTime - 25.0, [](double time, const INote &note) {
+                    return time < note.Time;
+                });
+
+                for (auto it = first; it != m_drawNotes.end() && it->Time <= m_currentTime; it++) {
+                    if (!it->IsBPM) {
+                        PlaySample(it->SampleRefId);
                     }
                 }
             }
 
-            // Draw notes
+            // Draw notes, holds that started above the screen are found by looking back the longest hold
             {
-                for (auto &note : toDraw) {
-                    double time = note.Time * 100;
-                    double yPos = ((720 * 0.8) + ((time - (m_currentTime * 100)) * -m_currentNotespeed / 100));
-                    yPos -= noteSize;
-
-                    // check if difference between time and m_currentTime is less than 5 seconds
-                    if (m_currentTime >= note.Time && m_autoscroll && !note.IsBPM) {
-                        if (std::abs(note.Time - m_currentTime) < 25) {
-                            PlaySample(note.SampleRefId);
-                        }
-                    }
+                auto first = std::lower_bound(m_drawNotes.begin(), m_drawNotes.end(), viewStart - m_longestHold, [](const INote &note, double time) {
+                    return note.Time < time;
+                });
+
+                for (auto it = first; it != m_drawNotes.end() && it->Time <= viewEnd; it++) {
+                    auto &note = *it;
 
                     if (note.Channel >= lanePos.size()) {
                         continue;
                     }
 
-                    ImColor color = note.Channel < laneColor.size() ? laneColor[note.Channel] : ImColor(255, 255, 255);
-
-                    if ((yPos < 0 || yPos > 720) && !note.IsLN) {
+                    if (note.EndTime == -1 ? note.Time < viewStart : note.EndTime < viewStart) {
                         continue;
                     }
 
+                    double yPos = GetLineY(note.Time) - noteSize;
+
+                    ImColor color = note.Channel < laneColor.size() ? laneColor[note.Channel] : ImColor(255, 255, 255);
+
                     ImVec2 head_pos = MathUtil::ScaleVec2(lanePos[note.Channel], yPos) + ImVec2(cursorPosX, 0);
                     ImVec2 head_size = MathUtil::ScaleVec2(lanePos[note.Channel + 1], yPos + noteSize) + ImVec2(cursorPosX, 0);
 
                     ImVec2 tail_pos, tail_size;
 
-                    auto drawList = ImGui::GetWindowDrawList();
-
                     if (note.EndTime != -1) {
-                        double endtime = note.EndTime * 100;
-                        double ayPos = ((720 * 0.8) + ((endtime - (m_currentTime * 100)) * -m_currentNotespeed / 100));
-                        ayPos -= noteSize;
+                        double ayPos = GetLineY(note.EndTime) - noteSize;
 
                         tail_pos = MathUtil::ScaleVec2(lanePos[note.Channel], ayPos) + ImVec2(cursorPosX, 0);
                         tail_size = MathUtil::ScaleVec2(lanePos[note.Channel + 1], ayPos + noteSize) + ImVec2(cursorPosX, 0);
@@ -633,7 +558,7 @@ void EditorScene::Render(double delta)
             FontResources::GetReallyBigFontForSlider()->FontSize = window_sz.y - MathUtil::ScaleVec2(0, 12).y;
 
             ImGui::PushFont(FontResources::GetReallyBigFontForSlider());
-            ImGui::SliderFloat("###ProgressSlider", &m_currentTime, 0.0f, (float)audio_length, "", flags);
+            ImGui::SliderFloat("###ProgressSlider", &m_currentTime, 0.0f, (float)m_chartLength, "", flags);
             ImGui::PopFont();
 
             FontResources::GetReallyBigFontForSlider()->FontSize = lastSize;
@@ -646,39 +571,33 @@ void EditorScene::Render(double delta)
             m_currentTime = std::clamp(m_currentTime + ImGui::GetIO().MouseWheel * 100.0f, 0.0f, FLT_MAX);
         }
 
-        std::sort(m_time_stop_at.begin(), m_time_stop_at.end());
+        // Space, Up and Down snap to the grid lines, which are sorted by time
+        auto nextLine = std::lower_bound(m_lines.begin(), m_lines.end(), (double)m_currentTime, [](const LineInfo &line, double time) {
+            return line.Time < time;
+        });
 
         // check space bar then toggle autoScroll
         if (ImGui::IsKeyPressed(ImGuiKey_Space)) {
-            if (m_autoscroll) {
-                auto it = std::lower_bound(m_time_stop_at.begin(), m_time_stop_at.end(), m_currentTime * 100);
-                if (it != m_time_stop_at.end()) {
-                    m_currentTime = (float)((*it) / 100.0);
-                }
+            if (m_autoscroll && nextLine != m_lines.end()) {
+                m_currentTime = (float)nextLine->Time;
             }
 
             m_autoscroll = !m_autoscroll;
         }
 
         if (ImGui::IsKeyPressed(ImGuiKey_UpArrow) && !m_autoscroll) {
-            auto it = std::lower_bound(m_time_stop_at.begin(), m_time_stop_at.end(), m_currentTime * 100);
-            if (it != m_time_stop_at.end()) {
-                if ((int)(it - m_time_stop_at.begin()) < (int)m_time_stop_at.size()) {
-                    m_currentTime = (float)((*(it + 1)) / 100.0);
-                }
+            if (nextLine != m_lines.end() && nextLine + 1 != m_lines.end()) {
+                m_currentTime = (float)(nextLine + 1)->Time;
             }
         }
 
         if (ImGui::IsKeyPressed(ImGuiKey_DownArrow) && !m_autoscroll) {
-            auto it = std::lower_bound(m_time_stop_at.begin(), m_time_stop_at.end(), m_currentTime * 100);
-            if (it != m_time_stop_at.end()) {
-                if (it - m_time_stop_at.begin() > 0) {
-                    m_currentTime = (float)((*(it - 1)) / 100.0);
-                }
+            if (nextLine != m_lines.end() && nextLine != m_lines.begin()) {
+                m_currentTime = (float)(nextLine - 1)->Time;
             }
         }
 
-        if (m_currentTime >= audio_length) {
+        if (m_currentTime >= m_chartLength) {
             m_autoscroll = false;
         }
 
@@ -785,6 +704,9 @@ bool EditorScene::Attach()
     }
 
     m_measureGridSize = 16, m_measureGridSeparator = 4;
+    m_lines.clear();
+    m_majorLines.clear();
+    InvalidateTiming(0);
 
     m_ready = true;
     SceneManager::DisplayFade(0, [] {
@@ -807,6 +729,9 @@ bool EditorScene::Detach()
     m_tracked_audio_sample.clear();
     m_lines.clear();
     m_majorLines.clear();
+    m_timings.clear();
+    m_drawNotes.clear();
+    m_dirtyMeasure = -1;
 
     m_ready = false;
     AudioManager::GetInstance()->RemoveAll();
@@ -946,4 +871,145 @@ void EditorScene::LoadDifficulty(int idx)
     std::sort(m_notes.begin(), m_notes.end(), [](auto &n1, auto &n2) {
         return n1.Position < n2.Position;
     });
+
+    m_timings.clear();
+    InvalidateTiming(0);
+}
+
+void EditorScene::InvalidateTiming(double position)
+{
+    int measure = std::max(0, static_cast<int>(std::floor(position)));
+    m_dirtyMeasure = m_dirtyMeasure < 0 ? measure : std::min(m_dirtyMeasure, measure);
+}
+
+void EditorScene::UpdateTiming()
+{
+    if (m_dirtyMeasure < 0) {
+        return;
+    }
+
+    double dirtyPosition = static_cast<double>(m_dirtyMeasure);
+    int    lineMeasure = std::min(m_dirtyMeasure, m_measureCount);
+    m_dirtyMeasure = -1;
+
+    // Everything before the first edited measure keeps its time, the rest is replayed from the last timing point kept
+    auto keptTimings = std::lower_bound(m_timings.begin(), m_timings.end(), dirtyPosition, [](const TimingPoint &timing, double position) {
+        return timing.Position < position;
+    });
+    m_timings.erase(keptTimings, m_timings.end());
+
+    auto firstNote = std::lower_bound(m_notes.begin(), m_notes.end(), dirtyPosition, [](const INote &note, double position) {
+        return note.Position < position;
+    });
+
+    TimingPoint state = m_timings.empty() ? GetInitialTiming() : m_timings.back();
+    for (auto it = firstNote; it != m_notes.end(); it++) {
+        state.Time = GetTimeAt(state, it->Position);
+        state.Beat = GetBeat(state, it->Position);
+        state.Position = it->Position;
+
+        if (it->Channel == 0) {
+            state.MeasureLength = it->BPMValue;
+        }
+        if (it->Channel == 1) {
+            state.BPM = it->BPMValue;
+        }
+
+        it->Time = state.Time;
+
+        if (it->Channel == 0 || it->Channel == 1) {
+            m_timings.push_back(state);
+        }
+    }
+
+    m_chartLength = (m_notes.empty() ? 0.0 : m_notes.back().Time) + 1500;
+
+    // Long notes are stored as head and tail, pair them up once instead of every frame
+    m_drawNotes.clear();
+    m_longestHold = 0;
+    {
+        double HoldTime[7] = { -1, -1, -1, -1, -1, -1, -1 };
+
+        for (auto &note : m_notes) {
+            if (note.IsLN) {
+                if (HoldTime[note.Channel - 2] != -1) {
+                    INote hold = note;
+                    hold.EndTime = note.Time;
+                    hold.Time = HoldTime[note.Channel - 2];
+                    HoldTime[note.Channel - 2] = -1;
+
+                    m_longestHold = std::max(m_longestHold, hold.EndTime - hold.Time);
+                    m_drawNotes.push_back(hold);
+                } else {
+                    HoldTime[note.Channel - 2] = note.Time;
+                }
+            } else {
+                m_drawNotes.push_back(note);
+            }
+        }
+    }
+
+    std::stable_sort(m_drawNotes.begin(), m_drawNotes.end(), [](const INote &a, const INote &b) {
+        return a.Time < b.Time;
+    });
+
+    RebuildLines(lineMeasure);
+}
+
+void EditorScene::RebuildLines(int fromMeasure)
+{
+    // Lines cover the chart plus a measure of headroom instead of a fixed measure count
+    double lastPosition = m_notes.empty() ? 0.0 : m_notes.back().Position;
+    m_measureCount = std::max(kMinimumMeasures, static_cast<int>(std::floor(lastPosition)) + 2);
+
+    fromMeasure = std::clamp(fromMeasure, 0, m_measureCount);
+
+    auto keptLines = std::find_if(m_lines.begin(), m_lines.end(), [fromMeasure](const LineInfo &line) {
+        return line.Measure >= fromMeasure;
+    });
+    m_lines.erase(keptLines, m_lines.end());
+    m_majorLines.resize(std::min<size_t>(m_majorLines.size(), fromMeasure));
+
+    TimingPoint initial = GetInitialTiming();
+    size_t      timing = std::lower_bound(m_timings.begin(), m_timings.end(), static_cast<double>(fromMeasure), [](const TimingPoint &point, double position) {
+        return point.Position <= position;
+    }) - m_timings.begin();
+
+    for (int i = fromMeasure; i < m_measureCount; i++) {
+        for (int j = 0; j < m_measureGridSize; j++) {
+            double position = i + j / static_cast<double>(m_measureGridSize);
+
+            while (timing < m_timings.size() && m_timings[timing].Position <= position) {
+                timing++;
+            }
+
+            const TimingPoint &state = timing > 0 ? m_timings[timing - 1] : initial;
+
+            LineInfo info = {};
+            info.Time = GetTimeAt(state, position);
+            info.Measure = i;
+            info.Major = j == 0;
+            info.Minor = (i * m_measureGridSize + j) % m_measureGridSeparator == 0;
+
+            m_lines.push_back(info);
+
+            if (info.Major) {
+                m_majorLines.push_back(info);
+            }
+        }
+    }
+}
+
+TimingPoint EditorScene::GetInitialTiming() const
+{
+    TimingPoint initial = {};
+    initial.BPM = m_bpms.empty() ? 240.0 : m_bpms[0].second;
+
+    return initial;
+}
+
+double EditorScene::GetLineY(double time) const
+{
+    // hitPosition + ((initialTrackPos - offset) * (upscroll ? noteSpeed : -noteSpeed) / 100);
+    return kHitPosition + ((time - m_currentTime) * -m_currentNotespeed);
 }
@@ -13,6 +13,7 @@ struct INote;
 struct O2Sample;
 struct O2Note;
 struct LineInfo;
+struct TimingPoint;
 
 class EditorScene : public Scene
 {
@@ -31,15 +32,30 @@ private:
 
     void LoadDifficulty(int idx);
 
-    std::vector<INote>    m_notes;
+    /* Marks note times and grid lines stale from the measure containing position onward */
+    void InvalidateTiming(double position);
+    void UpdateTiming();
+    void RebuildLines(int fromMeasure);
+
+    TimingPoint GetInitialTiming() const;
+    double      GetLineY(double time) const;
+
+    std::vector<INote>    m_notes; // Sorted by position
+    std::vector<INote>    m_drawNotes; // Long notes paired up, sorted by time
     std::vector<O2Sample> m_samples;
 
     std::vector<std::pair<double, double>>        m_bpms;
     std::unordered_map<int, AudioSample *>        m_audio_sample;
     std::unordered_map<int, AudioSampleChannel *> m_tracked_audio_sample;
 
-    std::vector<LineInfo> m_lines;
-    std::vector<LineInfo> m_majorLines;
+    std::vector<LineInfo>    m_lines;
+    std::vector<LineInfo>    m_majorLines;
+    std::vector<TimingPoint> m_timings;
+
+    int    m_dirtyMeasure = -1;
+    int    m_measureCount = 0;
+    double m_chartLength = 1500;
+    double m_longestHold = 0;
 
     int m_measureGridSize = 16, m_measureGridSeparator = 4;
     int m_currentDifficulty = 0;
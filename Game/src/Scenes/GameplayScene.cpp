@@ -18,6 +18,7 @@
 #include "Imgui/imgui.h"
 #include "Texture/ImageGenerator.h"
 #include "Texture/MathUtils.h"
+#include "Texture/TextureCache.h"
 
 #include "../Engine/NoteImageCacheManager.hpp"
 #include "../Engine/SkinConfig.hpp"
@@ -27,6 +28,31 @@
 
 #define AUTOPLAY_TEXT u8"Game currently on autoplay!"
 
+// Every Playing.ini key the scene reads, checked as a whole before the layout is built; optional elements are left out when missing
+namespace PlayingSkin {
+    const SkinKey TitlePosition = SkinKeys::Optional(SkinGroup::Playing, SkinDataType::Position, "Title");
+    const SkinKey TitleRect = SkinKeys::Optional(SkinGroup::Playing, SkinDataType::Rect, "Title");
+    const SkinKey KeyLighting = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Position, "KeyLighting");
+    const SkinKey KeyButton = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Position, "KeyButton");
+    const SkinKey Playfield = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Position, "Playfield");
+    const SkinKey Jam = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Numeric, "Jam");
+    const SkinKey Score = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Numeric, "Score");
+    const SkinKey JamGauge = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Position, "JamGauge");
+    const SkinKey JamLogo = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Sprite, "JamLogo");
+    const SkinKey LifeBar = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Sprite, "LifeBar");
+    const SkinKey Stats = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Numeric, "Stats");
+    const SkinKey LongNoteCombo = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Numeric, "LongNoteCombo");
+    const SkinKey ExitButton = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Position, "ExitButton");
+    const SkinKey ExitRect = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Rect, "Exit");
+    const SkinKey LongNoteLogo = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Sprite, "LongNoteLogo");
+    const SkinKey WaveGage = SkinKeys::Optional(SkinGroup::Playing, SkinDataType::Position, "WaveGage");
+    const SkinKey TargetBar = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Sprite, "TargetBar");
+    const SkinKey Playfooter = SkinKeys::Optional(SkinGroup::Playing, SkinDataType::Position, "Playfooter");
+    const SkinKey Minute = SkinKeys::Optional(SkinGroup::Playing, SkinDataType::Numeric, "Minute");
+    const SkinKey Second = SkinKeys::Optional(SkinGroup::Playing, SkinDataType::Numeric, "Second");
+    const SkinKey Pill = SkinKeys::Require(SkinGroup::Playing, SkinDataType::Position, "Pill");
+} // namespace PlayingSkin
+
 struct MissInfo
 {
     int   type;
@@ -72,13 +98,23 @@ void GameplayScene::Update(double delta)
     if (!m_starting) {
         m_starting = true;
         m_game->Start();
+
+        // Loading takes a different number of frames every run, only gameplay frames are measured
+        if (EnvironmentSetup::GetInt("Benchmark") == 1) {
+            Renderer::GetInstance()->BeginCapture();
+        }
     }
 
     if (m_game->GetState() == GameState::PosGame && !m_ended) {
         m_ended = true;
-        SceneManager::DisplayFade(100, [] {
-            SceneManager::ChangeScene(GameScene::RESULT);
-        });
+
+        if (EnvironmentSetup::GetInt("Benchmark") == 1) {
+            SceneManager::GetInstance()->StopGame();
+        } else {
+            SceneManager::DisplayFade(100, [] {
+                SceneManager::ChangeScene(GameScene::RESULT);
+            });
+        }
     }
 
     int difficulty = EnvironmentSetup::GetInt("Difficulty");
@@ -131,7 +167,10 @@ void GameplayScene::Render(double delta)
         }
     }
 
-    m_Playfooter->Draw();
+    if (m_Playfooter) {
+        m_Playfooter->Draw();
+    }
+
     m_Playfield->Draw();
     if (!is_flhd_enabled) {
         m_targetBar->Draw(delta);
@@ -314,7 +353,7 @@ void GameplayScene::Render(double delta)
     }
 
     float currentProgress = (float)m_game->GetAudioPosition() / (float)m_game->GetAudioLength();
-    if (currentProgress > 0) {
+    if (currentProgress > 0 && m_waveGage) {
         m_waveGage->CalculateSize();
 
         int min = 0, max = (int)m_waveGage->AbsoluteSize.X;
@@ -334,10 +373,15 @@ void GameplayScene::Render(double delta)
     int currentMinutes = PlayTime / 60;
     int currentSeconds = PlayTime % 60;
 
-    m_minuteNum->SetValue(currentMinutes);
-    m_minuteNum->DrawNumber(currentMinutes);
-    m_secondNum->SetValue(currentSeconds);
-    m_secondNum->DrawNumber(currentSeconds);
+    if (m_minuteNum) {
+        m_minuteNum->SetValue(currentMinutes);
+        m_minuteNum->DrawNumber(currentMinutes);
+    }
+
+    if (m_secondNum) {
+        m_secondNum->SetValue(currentSeconds);
+        m_secondNum->DrawNumber(currentSeconds);
+    }
 
     for (int i = 0; i < 7; i++) {
         m_hitEffect[i]->Draw(delta);
@@ -351,7 +395,9 @@ void GameplayScene::Render(double delta)
         m_exitBtn->Draw();
     }
 
-    m_title->Draw(m_game->GetTitle());
+    if (m_title) {
+        m_title->Draw(m_game->GetTitle());
+    }
 
     if (m_autoPlay) {
         m_autoText->Position = m_autoTextPos;
@@ -389,14 +435,6 @@ void GameplayScene::OnKeyDown(const KeyState &state)
     m_game->OnKeyDown(state);
 }
 
-void GameplayScene::OnKeyUp(const KeyState &state)
-{
-    if (m_resourceFucked)
-        return;
-
-    m_game->OnKeyUp(state);
-}
-
 void GameplayScene::OnMouseDown(const MouseState &state)
 {
 }
@@ -419,9 +457,14 @@ bool GameplayScene::Attach()
         int LaneOffset = 5;
         int HitPos = 480;
 
+        std::string skinError;
+        if (!manager->Validate(SkinGroup::Playing, skinError)) {
+            throw std::runtime_error(skinError);
+        }
+
         try {
-            LaneOffset = std::stoi(manager->GetSkinProp("Game", "LaneOffset", "5"));
-            HitPos = std::stoi(manager->GetSkinProp("Game", "HitPos", "480"));
+            LaneOffset = std::stoi(manager->GetSkinProp(SkinManager::PropKey("Game", "LaneOffset"), "5"));
+            HitPos = std::stoi(manager->GetSkinProp(SkinManager::PropKey("Game", "HitPos"), "480"));
         } catch (const std::invalid_argument &) {
             throw std::runtime_error("Invalid parameter on Skin::Game::LaneOffset or Skin::Game::HitPos");
         }
@@ -456,38 +499,43 @@ bool GameplayScene::Attach()
             m_drawHold[i] = false;
         }
 
-        m_title = std::make_unique<Text>(13);
-        auto TitlePos = manager->GetPosition(SkinGroup::Playing, "Title"); // conf.GetPosition("Title");
-        auto RectPos = manager->GetRect(SkinGroup::Playing, "Title");      // conf.GetRect("Title");
-        m_title->Position = UDim2::fromOffset(TitlePos[0].X, TitlePos[0].Y);
-        m_title->AnchorPoint = { TitlePos[0].AnchorPointX, TitlePos[0].AnchorPointY };
-        m_title->Clip = { RectPos[0].X, RectPos[0].Y, RectPos[0].Width, RectPos[0].Height };
+        if (manager->Contains(SkinGroup::Playing, SkinDataType::Position, PlayingSkin::TitlePosition) && manager->Contains(SkinGroup::Playing, SkinDataType::Rect, PlayingSkin::TitleRect)) {
+            auto TitlePos = manager->GetPosition(SkinGroup::Playing, PlayingSkin::TitlePosition); // conf.GetPosition("Title");
+            auto RectPos = manager->GetRect(SkinGroup::Playing, PlayingSkin::TitleRect);          // conf.GetRect("Title");
+
+            if (TitlePos.size() > 0 && RectPos.size() > 0) {
+                m_title = std::make_unique<Text>(13);
+                m_title->Position = UDim2::fromOffset(TitlePos[0].X, TitlePos[0].Y);
+                m_title->AnchorPoint = { TitlePos[0].AnchorPointX, TitlePos[0].AnchorPointY };
+                m_title->Clip = { RectPos[0].X, RectPos[0].Y, RectPos[0].Width, RectPos[0].Height };
+            }
+        }
 
         m_autoText = std::make_unique<Text>(13);
         m_autoTextSize = m_autoText->CalculateSize(AUTOPLAY_TEXT);
 
         m_autoTextPos = UDim2::fromOffset(GameWindow::GetInstance()->GetBufferWidth(), 50);
 
-        m_PlayBG = std::make_unique<Texture2D>(arenaPath / ("PlayingBG.png"));
+        m_PlayBG = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(arenaPath / ("PlayingBG.png")));
         auto PlayBGPos = manager->Arena_GetPosition("PlayingBG"); // arena_conf.GetPosition("PlayingBG");
         m_PlayBG->Position = UDim2::fromOffset(PlayBGPos[0].X, PlayBGPos[0].Y);
         m_PlayBG->AnchorPoint = { PlayBGPos[0].AnchorPointX, PlayBGPos[0].AnchorPointY };
 
-        auto conKeyLight = manager->GetPosition(SkinGroup::Playing, "KeyLighting"); // conf.GetPosition("KeyLighting");
-        auto conKeyButton = manager->GetPosition(SkinGroup::Playing, "KeyButton");  // conf.GetPosition("KeyButton");
+        auto conKeyLight = manager->GetPosition(SkinGroup::Playing, PlayingSkin::KeyLighting); // conf.GetPosition("KeyLighting");
+        auto conKeyButton = manager->GetPosition(SkinGroup::Playing, PlayingSkin::KeyButton);  // conf.GetPosition("KeyButton");
 
         if (conKeyLight.size() < 7 || conKeyButton.size() < 7) {
             throw std::runtime_error("Playing.ini : Positions : KeyLighting#KeyButton : Not enough positions! (count < 7)");
         }
 
-        auto playfieldPos = manager->GetPosition(SkinGroup::Playing, "Playfield"); // conf.GetPosition("Playfield");
-        m_Playfield = std::make_unique<Texture2D>(playingPath / "Playfield.png");
+        auto playfieldPos = manager->GetPosition(SkinGroup::Playing, PlayingSkin::Playfield); // conf.GetPosition("Playfield");
+        m_Playfield = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(playingPath / "Playfield.png"));
         m_Playfield->Position = UDim2::fromOffset(playfieldPos[0].X, playfieldPos[0].Y);
         m_Playfield->AnchorPoint = { playfieldPos[0].AnchorPointX, playfieldPos[0].AnchorPointY };
 
         for (int i = 0; i < 7; i++) {
-            m_keyLighting[i] = std::move(std::make_unique<Texture2D>(playingPath / ("KeyLighting" + std::to_string(i) + ".png")));
-            m_keyButtons[i] = std::move(std::make_unique<Texture2D>(playingPath / ("KeyButton" + std::to_string(i) + ".png")));
+            m_keyLighting[i] = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(playingPath / ("KeyLighting" + std::to_string(i) + ".png")));
+            m_keyButtons[i] = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(playingPath / ("KeyButton" + std::to_string(i) + ".png")));
 
             m_keyLighting[i]->Position = UDim2::fromOffset(conKeyLight[i].X, conKeyLight[i].Y);
             m_keyButtons[i]->Position = UDim2::fromOffset(conKeyButton[i].X, conKeyButton[i].Y);
@@ -529,7 +577,7 @@ bool GameplayScene::Attach()
         }
 
         m_jamNum = std::make_unique<NumericTexture>(numJamPaths);
-        numPos = manager->GetNumeric(SkinGroup::Playing, "Jam").front();
+        numPos = manager->GetNumeric(SkinGroup::Playing, PlayingSkin::Jam).front();
 
         m_jamNum->Position = UDim2::fromOffset(numPos.X, numPos.Y);
         m_jamNum->NumberPosition = IntToPos(numPos.Direction);
@@ -550,7 +598,7 @@ bool GameplayScene::Attach()
         }
 
         m_scoreNum = std::make_unique<NumericTexture>(numScorePaths);
-        numPos = manager->GetNumeric(SkinGroup::Playing, "Score").front(); // conf.GetNumeric("Score").front();
+        numPos = manager->GetNumeric(SkinGroup::Playing, PlayingSkin::Score).front(); // conf.GetNumeric("Score").front();
 
         m_scoreNum->Position = UDim2::fromOffset(numPos.X, numPos.Y);
         m_scoreNum->NumberPosition = IntToPos(numPos.Direction);
@@ -570,13 +618,13 @@ bool GameplayScene::Attach()
                 throw std::runtime_error("Failed to load Judge image!");
             }
 
-            m_judgement[i] = std::move(std::make_unique<Texture2D>(filePath));
+            m_judgement[i] = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(filePath));
             m_judgement[i]->Position = UDim2::fromOffset(judgePos[i].X, judgePos[i].Y);
             m_judgement[i]->AlphaBlend = true;
         }
 
-        m_jamGauge = std::make_unique<Texture2D>(playingPath / "JamGauge.png");
-        auto gaugePos = manager->GetPosition(SkinGroup::Playing, "JamGauge"); // conf.GetPosition("JamGauge");
+        m_jamGauge = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(playingPath / "JamGauge.png"));
+        auto gaugePos = manager->GetPosition(SkinGroup::Playing, PlayingSkin::JamGauge); // conf.GetPosition("JamGauge");
         if (gaugePos.size() < 1) {
             throw std::runtime_error("Playing.ini : Positions : JamGauge : Position Not defined!");
         }
@@ -584,7 +632,7 @@ bool GameplayScene::Attach()
         m_jamGauge->Position = UDim2::fromOffset(gaugePos[0].X, gaugePos[0].Y);
         m_jamGauge->AnchorPoint = { gaugePos[0].AnchorPointX, gaugePos[0].AnchorPointY };
 
-        auto                               jamLogoPos = manager->GetSprite(SkinGroup::Playing, "JamLogo"); // conf.GetSprite("JamLogo");
+        auto                               jamLogoPos = manager->GetSprite(SkinGroup::Playing, PlayingSkin::JamLogo); // conf.GetSprite("JamLogo");
         std::vector<std::filesystem::path> jamLogoFileName = {};
         for (int i = 0; i < jamLogoPos.numOfFrames; i++) {
             auto filePath = playingPath / ("JamLogo" + std::to_string(i) + ".png");
@@ -603,7 +651,7 @@ bool GameplayScene::Attach()
         m_jamLogo->AnchorPoint = { (double)jamLogoPos.AnchorPointX, (double)jamLogoPos.AnchorPointY };
         m_jamLogo->SetFPS(jamLogoPos.FrameTime);
 
-        auto                               lifeBarPos = manager->GetSprite(SkinGroup::Playing, "LifeBar"); // conf.GetSprite("LifeBar");
+        auto                               lifeBarPos = manager->GetSprite(SkinGroup::Playing, PlayingSkin::LifeBar); // conf.GetSprite("LifeBar");
         std::vector<std::filesystem::path> lifeBarFileName = {};
         for (int i = 0; i < lifeBarPos.numOfFrames; i++) {
             auto filePath = playingPath / ("LifeBar" + std::to_string(i) + ".png");
@@ -646,7 +694,7 @@ bool GameplayScene::Attach()
         }
 
         m_statsNum = std::make_unique<NumericTexture>(statsNumFileName);
-        auto statsNumPos = manager->GetNumeric(SkinGroup::Playing, "Stats"); // conf.GetNumeric("Stats");
+        auto statsNumPos = manager->GetNumeric(SkinGroup::Playing, PlayingSkin::Stats); // conf.GetNumeric("Stats");
         if (statsNumPos.size() < 5) {
             throw std::runtime_error("Playing.ini : Numerics : Stats : Not enough positions! (count < 5)");
         }
@@ -663,19 +711,19 @@ bool GameplayScene::Attach()
         }
 
         m_lnComboNum = std::make_unique<NumericTexture>(lnComboFileName);
-        auto lnComboPos = manager->GetNumeric(SkinGroup::Playing, "LongNoteCombo"); // conf.GetNumeric("LongNoteCombo");
+        auto lnComboPos = manager->GetNumeric(SkinGroup::Playing, PlayingSkin::LongNoteCombo); // conf.GetNumeric("LongNoteCombo");
         if (lnComboPos.size() < 1) {
             throw std::runtime_error("Playing.ini : Numerics : LongNoteCombo : Position Not defined!");
         }
 
-        auto btnExitPos = manager->GetPosition(SkinGroup::Playing, "ExitButton"); // conf.GetPosition("ExitButton");
-        auto btnExitRect = manager->GetRect(SkinGroup::Playing, "Exit");          // conf.GetRect("Exit");
+        auto btnExitPos = manager->GetPosition(SkinGroup::Playing, PlayingSkin::ExitButton); // conf.GetPosition("ExitButton");
+        auto btnExitRect = manager->GetRect(SkinGroup::Playing, PlayingSkin::ExitRect);          // conf.GetRect("Exit");
 
         if (btnExitPos.size() < 1 || btnExitRect.size() < 1) {
             throw std::runtime_error("Playing.ini : Positions|Rect : Exit : Not defined!");
         }
 
-        m_exitBtn = std::make_unique<Texture2D>(playingPath / "Exit.png");
+        m_exitBtn = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(playingPath / "Exit.png"));
         m_exitBtn->Position = UDim2::fromOffset(btnExitRect[0].X, btnExitRect[0].Y); // Fix Exit not functional with Playing.ini
         m_exitBtn->AnchorPoint = { btnExitPos[0].AnchorPointX, btnExitPos[0].AnchorPointY };
 
@@ -697,7 +745,7 @@ bool GameplayScene::Attach()
         m_lnComboNum->FillWithZeros = lnComboPos[0].FillWithZero;
         m_lnComboNum->AlphaBlend = true;
 
-        auto                               lnLogoPos = manager->GetSprite(SkinGroup::Playing, "LongNoteLogo"); // conf.GetSprite("LongNoteLogo");
+        auto                               lnLogoPos = manager->GetSprite(SkinGroup::Playing, PlayingSkin::LongNoteLogo); // conf.GetSprite("LongNoteLogo");
         std::vector<std::filesystem::path> lnLogoFileName = {};
         for (int i = 0; i < lnLogoPos.numOfFrames; i++) {
             auto filePath = playingPath / ("LongNoteLogo" + std::to_string(i) + ".png");
@@ -734,10 +782,14 @@ bool GameplayScene::Attach()
         m_comboLogo->SetFPS(comboLogoPos.FrameTime);
         m_comboLogo->AlphaBlend = true;
 
-        m_waveGage = std::make_unique<Texture2D>(playingPath / "WaveGage.png");
-        auto waveGagePos = manager->GetPosition(SkinGroup::Playing, "WaveGage").front(); // conf.GetPosition("WaveGage").front();
-        m_waveGage->Position = UDim2::fromOffset(waveGagePos.X, waveGagePos.Y);
-        m_waveGage->AnchorPoint = { waveGagePos.AnchorPointX, waveGagePos.AnchorPointY };
+        if (manager->Contains(SkinGroup::Playing, SkinDataType::Position, PlayingSkin::WaveGage)) {
+            auto waveGagePos = manager->GetPosition(SkinGroup::Playing, PlayingSkin::WaveGage); // conf.GetPosition("WaveGage").front();
+            if (waveGagePos.size() > 0) {
+                m_waveGage = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(playingPath / "WaveGage.png"));
+                m_waveGage->Position = UDim2::fromOffset(waveGagePos[0].X, waveGagePos[0].Y);
+                m_waveGage->AnchorPoint = { waveGagePos[0].AnchorPointX, waveGagePos[0].AnchorPointY };
+            }
+        }
 
         std::vector<std::filesystem::path> numTimerPaths = {};
         for (int i = 0; i < 10; i++) {
@@ -748,7 +800,7 @@ bool GameplayScene::Attach()
             }
         }
 
-        auto                               targetPos = manager->GetSprite(SkinGroup::Playing, "TargetBar"); // conf.GetSprite("TargetBar");
+        auto                               targetPos = manager->GetSprite(SkinGroup::Playing, PlayingSkin::TargetBar); // conf.GetSprite("TargetBar");
         std::vector<std::filesystem::path> targetBarPaths = {};
         for (int i = 0; i < targetPos.numOfFrames; i++) {
             auto filePath = playingPath / ("TargetBar" + std::to_string(i) + ".png");
@@ -760,31 +812,43 @@ bool GameplayScene::Attach()
             targetBarPaths.emplace_back(filePath);
         }
 
-        auto playfooterPos = manager->GetPosition(SkinGroup::Playing, "Playfooter").front();
-        m_Playfooter = std::make_unique<Texture2D>(playingPath / "PlayfieldFooter.png");
-        m_Playfooter->Position = UDim2::fromOffset(playfooterPos.X, playfooterPos.Y);
-        m_Playfooter->AnchorPoint = { playfooterPos.AnchorPointX, playfooterPos.AnchorPointY };
+        if (manager->Contains(SkinGroup::Playing, SkinDataType::Position, PlayingSkin::Playfooter)) {
+            auto playfooterPos = manager->GetPosition(SkinGroup::Playing, PlayingSkin::Playfooter);
+            if (playfooterPos.size() > 0) {
+                m_Playfooter = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(playingPath / "PlayfieldFooter.png"));
+                m_Playfooter->Position = UDim2::fromOffset(playfooterPos[0].X, playfooterPos[0].Y);
+                m_Playfooter->AnchorPoint = { playfooterPos[0].AnchorPointX, playfooterPos[0].AnchorPointY };
+            }
+        }
 
         m_targetBar = std::make_unique<Sprite2D>(targetBarPaths);
         m_targetBar->Position = UDim2::fromOffset(targetPos.X, targetPos.Y);
         m_targetBar->AnchorPoint = { targetPos.AnchorPointX, targetPos.AnchorPointY };
         m_targetBar->SetFPS(targetPos.FrameTime);
 
-        m_minuteNum = std::make_unique<NumericTexture>(numTimerPaths);
-        auto minutePos = manager->GetNumeric(SkinGroup::Playing, "Minute"); // conf.GetNumeric("Minute");
-        m_minuteNum->NumberPosition = IntToPos(minutePos[0].Direction);
-        m_minuteNum->MaxDigits = minutePos[0].MaxDigit;
-        m_minuteNum->FillWithZeros = minutePos[0].FillWithZero;
-        m_minuteNum->Position = UDim2::fromOffset(minutePos[0].X, minutePos[0].Y);
-
-        m_secondNum = std::make_unique<NumericTexture>(numTimerPaths);
-        auto secondPos = manager->GetNumeric(SkinGroup::Playing, "Second"); // conf.GetNumeric("Second");
-        m_secondNum->NumberPosition = IntToPos(secondPos[0].Direction);
-        m_secondNum->MaxDigits = secondPos[0].MaxDigit;
-        m_secondNum->FillWithZeros = secondPos[0].FillWithZero;
-        m_secondNum->Position = UDim2::fromOffset(secondPos[0].X, secondPos[0].Y);
-
-        auto pillsPosition = manager->GetPosition(SkinGroup::Playing, "Pill"); // conf.GetPosition("Pill");
+        if (manager->Contains(SkinGroup::Playing, SkinDataType::Numeric, PlayingSkin::Minute)) {
+            auto minutePos = manager->GetNumeric(SkinGroup::Playing, PlayingSkin::Minute); // conf.GetNumeric("Minute");
+            if (minutePos.size() > 0) {
+                m_minuteNum = std::make_unique<NumericTexture>(numTimerPaths);
+                m_minuteNum->NumberPosition = IntToPos(minutePos[0].Direction);
+                m_minuteNum->MaxDigits = minutePos[0].MaxDigit;
+                m_minuteNum->FillWithZeros = minutePos[0].FillWithZero;
+                m_minuteNum->Position = UDim2::fromOffset(minutePos[0].X, minutePos[0].Y);
+            }
+        }
+
+        if (manager->Contains(SkinGroup::Playing, SkinDataType::Numeric, PlayingSkin::Second)) {
+            auto secondPos = manager->GetNumeric(SkinGroup::Playing, PlayingSkin::Second); // conf.GetNumeric("Second");
+            if (secondPos.size() > 0) {
+                m_secondNum = std::make_unique<NumericTexture>(numTimerPaths);
+                m_secondNum->NumberPosition = IntToPos(secondPos[0].Direction);
+                m_secondNum->MaxDigits = secondPos[0].MaxDigit;
+                m_secondNum->FillWithZeros = secondPos[0].FillWithZero;
+                m_secondNum->Position = UDim2::fromOffset(secondPos[0].X, secondPos[0].Y);
+            }
+        }
+
+        auto pillsPosition = manager->GetPosition(SkinGroup::Playing, PlayingSkin::Pill); // conf.GetPosition("Pill");
         if (pillsPosition.size() < 5) {
             throw std::runtime_error("Playing.ini : Positions : Pill : Not enough positions! (count < 5)");
         }
@@ -793,7 +857,7 @@ bool GameplayScene::Attach()
             auto file = playingPath / ("Pill" + std::to_string(i) + ".png");
 
             auto pos = pillsPosition[i];
-            m_pills[i] = std::move(std::make_unique<Texture2D>(file));
+            m_pills[i] = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(file));
             m_pills[i]->Position = UDim2::fromOffset(pos.X, pos.Y);
             m_pills[i]->AnchorPoint = { pos.AnchorPointX, pos.AnchorPointY };
         }
@@ -27,7 +27,6 @@ public:
     void Input(double delta) override;
 
     void OnKeyDown(const KeyState &state) override;
-    void OnKeyUp(const KeyState &state) override;
     void OnMouseDown(const MouseState &state) override;
 
     bool Attach() override;
@@ -1,9 +1,12 @@
 // TODO: add welcome message and stuff
 
 #include "IntroScene.h"
+#include "../Data/Util/Util.hpp"
 #include "../Engine/SkinConfig.hpp"
+#include "../Engine/SkinManager.hpp"
 #include <MsgBox.h>
 #include <SDL2/SDL.h>
+#include <algorithm>
 #include <fstream>
 #include <thread>
 
@@ -16,6 +19,7 @@
 
 #include <Imgui/ImguiUtil.h>
 #include <Texture/MathUtils.h>
+#include <Texture/TextureCache.h>
 
 IntroScene::IntroScene()
 {
@@ -32,6 +36,23 @@ void IntroScene::OnKeyDown(const KeyState &state)
 
 bool IntroScene::Attach()
 {
+    // Skins can warm the texture cache with [Preload] Files=Playing/Playfield.png,Playing/Pill0.png,...
+    // paths are relative to the skin folder
+    auto manager = SkinManager::GetInstance();
+    auto files = manager->GetSkinProp("Preload", "Files");
+
+    if (files.size()) {
+        std::vector<std::filesystem::path> paths;
+        for (auto &file : splitString(files, ',')) {
+            file.erase(std::remove_if(file.begin(), file.end(), ::isspace), file.end());
+            if (file.size()) {
+                paths.push_back(manager->GetPath() / file);
+            }
+        }
+
+        TextureCache::GetInstance()->Preload(paths);
+    }
+
     return true;
 }
 
@@ -1,23 +1,216 @@
 #include "LoadingScene.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
 
 #include "Configuration.h"
 #include "Exception/SDLException.h"
+#include "Imgui/imgui.h"
+#include "Inputs/Keys.h"
 #include "MsgBox.h"
+#include "Rendering/Threading/JobSystem.h"
 #include "Rendering/Window.h"
 #include "SceneManager.h"
 
 #include "../Data/Chart.hpp"
 #include "../Data/osu.hpp"
+#include "../Engine/GameAudioSampleCache.hpp"
 #include "../Engine/SkinManager.hpp"
 
 #include "../EnvironmentSetup.hpp"
 #include "../GameScenes.h"
 #include "../Resources/GameDatabase.h"
 
+enum class LoadingStage {
+    Parse,
+    Samples,
+    Textures,
+    Done,
+    Failed
+};
+
+struct LoadingContext
+{
+    std::atomic<LoadingStage>          Stage = LoadingStage::Parse;
+    GameAudioSampleCache::LoadProgress Samples;
+
+    std::mutex  Lock;
+    std::string Error;
+
+    /* Inputs, captured on the update thread before the worker starts */
+    std::filesystem::path File;
+    std::filesystem::path NoImage;
+    std::string           ExpectedHash;
+    int                   DiffIndex = 0;
+    double                Rate = 1.0;
+    bool                  Pitch = false;
+    bool                  LoadBackground = true;
+
+    /* Outputs, only touched by the update thread once Stage reaches Textures */
+    Chart                                 *Song = nullptr;
+    bool                                   OwnsSong = false;
+    bool                                   Published = false;
+    std::vector<uint8_t>                   Background;
+    std::vector<std::function<void(void)>> Uploads;
+};
+
+namespace {
+    std::vector<uint8_t> ReadFile(std::filesystem::path path)
+    {
+        std::fstream fs(path, std::ios::binary | std::ios::in);
+        if (!fs.is_open()) {
+            return {};
+        }
+
+        fs.seekg(0, std::ios::end);
+        size_t size = fs.tellg();
+        fs.seekg(0, std::ios::beg);
+
+        std::vector<uint8_t> buffer(size);
+        fs.read((char *)buffer.data(), size);
+        fs.close();
+
+        return buffer;
+    }
+
+    /* Returns nullptr with an empty error when cancelled, the parsers themselves run to completion */
+    Chart *ParseChart(std::filesystem::path file, int diffIndex, const std::atomic<bool> &cancel, std::string &error)
+    {
+        const char *bmsfile[] = { ".bms", ".bme", ".bml", ".bmsc" };
+        const char *ojnfile = ".ojn";
+
+        if (file.extension() == bmsfile[0] || file.extension() == bmsfile[1] || file.extension() == bmsfile[2] || file.extension() == bmsfile[3]) {
+            BMS::BMSFile beatmap;
+            beatmap.Load(file);
+
+            if (cancel) {
+                return nullptr;
+            }
+
+            if (!beatmap.IsValid()) {
+                error = "Failed to BMS chart!";
+                return nullptr;
+            }
+
+            return new Chart(beatmap);
+        } else if (file.extension() == ojnfile) {
+            O2::OJN o2jamFile;
+            o2jamFile.Load(file);
+
+            if (cancel) {
+                return nullptr;
+            }
+
+            if (!o2jamFile.IsValid()) {
+                error = "Failed to load OJN: " + file.filename().string();
+                return nullptr;
+            }
+
+            return new Chart(o2jamFile, diffIndex);
+        } else {
+            Osu::Beatmap beatmap(file);
+
+            if (cancel) {
+                return nullptr;
+            }
+
+            if (!beatmap.IsValid()) {
+                error = "Failed to load osu beatmap!";
+                return nullptr;
+            }
+
+            return new Chart(beatmap);
+        }
+    }
+
+    void Fail(std::shared_ptr<LoadingContext> context, std::string message)
+    {
+        std::lock_guard<std::mutex> lock(context->Lock);
+        context->Error = message;
+
+        if (context->OwnsSong) {
+            delete context->Song;
+            context->Song = nullptr;
+        }
+
+        context->Stage = LoadingStage::Failed;
+    }
+
+    /* Owns its share of the context, a cancelled load is cleaned up here while the scene has already moved on */
+    void LoadWorker(std::shared_ptr<LoadingContext> context)
+    {
+        auto &cancel = context->Samples.Cancel;
+
+        if (context->Song == nullptr) {
+            std::string error;
+
+            Chart *chart = ParseChart(context->File, context->DiffIndex, cancel, error);
+            if (chart == nullptr) {
+                if (!cancel) {
+                    Fail(context, error);
+                }
+                return;
+            }
+
+            if (cancel) {
+                delete chart;
+                return;
+            }
+
+            context->Song = chart;
+            context->OwnsSong = true;
+        }
+
+        Chart *chart = context->Song;
+        if (context->ExpectedHash.size() > 0 && context->ExpectedHash != chart->MD5Hash) {
+            Fail(context, "Invalid map identifier, please refresh music list using F5 key!");
+            return;
+        }
+
+        context->Stage = LoadingStage::Samples;
+        if (!cancel) {
+            GameAudioSampleCache::SetRate(context->Rate);
+            GameAudioSampleCache::Load(chart, context->Pitch, &context->Samples);
+        }
+
+        // Only encoded image bytes are read here, the texture itself must be created on the render thread
+        if (context->LoadBackground && !cancel) {
+            std::filesystem::path dirPath = chart->m_beatmapDirectory;
+            dirPath /= chart->m_backgroundFile;
+
+            if (chart->m_backgroundFile.size() > 0 && std::filesystem::exists(dirPath)) {
+                context->Background = ReadFile(dirPath);
+            }
+
+            if (context->Background.empty() && chart->m_backgroundBuffer.size() > 0) {
+                context->Background.assign(chart->m_backgroundBuffer.begin(), chart->m_backgroundBuffer.end());
+            }
+
+            if (context->Background.empty() && std::filesystem::exists(context->NoImage)) {
+                context->Background = ReadFile(context->NoImage);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(context->Lock);
+        if (cancel) {
+            if (context->OwnsSong) {
+                delete context->Song;
+                context->Song = nullptr;
+            }
+            return;
+        }
+
+        context->Stage = LoadingStage::Textures;
+    }
+} // namespace
+
 LoadingScene::LoadingScene()
 {
     m_background = nullptr;
@@ -28,127 +221,160 @@ LoadingScene::~LoadingScene()
 {
 }
 
-void LoadingScene::Update(double delta)
+void LoadingScene::Start()
 {
-    SkinManager::GetInstance()->ReloadSkin();
+    auto context = std::make_shared<LoadingContext>();
 
-    if (is_ready || fucked)
-        m_counter += delta;
-    int  songId = EnvironmentSetup::GetInt("Key");
-    int  diffIndex = EnvironmentSetup::GetInt("Difficulty");
-    bool IsO2Jam = false;
-    bool IsFile = false;
+    int songId = EnvironmentSetup::GetInt("Key");
+    int diffIndex = EnvironmentSetup::GetInt("Difficulty");
 
     Chart *chart = (Chart *)EnvironmentSetup::GetObj("SONG");
-    if (chart == nullptr || chart->GetO2JamId() != songId) {
-        if (!fucked) {
-            std::filesystem::path file;
+    if (chart != nullptr && chart->GetO2JamId() == songId) {
+        context->Song = chart;
+    } else if (songId != -1) {
+        context->File = GameDatabase::GetInstance()->GetPath();
+        context->File /= "o2ma" + std::to_string(songId) + ".ojn";
+    } else {
+        context->File = EnvironmentSetup::GetPath("FILE");
 
-            if (songId != -1) {
-                file = GameDatabase::GetInstance()->GetPath();
-                file /= "o2ma" + std::to_string(songId) + ".ojn";
-            } else {
-                file = EnvironmentSetup::GetPath("FILE");
-                IsFile = true;
+        auto autoplay = EnvironmentSetup::GetInt("ParameterAutoplay");
+        auto rate = EnvironmentSetup::Get("ParameterRate");
 
-                auto autoplay = EnvironmentSetup::GetInt("ParameterAutoplay");
-                auto rate = EnvironmentSetup::Get("ParameterRate");
+        EnvironmentSetup::SetInt("Autoplay", autoplay);
+        EnvironmentSetup::Set("SongRate", rate);
+    }
 
-                EnvironmentSetup::SetInt("Autoplay", autoplay);
-                EnvironmentSetup::Set("SongRate", rate);
-            }
+    if (songId != -1) {
+        auto item = GameDatabase::GetInstance()->Find(songId);
+        context->ExpectedHash = item.Hash[diffIndex];
+    }
 
-            const char *bmsfile[] = { ".bms", ".bme", ".bml", ".bmsc" };
-            const char *ojnfile = ".ojn";
+    if (EnvironmentSetup::Get("SongRate").size() > 0) {
+        try {
+            context->Rate = std::clamp(std::stod(EnvironmentSetup::Get("SongRate")), 0.5, 2.0);
+        } catch (const std::invalid_argument &) {
+            context->Rate = 1.0;
+        }
+    }
 
-            if (file.extension() == bmsfile[0] || file.extension() == bmsfile[1] || file.extension() == bmsfile[2] || file.extension() == bmsfile[3]) {
-                BMS::BMSFile beatmap;
-                beatmap.Load(file);
+    context->DiffIndex = diffIndex;
+    context->Pitch = Configuration::Load("Game", "AudioPitch") == "1";
+    context->LoadBackground = m_background == nullptr;
+    context->NoImage = SkinManager::GetInstance()->GetPath() / "Playing" / "NoImage.png";
 
-                if (!beatmap.IsValid()) {
-                    MsgBox::Show("FailChart", "Error", "Failed to BMS chart!", MsgBoxType::OK);
-                    fucked = true;
-                    return;
-                }
+    m_context = context;
 
-                chart = new Chart(beatmap);
-            } else if (file.extension() == ojnfile) {
-                O2::OJN o2jamFile;
-                o2jamFile.Load(file);
+    JobSystem::GetInstance()->Schedule([context] {
+        LoadWorker(context);
+    },
+                                       nullptr,
+                                       JobAffinity::LONG_RUNNING);
+}
 
-                if (!o2jamFile.IsValid()) {
-                    std::string msg = "Failed to load OJN: " + ("o2ma" + std::to_string(songId) + ".ojn");
+void LoadingScene::Cancel()
+{
+    if (!m_context) {
+        return;
+    }
 
-                    MsgBox::Show("FailChart", "Error", msg.c_str(), MsgBoxType::OK);
-                    fucked = true;
-                    return;
-                }
+    // Never waits on the worker, it frees the chart itself once it sees the flag; the next sample cache load queues behind it
+    m_context->Samples.Cancel = true;
 
-                chart = new Chart(o2jamFile, diffIndex);
+    {
+        std::lock_guard<std::mutex> lock(m_context->Lock);
 
-                IsO2Jam = true;
-            } else {
-                Osu::Beatmap beatmap(file);
+        // Worker already handed the chart over and returned, but it was never published
+        if (m_context->Stage == LoadingStage::Textures && m_context->OwnsSong) {
+            delete m_context->Song;
+            m_context->Song = nullptr;
+        }
+    }
 
-                if (!beatmap.IsValid()) {
-                    MsgBox::Show("FailChart", "Error", "Failed to load osu beatmap!", MsgBoxType::OK);
-                    fucked = true;
-                    return;
-                }
+    m_context.reset();
+}
 
-                chart = new Chart(beatmap);
-            }
+void LoadingScene::UploadTextures(double budget)
+{
+    auto start = std::chrono::steady_clock::now();
 
-            EnvironmentSetup::SetObj("SONG", chart);
+    auto &uploads = m_context->Uploads;
+    while (uploads.size() > 0) {
+        auto upload = std::move(uploads.front());
+        uploads.erase(uploads.begin());
+
+        upload();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= budget) {
+            break;
         }
-    } else {
-        IsO2Jam = chart->GetO2JamId() == songId; // TODO: refactor this
     }
+}
 
-    std::filesystem::path dirPath = chart->m_beatmapDirectory;
-    dirPath /= chart->m_backgroundFile;
-
-    if (IsO2Jam && !IsFile) {
-        auto item = GameDatabase::GetInstance()->Find(songId);
+void LoadingScene::Update(double delta)
+{
+    if (is_ready || fucked)
+        m_counter += delta;
 
-        bool hashFound = strcmp(item.Hash[diffIndex], chart->MD5Hash.c_str()) == 0;
-        if (!hashFound) {
-            MsgBox::Show("FailChart", "Error", "Invalid map identifier, please refresh music list using F5 key!", MsgBoxType::OK);
-            fucked = true;
-        }
+    if (!m_context) {
+        return;
     }
 
-    if (!fucked) {
-        try {
-            if (m_background == nullptr) {
-                GameWindow *window = GameWindow::GetInstance();
-                if (chart->m_backgroundFile.size() > 0 && std::filesystem::exists(dirPath)) {
-                    m_background = new Texture2D(dirPath.string());
-                    m_background->Size = UDim2::fromOffset(window->GetBufferWidth(), window->GetBufferHeight());
+    switch (m_context->Stage) {
+        case LoadingStage::Failed:
+        {
+            if (!fucked) {
+                std::string error;
+                {
+                    std::lock_guard<std::mutex> lock(m_context->Lock);
+                    error = m_context->Error;
                 }
 
-                if (chart->m_backgroundBuffer.size() > 0 && m_background == nullptr) {
-                    m_background = new Texture2D((uint8_t *)chart->m_backgroundBuffer.data(), chart->m_backgroundBuffer.size());
-                    m_background->Size = UDim2::fromOffset(window->GetBufferWidth(), window->GetBufferHeight());
+                MsgBox::Show("FailChart", "Error", error.c_str(), MsgBoxType::OK);
+                fucked = true;
+                m_counter = 0;
+            }
+            break;
+        }
+
+        case LoadingStage::Textures:
+        {
+            if (!m_context->Published) {
+                EnvironmentSetup::SetObj("SONG", m_context->Song);
+                m_context->OwnsSong = false;
+                m_context->Published = true;
+
+                if (m_context->Background.size() > 0) {
+                    m_context->Uploads.push_back([this] {
+                        try {
+                            GameWindow *window = GameWindow::GetInstance();
+
+                            m_background = new Texture2D(m_context->Background.data(), m_context->Background.size());
+                            m_background->Size = UDim2::fromOffset(window->GetBufferWidth(), window->GetBufferHeight());
+                        } catch (SDLException &e) {
+                            MsgBox::Show("FailChart", "Error", "Failed to create texture: " + std::string(e.what()));
+                            fucked = true;
+                        }
+
+                        m_context->Background.clear();
+                    });
                 }
+            }
 
-                if (m_background == nullptr) {
-                    auto skinPath = SkinManager::GetInstance()->GetPath();
-                    auto noImage = skinPath / "Playing" / "NoImage.png";
+            // Keep texture creation within a slice of the frame so the loading screen does not stall
+            UploadTextures(0.004);
 
-                    if (std::filesystem::exists(noImage)) {
-                        m_background = new Texture2D(noImage);
-                        m_background->Size = UDim2::fromOffset(window->GetBufferWidth(), window->GetBufferHeight());
-                    }
-                }
+            if (m_context->Uploads.empty()) {
+                m_context->Stage = LoadingStage::Done;
             }
-        } catch (SDLException &e) {
-            MsgBox::Show("FailChart", "Error", "Failed to create texture: " + std::string(e.what()));
-            fucked = true;
+            break;
         }
+
+        default:
+            break;
     }
 
-    if (m_counter > 2.5 && chart != nullptr) {
+    if (m_context->Stage == LoadingStage::Done && m_counter > 2.5) {
         SceneManager::ChangeScene(GameScene::GAMEPLAY);
     } else {
         if (fucked) {
@@ -171,12 +397,66 @@ void LoadingScene::Render(double delta)
     if (m_background && is_ready) {
         m_background->Draw();
     }
+
+    if (!m_context || fucked) {
+        return;
+    }
+
+    float progress = 0.0f;
+    switch (m_context->Stage) {
+        case LoadingStage::Parse:
+            progress = 0.1f;
+            break;
+
+        case LoadingStage::Samples:
+        {
+            int total = m_context->Samples.Total;
+            int loaded = m_context->Samples.Loaded;
+
+            progress = 0.1f + (total > 0 ? 0.8f * loaded / total : 0.0f);
+            break;
+        }
+
+        case LoadingStage::Textures:
+            progress = 0.9f;
+            break;
+
+        default:
+            progress = 1.0f;
+            break;
+    }
+
+    auto displaySize = ImGui::GetIO().DisplaySize;
+    auto draw_list = ImGui::GetForegroundDrawList();
+
+    ImVec2 start = ImVec2(0, displaySize.y - 4.0f);
+    ImVec2 end = ImVec2(displaySize.x * progress, displaySize.y);
+
+    draw_list->AddRectFilled(start, end, IM_COL32(255, 255, 255, 200));
+}
+
+void LoadingScene::OnKeyDown(const KeyState &state)
+{
+    if (state.key != Keys::EscapeK || fucked || !m_context || m_context->Stage == LoadingStage::Done) {
+        return;
+    }
+
+    Cancel();
+
+    if (EnvironmentSetup::GetInt("Key") != -1) {
+        SceneManager::ChangeScene(GameScene::SONGSELECT);
+    } else {
+        SceneManager::GetInstance()->StopGame();
+    }
 }
 
 bool LoadingScene::Attach()
 {
     SceneManager::DisplayFade(0, [] {});
 
+    // Skin only needs to be reloaded once per load, not every frame
+    SkinManager::GetInstance()->ReloadSkin();
+
     fucked = false;
     is_shown = false;
     is_ready = true;
@@ -184,11 +464,15 @@ bool LoadingScene::Attach()
 
     m_background = (Texture2D *)EnvironmentSetup::GetObj("SongBackground");
     dont_dispose = m_background != nullptr;
+
+    Start();
     return true;
 }
 
 bool LoadingScene::Detach()
 {
+    Cancel();
+
     if (m_background && !dont_dispose) {
         delete m_background;
         m_background = nullptr;
@@ -2,6 +2,9 @@
 #include "Scene.h"
 #include "Texture/Texture2D.h"
 #include <iostream>
+#include <memory>
+
+struct LoadingContext;
 
 class LoadingScene : public Scene
 {
@@ -12,10 +15,16 @@ public:
     void Update(double delta) override;
     void Render(double delta) override;
 
+    void OnKeyDown(const KeyState &state) override;
+
     bool Attach() override;
     bool Detach() override;
 
 private:
+    void Start();
+    void Cancel();
+    void UploadTextures(double budget);
+
     // can't load chart lmao
     bool fucked = false;
     bool is_shown = false;
@@ -26,4 +35,7 @@ private:
 
     double     m_counter;
     Texture2D *m_background;
-};
\ No newline at end of file
+
+    // Shared with the worker thread, which keeps it alive after Cancel lets go of it
+    std::shared_ptr<LoadingContext> m_context;
+};
@@ -8,6 +8,7 @@
 #include "Imgui/imgui.h"
 #include "Rendering/Window.h"
 #include "Texture/MathUtils.h"
+#include "Texture/TextureCache.h"
 #include <Audio/AudioManager.h>
 #include <MsgBox.h>
 #include <SceneManager.h>
@@ -157,7 +158,7 @@ bool MainMenu::Attach()
     auto bgm_path = path / "Audio" / "BGM.ogg";
 
     if (std::filesystem::exists(background_path)) {
-        m_background = std::make_unique<Texture2D>(background_path);
+        m_background = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(background_path));
         m_background->Size = UDim2::fromOffset(window->GetBufferWidth(), window->GetBufferHeight());
     }
 
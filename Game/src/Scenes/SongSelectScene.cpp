@@ -9,6 +9,7 @@
 #include "Rendering/Window.h"
 #include "SceneManager.h"
 #include "Texture/MathUtils.h"
+#include "Texture/TextureCache.h"
 
 #include "Imgui/ImguiUtil.h"
 #include "Imgui/imgui.h"
@@ -805,7 +806,7 @@ bool SongSelectScene::Attach()
     if (std::filesystem::exists(bgPath) && !m_background) {
         GameWindow *wnd = GameWindow::GetInstance();
 
-        m_background = std::make_unique<Texture2D>(bgPath);
+        m_background = std::unique_ptr<Texture2D>(TextureCache::GetInstance()->Load(bgPath));
         m_background->Size = UDim2::fromOffset(wnd->GetBufferWidth(), wnd->GetBufferHeight());
     }
 
@@ -5,20 +5,26 @@
 #include <algorithm>
 #include <filesystem>
 #include <iostream>
+#include <stdio.h>
 
 #if __linux__
 #include <unistd.h>
 #endif
 
 // Game Headers
+#include "./Data/ParseBenchmark.hpp"
 #include "./Data/Util/Util.hpp"
+#include "./Engine/SkinManager.hpp"
 #include "./Resources/DefaultConfiguration.h"
+#include "./Scenes/Converters/ToOsu.hpp"
 #include "EnvironmentSetup.hpp"
 #include "MyGame.h"
 
 // Engine Headers
 #include "Configuration.h"
+#include "Logs.h"
 #include "MsgBox.h"
+#include "Rendering/Threading/JobSystem.h"
 
 #if _WIN32
 extern "C" {
@@ -69,6 +75,69 @@ int Run(int argc, wchar_t **argv)
                 }
             }
 
+            // --benchmark-scene [chart], plays the chart with autoplay on the headless renderer and prints frame time percentiles
+            if (arg == L"--benchmark-scene") {
+                if (i + 1 < argc) {
+                    EnvironmentSetup::SetInt("Benchmark", 1);
+                    EnvironmentSetup::SetInt("ParameterAutoplay", 1);
+                    EnvironmentSetup::SetPath("FILE", argv[i + 1]);
+                    i++;
+                }
+
+                continue;
+            }
+
+            // --frame-dump [file], writes a hash of every benchmark frame for comparing runs
+            if (arg == L"--frame-dump") {
+                if (i + 1 < argc) {
+                    EnvironmentSetup::SetPath("FrameDump", argv[i + 1]);
+                    i++;
+                }
+
+                continue;
+            }
+
+            // --pack-skin [name], bakes Skins/[name] into Skins/[name]/Skin.pack and exits
+            if (arg == L"--pack-skin") {
+                if (i + 1 < argc) {
+                    std::filesystem::path name = argv[i + 1];
+
+                    // Runs before Game::Init, start the workers here so images are decoded in parallel
+                    JobSystem::GetInstance()->Init();
+                    bool result = SkinManager::BuildPack(name.string());
+                    JobSystem::Release();
+
+                    return result ? 0 : -1;
+                }
+
+                continue;
+            }
+
+            // --benchmark-parse [directory], measures chart parser throughput over every .osu/.bms file in it and exits
+            if (arg == L"--benchmark-parse") {
+                if (i + 1 < argc) {
+                    std::filesystem::path directory = argv[i + 1];
+                    return ParseBenchmark::Run(directory) ? 0 : -1;
+                }
+
+                continue;
+            }
+
+            // --convert-osu [directory] [output], converts every .ojn under the directory to osu!mania on all cores and exits
+            if (arg == L"--convert-osu") {
+                if (i + 1 < argc) {
+                    std::filesystem::path directory = argv[i + 1];
+                    std::filesystem::path output = std::filesystem::current_path() / "Converted";
+                    if (i + 2 < argc && argv[i + 2][0] != L'-') {
+                        output = argv[i + 2];
+                    }
+
+                    return Converters::ConvertLibrary(directory, output) == 0 ? 0 : -1;
+                }
+
+                continue;
+            }
+
             if (std::filesystem::exists(argv[i]) && EnvironmentSetup::GetPath("FILE").empty()) {
                 std::filesystem::path path = argv[i];
 
@@ -91,6 +160,11 @@ int Run(int argc, wchar_t **argv)
 #if _WIN32
 int HandleStructualException(int code)
 {
+    // Not Logs::Flush, the writer thread may be the one that faulted or hold the sink
+    char message[64];
+    snprintf(message, sizeof(message), "[Game] Uncaught exception: 0x%08X", static_cast<unsigned int>(code));
+    Logs::WriteFatal(message);
+
     MessageBoxA(NULL, ("Uncaught exception: " + std::to_string(code)).c_str(), "FATAL ERROR", MB_ICONERROR);
     return EXCEPTION_EXECUTE_HANDLER;
 }
@@ -160,6 +234,8 @@ int main(int argc, char *argv[])
     ret = Run(argc, wargv);
 #endif
 
+    Logs::Shutdown();
+
     for (int i = 0; i < argc; i++) {
         delete[] wargv[i];
     }